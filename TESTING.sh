@@ -15,3 +15,69 @@ sleep 2;
 rm TEST.test; make; sleep 1; clear; ./tips_parse unit_tests/while_sample.pas >> TEST.test ; diff TEST.test unit_tests/while_sample.correct;
 sleep 2;
 rm TEST.test; make; sleep 1; clear; ./tips_parse unit_tests/not_sample.pas >> TEST.test ; diff TEST.test unit_tests/not_sample.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --all-errors unit_tests/error3.pas >> TEST.test ; diff TEST.test unit_tests/error3.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --stream unit_tests/input1.pas >> TEST.test ; diff TEST.test unit_tests/input1_stream.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --emit-ast=TEST.tast unit_tests/input2.pas > /dev/null; ./tips_parse --read-ast=TEST.tast >> TEST.test ; diff TEST.test unit_tests/input2_ast.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; rm -rf TEST.cache; ./tips_parse --batch --cache-dir=TEST.cache unit_tests/input1.pas unit_tests/error.pas > /dev/null; ./tips_parse --batch --cache-dir=TEST.cache unit_tests/input1.pas unit_tests/error.pas >> TEST.test ; diff TEST.test unit_tests/batch_cached.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --run unit_tests/sample.pas < unit_tests/sample.in >> TEST.test ; diff TEST.test unit_tests/sample_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/input1.pas < unit_tests/input1.in >> TEST.test ; diff TEST.test unit_tests/input1_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/while_sample.pas >> TEST.test ; diff TEST.test unit_tests/while_sample_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --run unit_tests/types.pas < unit_tests/types.in >> TEST.test ; diff TEST.test unit_tests/types_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --run --all-errors unit_tests/type_error.pas >> TEST.test ; diff TEST.test unit_tests/type_error.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/fold.pas < unit_tests/fold.in >> TEST.test ; diff TEST.test unit_tests/fold_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/fold.pas >> TEST.test ; diff TEST.test unit_tests/fold_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/ir.pas < unit_tests/ir.in >> TEST.test ; diff TEST.test unit_tests/ir_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/ir.pas >> TEST.test ; diff TEST.test unit_tests/ir_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/licm.pas < unit_tests/licm.in >> TEST.test ; diff TEST.test unit_tests/licm_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/licm.pas >> TEST.test ; diff TEST.test unit_tests/licm_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --run --engine=jit unit_tests/jit.pas < unit_tests/jit.in >> TEST.test ; diff TEST.test unit_tests/jit_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; bash unit_tests/emit.sh c >> TEST.test ; diff TEST.test unit_tests/emit_c.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; bash unit_tests/emit.sh asm >> TEST.test ; diff TEST.test unit_tests/emit_asm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --records=unit_tests/records.csv unit_tests/records.pas >> TEST.test ; diff TEST.test unit_tests/records_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --threads=4 --records=unit_tests/records.csv unit_tests/records.pas >> TEST.test ; diff TEST.test unit_tests/records_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --emit-code=TEST.tcode unit_tests/jit.pas; ./tips_parse --run-code=TEST.tcode --engine=jit < unit_tests/jit.in >> TEST.test ; diff TEST.test unit_tests/jit_run.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; rm -f TEST.profile; ./tips_parse --run --profile=TEST.profile unit_tests/licm.pas < unit_tests/licm.in > /dev/null; ./tips_parse --gen-super=TEST.profile >> TEST.test ; diff TEST.test unit_tests/super_gen.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; for e in tree vm jit; do ./tips_parse --run --engine=$e --max-steps=10 unit_tests/limits.pas >> TEST.test ; done; ./tips_parse --run --engine=closure --max-output=24 unit_tests/limits.pas >> TEST.test ; diff TEST.test unit_tests/limits.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse unit_tests/for.pas >> TEST.test ; diff TEST.test unit_tests/for.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/for.pas < unit_tests/for.in >> TEST.test ; diff TEST.test unit_tests/for_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/for.pas >> TEST.test ; ./tips_parse --disasm --no-opt unit_tests/for.pas >> TEST.test ; diff TEST.test unit_tests/for_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse unit_tests/break.pas >> TEST.test ; diff TEST.test unit_tests/break.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --check unit_tests/break.pas < unit_tests/break.in >> TEST.test ; diff TEST.test unit_tests/break_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --disasm unit_tests/break.pas >> TEST.test ; ./tips_parse --disasm --no-opt unit_tests/break.pas >> TEST.test ; diff TEST.test unit_tests/break_disasm.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --all-errors unit_tests/break_error.pas >> TEST.test ; diff TEST.test unit_tests/break_error.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --hash-cons unit_tests/hashcons.pas >> TEST.test ; diff TEST.test unit_tests/hashcons.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --hash-cons --check unit_tests/hashcons.pas < unit_tests/hashcons.in >> TEST.test ; diff TEST.test unit_tests/hashcons_check.correct;
+sleep 2;
+rm TEST.test; make; sleep 1; clear; ./tips_parse --diff=unit_tests/diff_old.pas unit_tests/diff_new.pas >> TEST.test ; ./tips_parse --diff=unit_tests/diff_old.pas unit_tests/diff_old.pas >> TEST.test ; diff TEST.test unit_tests/diff.correct;
@@ -0,0 +1,638 @@
+//*****************************************************************************
+// x86-64 assembly for a program (tips_parse --emit-asm)
+//
+// Writes GNU as source for Linux that needs nothing but libc:
+//     tips_parse --emit-asm prog.pas > prog.s && gcc -o prog prog.s
+// The program is translated from its bytecode, so the optimizer's work
+// carries over, and it behaves like tips_parse --run: WRITE goes through
+// printf and puts, READ through scanf and the same strtoll / strtod checks
+// as Runtime::read, and runtime errors print the same message.
+//
+// The bytecode registers that are not constants get a lifetime interval
+// from a liveness analysis over the basic blocks, and a linear scan
+// (Poletto and Sarkar) places them in machine registers. Intervals that
+// span a call to the C library take the callee-saved rbx and r12-r15,
+// the others prefer r8-r11. When none is free the interval that ends last
+// is spilled to the stack frame. A register may hold INTEGER and REAL
+// values at different times, so REAL values live in general purpose
+// registers too and pass through xmm0 / xmm1 to be computed on.
+//*****************************************************************************
+#ifndef ASM_EMITTER_H
+#define ASM_EMITTER_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "c_emitter.h"
+
+using namespace std;
+
+// Support routines at the end of every file
+const char* const asmRuntime = R"(
+# READ: the next whitespace separated token, checked like Runtime::read
+tips_token:
+    pushq %rbx
+    subq $16, %rsp
+    leaq .Lfmt_token(%rip), %rdi
+    movq %rsp, %rsi
+    xorl %eax, %eax
+    call scanf@PLT
+    cmpl $1, %eax
+    jne 1f
+    movq (%rsp), %rax
+    addq $16, %rsp
+    popq %rbx
+    ret
+1:  leaq .Lmsg_eof(%rip), %rdi
+    call tips_error
+
+tips_read_integer:
+    pushq %rbx
+    subq $16, %rsp
+    call tips_token
+    movq %rax, %rbx
+    movq %rax, %rdi
+    leaq .Lreal_chars(%rip), %rsi
+    call strpbrk@PLT
+    testq %rax, %rax
+    jne 1f
+    movq %rbx, %rdi
+    movq %rsp, %rsi
+    movl $10, %edx
+    call strtoll@PLT
+    movq (%rsp), %rcx
+    cmpb $0, (%rcx)
+    jne 2f
+    movq %rax, 8(%rsp)
+    movq %rbx, %rdi
+    call free@PLT
+    movq 8(%rsp), %rax
+    addq $16, %rsp
+    popq %rbx
+    ret
+1:  movq %rbx, %rdi
+    movq %rsp, %rsi
+    call strtod@PLT
+    movq (%rsp), %rcx
+    cmpb $0, (%rcx)
+    jne 2f
+    leaq .Lmsg_integer(%rip), %rdi
+    call tips_error
+2:  leaq .Lmsg_number(%rip), %rdi
+    call tips_error
+
+tips_read_real:
+    pushq %rbx
+    subq $16, %rsp
+    call tips_token
+    movq %rax, %rbx
+    movq %rax, %rdi
+    leaq .Lreal_chars(%rip), %rsi
+    call strpbrk@PLT
+    testq %rax, %rax
+    jne 1f
+    movq %rbx, %rdi
+    movq %rsp, %rsi
+    movl $10, %edx
+    call strtoll@PLT
+    cvtsi2sdq %rax, %xmm0
+    jmp 2f
+1:  movq %rbx, %rdi
+    movq %rsp, %rsi
+    call strtod@PLT
+2:  movq (%rsp), %rcx
+    cmpb $0, (%rcx)
+    jne 3f
+    movsd %xmm0, 8(%rsp)
+    movq %rbx, %rdi
+    call free@PLT
+    movsd 8(%rsp), %xmm0
+    addq $16, %rsp
+    popq %rbx
+    ret
+3:  leaq .Lmsg_number(%rip), %rdi
+    call tips_error
+
+# Prints the message in rdi and exits
+tips_error:
+    pushq %rbp
+    movq %rdi, %rsi
+    leaq .Lfmt_error(%rip), %rdi
+    xorl %eax, %eax
+    call printf@PLT
+    movl $1, %edi
+    call exit@PLT
+
+    .section .rodata
+.Lfmt_integer:  .string "%ld\n"
+.Lfmt_real:     .string "%g\n"
+.Lfmt_token:    .string "%ms"
+.Lfmt_error:    .string "***RUNTIME ERROR: %s\n"
+.Lreal_chars:   .string ".eE"
+.Lmsg_eof:      .string "READ past the end of the input"
+.Lmsg_integer:  .string "READ expects an INTEGER"
+.Lmsg_number:   .string "READ expects a number"
+.Lmsg_divzero:  .string "division by zero"
+)";
+
+const char* const calleeSaved[] = {"%rbx", "%r12", "%r13", "%r14", "%r15"};
+const char* const callerSaved[] = {"%r8", "%r9", "%r10", "%r11"};
+
+bool isCalleeSaved(const string& reg) {
+    return find(begin(calleeSaved), end(calleeSaved), reg) != end(calleeSaved);
+}
+
+class AsmEmitter {
+public:
+    struct Interval {
+        uint32_t reg, start, end;
+    };
+
+    const Chunk& chunk;
+    ostream& os;
+    vector<string> location;   // of each register, "" when it is never used
+    vector<uint32_t> callPcs;  // instructions that call into the C library
+    vector<vector<uint64_t>> liveIn;  // per basic block, bit per register
+    vector<uint32_t> blockStart;
+    vector<bool> isTarget;
+    int machineRegisters = 0;  // registers holding at least one interval
+    int spillSlots = 0;
+
+    AsmEmitter(const Chunk& c, ostream& output) : chunk(c), os(output) {}
+
+    void emit(const string& programName);
+
+    bool isConst(uint32_t r) const { return r >= chunk.firstConst() && r < chunk.firstTemp(); }
+    void uses(const Instr& in, vector<uint32_t>& regs) const;
+    int defines(const Instr& in) const;
+    vector<Interval> buildIntervals();
+    void allocate(vector<Interval> intervals);
+
+    bool inRegister(uint32_t r) const { return !isConst(r) && location[r][0] == '%'; }
+    bool smallConst(uint32_t r) const;
+    string source(uint32_t r) const;  // immediate, register or memory
+    string memory(uint32_t r) const;  // register or memory
+    void instruction(uint32_t pc);
+    void line(const string& text) { os << "    " << text << "\n"; }
+};
+
+void AsmEmitter::uses(const Instr& in, vector<uint32_t>& regs) const {
+    const OpcodeInfo& info = opcodeInfo[in.op];
+    regs.clear();
+    // FORUP and FORDN step the register they write
+    bool steps = in.op == OP_FORUP || in.op == OP_FORDN;
+    if (info.a == OPND_R && (defines(in) < 0 || steps)) regs.push_back(in.a);
+    if (info.b == OPND_R) regs.push_back(in.b);
+    if (info.c == OPND_R) regs.push_back(in.c);
+}
+
+// The register an instruction writes, -1 for none
+int AsmEmitter::defines(const Instr& in) const {
+    switch (in.op) {
+    case OP_JMPF: case OP_JMPT: case OP_WRITEI: case OP_WRITEF:
+        return -1;
+    default:
+        return opcodeInfo[in.op].a == OPND_R ? (int)in.a : -1;
+    }
+}
+
+// One interval per register, from the first to the last instruction where
+// it is live or written. Liveness is solved on the basic blocks; a
+// register live into or out of a block covers that block's boundary.
+vector<AsmEmitter::Interval> AsmEmitter::buildIntervals() {
+    size_t n = chunk.code.size();
+    isTarget.assign(n + 1, false);
+    vector<bool> leader(n + 1, false);
+    leader[0] = true;
+    for (size_t pc = 0; pc < n; ++pc) {
+        const Instr& in = chunk.code[pc];
+        if (opcodeInfo[in.op].b == OPND_J) {
+            isTarget[in.b] = leader[in.b] = true;
+            leader[pc + 1] = true;
+        }
+        if (in.op == OP_HALT) leader[pc + 1] = true;
+    }
+    vector<int> blockOf(n + 1);
+    for (size_t pc = 0; pc < n; ++pc) {
+        if (leader[pc]) blockStart.push_back(pc);
+        blockOf[pc] = blockStart.size() - 1;
+    }
+    size_t blocks = blockStart.size();
+    blockStart.push_back(n);
+    blockOf[n] = -1;
+
+    size_t words = (chunk.numRegs + 63) / 64;
+    auto setBit = [](vector<uint64_t>& bits, uint32_t r) { bits[r / 64] |= (uint64_t)1 << (r % 64); };
+    auto testBit = [](const vector<uint64_t>& bits, uint32_t r) { return bits[r / 64] >> (r % 64) & 1; };
+
+    vector<vector<uint64_t>> use(blocks, vector<uint64_t>(words)), def(blocks, vector<uint64_t>(words));
+    vector<vector<int>> succs(blocks);
+    vector<uint32_t> regs;
+    for (size_t b = 0; b < blocks; ++b) {
+        for (uint32_t pc = blockStart[b]; pc < blockStart[b + 1]; ++pc) {
+            const Instr& in = chunk.code[pc];
+            uses(in, regs);
+            for (uint32_t r : regs)
+                if (!isConst(r) && !testBit(def[b], r)) setBit(use[b], r);
+            int d = defines(in);
+            if (d >= 0) setBit(def[b], d);
+        }
+        const Instr& last = chunk.code[blockStart[b + 1] - 1];
+        if (opcodeInfo[last.op].b == OPND_J) succs[b].push_back(blockOf[last.b]);
+        if (last.op != OP_JMP && last.op != OP_HALT && blockOf[blockStart[b + 1]] >= 0)
+            succs[b].push_back(blockOf[blockStart[b + 1]]);
+    }
+
+    liveIn.assign(blocks, vector<uint64_t>(words));
+    vector<vector<uint64_t>> liveOut(blocks, vector<uint64_t>(words));
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t b = blocks; b-- > 0; ) {
+            for (int s : succs[b])
+                for (size_t w = 0; w < words; ++w)
+                    liveOut[b][w] |= liveIn[s][w];
+            for (size_t w = 0; w < words; ++w) {
+                uint64_t in = use[b][w] | (liveOut[b][w] & ~def[b][w]);
+                if (in != liveIn[b][w]) {
+                    liveIn[b][w] = in;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    const uint32_t NONE = 0xFFFFFFFF;
+    vector<Interval> range(chunk.numRegs, Interval{0, NONE, 0});
+    auto cover = [&](uint32_t r, uint32_t pc) {
+        range[r].start = min(range[r].start, pc);
+        range[r].end = max(range[r].end, pc);
+    };
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t bits = liveIn[b][w]; bits; bits &= bits - 1)
+                cover(w * 64 + __builtin_ctzll(bits), blockStart[b]);
+            for (uint64_t bits = liveOut[b][w]; bits; bits &= bits - 1)
+                cover(w * 64 + __builtin_ctzll(bits), blockStart[b + 1] - 1);
+        }
+        for (uint32_t pc = blockStart[b]; pc < blockStart[b + 1]; ++pc) {
+            const Instr& in = chunk.code[pc];
+            uses(in, regs);
+            for (uint32_t r : regs)
+                if (!isConst(r)) cover(r, pc);
+            int d = defines(in);
+            if (d >= 0) cover(d, pc);
+            if (in.op == OP_READI || in.op == OP_READF || in.op == OP_WRITEI ||
+                in.op == OP_WRITEF || in.op == OP_WRITES)
+                callPcs.push_back(pc);
+        }
+    }
+
+    vector<Interval> intervals;
+    for (uint32_t r = 0; r < chunk.numRegs; ++r)
+        if (range[r].start != NONE)
+            intervals.push_back(Interval{r, range[r].start, range[r].end});
+    return intervals;
+}
+
+void AsmEmitter::allocate(vector<Interval> intervals) {
+    location.assign(chunk.numRegs, "");
+    sort(intervals.begin(), intervals.end(),
+         [](const Interval& x, const Interval& y) { return x.start < y.start; });
+
+    // a value in a caller-saved register would not survive the call
+    auto crossesCall = [&](const Interval& i) {
+        auto p = upper_bound(callPcs.begin(), callPcs.end(), i.start);
+        return p != callPcs.end() && *p < i.end;
+    };
+    auto spill = [&](uint32_t r) {
+        location[r] = to_string(-8 * (6 + spillSlots++)) + "(%rbp)";
+    };
+
+    vector<string> freeCallee(begin(calleeSaved), end(calleeSaved));
+    vector<string> freeCaller(begin(callerSaved), end(callerSaved));
+    vector<Interval> active;
+    for (const Interval& i : intervals) {
+        for (size_t k = 0; k < active.size(); ) {
+            if (active[k].end < i.start) {
+                const string& reg = location[active[k].reg];
+                (isCalleeSaved(reg) ? freeCallee : freeCaller).push_back(reg);
+                active.erase(active.begin() + k);
+            }
+            else
+                ++k;
+        }
+
+        bool needsCallee = crossesCall(i);
+        vector<string>* pool = nullptr;
+        if (!needsCallee && !freeCaller.empty()) pool = &freeCaller;
+        else if (!freeCallee.empty()) pool = &freeCallee;
+        if (pool) {
+            location[i.reg] = pool->back();
+            pool->pop_back();
+            active.push_back(i);
+            continue;
+        }
+
+        // Take the register of the active interval that ends last, if that
+        // is after this one ends and the register can hold this interval
+        int victim = -1;
+        for (size_t k = 0; k < active.size(); ++k) {
+            if ((isCalleeSaved(location[active[k].reg]) || !needsCallee) && (victim < 0 || active[k].end > active[victim].end))
+                victim = k;
+        }
+        if (victim >= 0 && active[victim].end > i.end) {
+            location[i.reg] = location[active[victim].reg];
+            spill(active[victim].reg);
+            active[victim] = i;
+        }
+        else
+            spill(i.reg);
+    }
+
+    set<string> registers;
+    for (const string& reg : location)
+        if (!reg.empty() && reg[0] == '%') registers.insert(reg);
+    machineRegisters = registers.size();
+}
+
+bool AsmEmitter::smallConst(uint32_t r) const {
+    if (!isConst(r)) return false;
+    const Value& v = chunk.constants[r - chunk.firstConst()];
+    return !v.isReal && v.i >= INT32_MIN && v.i <= INT32_MAX;
+}
+
+string AsmEmitter::source(uint32_t r) const {
+    if (smallConst(r))
+        return "$" + to_string(chunk.constants[r - chunk.firstConst()].i);
+    return memory(r);
+}
+
+string AsmEmitter::memory(uint32_t r) const {
+    if (isConst(r))
+        return ".LK" + to_string(r - chunk.firstConst()) + "(%rip)";
+    return location[r];
+}
+
+void AsmEmitter::emit(const string& programName) {
+    allocate(buildIntervals());
+    size_t frame = 8 * spillSlots;
+    if (frame % 16 == 0) frame += 8;  // 5 pushes + frame keep rsp 16-byte aligned
+
+    os << "# PROGRAM " << programName << ", translated by tips_parse --emit-asm" << "\n";
+    os << "# " << chunk.numRegs - chunk.constants.size() << " bytecode registers in "
+       << machineRegisters << " machine registers and " << spillSlots << " stack slots" << "\n";
+    os << "    .text" << "\n";
+    os << "    .globl main" << "\n";
+    os << "main:" << "\n";
+    line("pushq %rbp");
+    line("movq %rsp, %rbp");
+    line("pushq %rbx");
+    line("pushq %r12");
+    line("pushq %r13");
+    line("pushq %r14");
+    line("pushq %r15");
+    line("subq $" + to_string(frame) + ", %rsp");
+
+    // variables read before they are written are 0
+    for (uint32_t r = 0; r < chunk.numRegs; ++r) {
+        if (isConst(r) || !(liveIn[0][r / 64] >> (r % 64) & 1)) continue;
+        line("movq $0, " + location[r]);
+    }
+
+    for (uint32_t pc = 0; pc < chunk.code.size(); ++pc) {
+        if (isTarget[pc])
+            os << ".L" << pc << ":" << "\n";
+        instruction(pc);
+    }
+    os << ".Lexit:" << "\n";
+    line("xorl %eax, %eax");
+    line("leaq -40(%rbp), %rsp");
+    line("popq %r15");
+    line("popq %r14");
+    line("popq %r13");
+    line("popq %r12");
+    line("popq %rbx");
+    line("popq %rbp");
+    line("ret");
+    os << ".Ldivzero:" << "\n";
+    line("leaq .Lmsg_divzero(%rip), %rdi");
+    line("call tips_error");
+    os << asmRuntime;
+
+    for (size_t k = 0; k < chunk.constants.size(); ++k) {
+        const Value& v = chunk.constants[k];
+        uint64_t bits;
+        memcpy(&bits, &v.i, sizeof bits);
+        os << "    .p2align 3" << "\n";
+        os << ".LK" << k << ": .quad " << (int64_t)bits << "\n";
+    }
+    for (size_t k = 0; k < chunk.strings.size(); ++k)
+        os << ".LS" << k << ": .string " << cStringLiteral(chunk.strings[k]) << "\n";
+    os << "    .section .note.GNU-stack,\"\",@progbits" << "\n";
+}
+
+void AsmEmitter::instruction(uint32_t pc) {
+    const Instr& in = chunk.code[pc];
+    uint32_t a = in.a, b = in.b, c = in.c;
+    string A = opcodeInfo[in.op].a == OPND_R ? memory(a) : "";
+    auto store = [&](const string& reg) { if (A != reg) line("movq " + reg + ", " + A); };
+    auto setcc = [&](const string& cc) {
+        line("set" + cc + " %al");
+        line("movzbl %al, %eax");
+        store("%rax");
+    };
+
+    switch (in.op) {
+    case OP_MOVE:
+        if (A == memory(b)) break;
+        if (inRegister(a) || inRegister(b) || smallConst(b)) line("movq " + source(b) + ", " + A);
+        else {
+            line("movq " + memory(b) + ", %rax");
+            store("%rax");
+        }
+        break;
+    case OP_ADDI: case OP_SUBI: case OP_MULI: {
+        string op = in.op == OP_ADDI ? "addq " : in.op == OP_SUBI ? "subq " : "imulq ";
+        if (inRegister(a) && A == memory(c) && in.op != OP_SUBI)
+            line(op + source(b) + ", " + A);
+        else if (inRegister(a) && A != memory(c)) {
+            if (A != memory(b)) line("movq " + source(b) + ", " + A);
+            line(op + source(c) + ", " + A);
+        }
+        else {
+            line("movq " + source(b) + ", %rax");
+            line(op + source(c) + ", %rax");
+            store("%rax");
+        }
+        break;
+    }
+    case OP_DIVI: case OP_MODI: {
+        // x / -1 is -x and x MOD -1 is 0 (divI in runtime.h): idivq would
+        // trap on INT64_MIN / -1
+        int64_t divisor = isConst(c) ? chunk.constants[c - chunk.firstConst()].i : 0;
+        if (isConst(c) && divisor == 0) {
+            line("jmp .Ldivzero");
+            break;
+        }
+        line("movq " + source(b) + ", %rax");
+        if (isConst(c) && divisor == -1) {
+            if (in.op == OP_DIVI) line("negq %rax");
+            else line("xorl %edx, %edx");
+        }
+        else if (isConst(c)) {
+            line("cqto");
+            line("idivq " + memory(c));
+        }
+        else {
+            line("cmpq $0, " + memory(c));
+            line("je .Ldivzero");
+            line("cmpq $-1, " + memory(c));
+            line("jne 1f");
+            if (in.op == OP_DIVI) line("negq %rax");
+            else line("xorl %edx, %edx");
+            line("jmp 2f");
+            os << "1:" << "\n";
+            line("cqto");
+            line("idivq " + memory(c));
+            os << "2:" << "\n";
+        }
+        store(in.op == OP_DIVI ? "%rax" : "%rdx");
+        break;
+    }
+    case OP_SHLI:
+        line("movq " + source(b) + ", %rax");
+        line("salq $" + to_string(c) + ", %rax");
+        store("%rax");
+        break;
+    case OP_DIVPI: case OP_MODPI:
+        // bias a negative dividend by 2^c - 1, see divPow2
+        line("movq " + source(b) + ", %rax");
+        line("movq %rax, %rdx");
+        line("sarq $63, %rdx");
+        line("shrq $" + to_string(64 - c) + ", %rdx");
+        line("addq %rax, %rdx");
+        line("sarq $" + to_string(c) + ", %rdx");
+        if (in.op == OP_MODPI) {
+            line("salq $" + to_string(c) + ", %rdx");
+            line("subq %rdx, %rax");
+            store("%rax");
+        }
+        else
+            store("%rdx");
+        break;
+    case OP_ADDF: case OP_SUBF: case OP_MULF: case OP_DIVF: {
+        string op = in.op == OP_ADDF ? "addsd" : in.op == OP_SUBF ? "subsd" : in.op == OP_MULF ? "mulsd" : "divsd";
+        line("movq " + memory(b) + ", %xmm0");
+        line("movq " + memory(c) + ", %xmm1");
+        line(op + " %xmm1, %xmm0");
+        line("movq %xmm0, " + A);
+        break;
+    }
+    case OP_EQI: case OP_NEI: case OP_LTI: case OP_GTI:
+        line("movq " + source(b) + ", %rax");
+        line("cmpq " + source(c) + ", %rax");
+        setcc(in.op == OP_EQI ? "e" : in.op == OP_NEI ? "ne" : in.op == OP_LTI ? "l" : "g");
+        break;
+    case OP_EQF: case OP_NEF:
+        // unordered (NaN) sets PF: = is false and <> true
+        line("movq " + memory(b) + ", %xmm0");
+        line("movq " + memory(c) + ", %xmm1");
+        line("ucomisd %xmm1, %xmm0");
+        line(in.op == OP_EQF ? "sete %al" : "setne %al");
+        line(in.op == OP_EQF ? "setnp %cl" : "setp %cl");
+        line(in.op == OP_EQF ? "andb %cl, %al" : "orb %cl, %al");
+        line("movzbl %al, %eax");
+        store("%rax");
+        break;
+    case OP_LTF: case OP_GTF:
+        // x < y is y above x, which is false when unordered
+        line("movq " + memory(b) + ", %xmm0");
+        line("movq " + memory(c) + ", %xmm1");
+        line(in.op == OP_LTF ? "ucomisd %xmm0, %xmm1" : "ucomisd %xmm1, %xmm0");
+        setcc("a");
+        break;
+    case OP_AND: case OP_OR:
+        line("cmpq $0, " + memory(b));
+        line("setne %al");
+        line("cmpq $0, " + memory(c));
+        line("setne %cl");
+        line(in.op == OP_AND ? "andb %cl, %al" : "orb %cl, %al");
+        line("movzbl %al, %eax");
+        store("%rax");
+        break;
+    case OP_NEGI:
+        line("movq " + source(b) + ", %rax");
+        line("negq %rax");
+        store("%rax");
+        break;
+    case OP_NEGF:
+        line("movq " + memory(b) + ", %rax");
+        line("btcq $63, %rax");
+        store("%rax");
+        break;
+    case OP_NOT:
+        line("cmpq $0, " + memory(b));
+        setcc("e");
+        break;
+    case OP_I2F:
+        line("cvtsi2sdq " + memory(b) + ", %xmm0");
+        line("movq %xmm0, " + A);
+        break;
+    case OP_JMP:
+        if (b != pc + 1) line("jmp .L" + to_string(b));
+        break;
+    case OP_JMPF: case OP_JMPT:
+        line("cmpq $0, " + memory(a));
+        line((in.op == OP_JMPF ? "je .L" : "jne .L") + to_string(b));
+        break;
+    case OP_FORUP: case OP_FORDN:
+        line("movq " + A + ", %rax");
+        line((in.op == OP_FORUP ? "addq $1, " : "subq $1, ") + A);
+        line("cmpq " + source(c) + ", %rax");
+        line((in.op == OP_FORUP ? "jl .L" : "jg .L") + to_string(b));
+        break;
+    case OP_READI:
+        line("call tips_read_integer");
+        store("%rax");
+        break;
+    case OP_READF:
+        line("call tips_read_real");
+        line("movq %xmm0, " + A);
+        break;
+    case OP_WRITEI:
+        line("leaq .Lfmt_integer(%rip), %rdi");
+        line("movq " + source(a) + ", %rsi");
+        line("xorl %eax, %eax");
+        line("call printf@PLT");
+        break;
+    case OP_WRITEF:
+        // every NaN prints as "nan", whatever its sign (Runtime::writeReal)
+        line("movq " + memory(a) + ", %xmm0");
+        line("ucomisd %xmm0, %xmm0");
+        line("jnp 1f");
+        line("movq " + memory(a) + ", %rax");
+        line("btrq $63, %rax");
+        line("movq %rax, %xmm0");
+        os << "1:" << "\n";
+        line("leaq .Lfmt_real(%rip), %rdi");
+        line("movl $1, %eax");
+        line("call printf@PLT");
+        break;
+    case OP_WRITES:
+        line("leaq .LS" + to_string(b) + "(%rip), %rdi");
+        line("call puts@PLT");
+        break;
+    case OP_HALT:
+        if (pc + 1 != chunk.code.size()) line("jmp .Lexit");
+        break;
+    default:
+        throw "instruction cannot be translated";
+    }
+}
+
+#endif /* ASM_EMITTER_H */
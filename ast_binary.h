@@ -0,0 +1,632 @@
+//*****************************************************************************
+// Binary parse tree format
+//
+// A position-independent encoding of the parse tree that can be written once
+// and then mmap'ed by any process and walked in place: every reference is a
+// byte offset from the start of the file, identifiers and other text live in
+// an interned string table, and walking the tree never allocates.
+//
+// Layout (little endian, records 8-byte aligned):
+//
+//   AstHeader                      magic, version, offsets of root/strings
+//   AstRecord ... AstRecord        nodes, children always before parents
+//   string table                   { uint32 length; char text[length]; '\0' }
+//
+// Each AstRecord is followed by `count` AstLinks { op, node }. The op is the
+// operator token for the rest entries of <expression>, <simple expression>
+// and <term>, and the branch (AST_COND / AST_THEN / AST_ELSE / AST_BODY,
+// AST_FROM / AST_LIMIT) for IF, WHILE and FOR. An expression record may be
+// linked from several parents when the tree was hash-consed (hash_cons.h).
+//*****************************************************************************
+#ifndef AST_BINARY_H
+#define AST_BINARY_H
+
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "parse_tree_nodes.h"
+#include "tree_writer.h"
+
+using namespace std;
+
+const char     AST_MAGIC[8]  = {'T', 'I', 'P', 'S', 'A', 'S', 'T', 0};
+const uint32_t AST_VERSION   = 1;
+const uint32_t AST_NO_TEXT   = 0xFFFFFFFF;
+
+// Link ops used by statements
+const uint32_t AST_COND = 0;
+const uint32_t AST_THEN = 1;
+const uint32_t AST_ELSE = 2;
+const uint32_t AST_BODY = 3;
+const uint32_t AST_FROM = 4;
+const uint32_t AST_LIMIT = 5;
+
+// AstRecord::flags
+const uint16_t AST_COMPOUNDED = 1;  // IdNode built with the compounded text
+const uint16_t AST_DOWNTO     = 2;  // ForNode counting down
+
+struct AstHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t root;         // offset of the PROGRAM_NODE record
+    uint32_t strings;      // offset of the string table
+    uint32_t stringBytes;  // size of the string table
+    uint32_t nodeCount;
+};
+
+struct AstLink {
+    uint32_t op;
+    uint32_t node;
+};
+
+struct AstRecord {
+    uint16_t kind;   // NodeKind
+    uint16_t flags;
+    uint32_t count;  // number of AstLinks following the record
+    uint32_t text;   // string table offset or AST_NO_TEXT
+    uint32_t text2;  // second string (NestedExprNode's closing text)
+    union {
+        int64_t i;   // INTLIT_NODE
+        double  f;   // FLOATLIT_NODE
+    } value;
+
+    const AstLink* links() const { return (const AstLink*)(this + 1); }
+};
+
+//*****************************************************************************
+// Writer: serializes a ProgramNode into a byte vector
+class AstWriter {
+public:
+    vector<char> nodes;      // header + records
+    vector<char> strings;    // interned string table
+    unordered_map<string, uint32_t> interned;
+    unordered_map<const void*, uint32_t> shared;  // records of hash-consed nodes
+    uint32_t nodeCount = 0;
+
+    vector<char> write(ProgramNode& pn);
+
+    uint32_t intern(const string* s);
+    uint32_t intern(const string& s);
+    uint32_t record(NodeKind kind, uint16_t flags, uint32_t text, uint32_t text2,
+                    const vector<AstLink>& links, int64_t i = 0, double f = 0);
+
+    uint32_t program(ProgramNode& pn);
+    uint32_t statement(StatementNode& sn);
+    uint32_t expression(ExprNode& en);
+    uint32_t simpleExpression(SimpleExprNode& sn);
+    uint32_t term(TermNode& tn);
+    uint32_t factor(FactorNode& fn);
+
+    template <class Node, class Write>
+    uint32_t once(Node& node, Write write);
+};
+
+uint32_t AstWriter::intern(const string* s) {
+    return s ? intern(*s) : AST_NO_TEXT;
+}
+
+uint32_t AstWriter::intern(const string& s) {
+    auto found = interned.find(s);
+    if (found != interned.end())
+        return found->second;
+
+    uint32_t offset = strings.size();
+    uint32_t length = s.size();
+    strings.insert(strings.end(), (char*)&length, (char*)&length + sizeof length);
+    strings.insert(strings.end(), s.begin(), s.end());
+    strings.push_back('\0');
+    while (strings.size() % 4) strings.push_back('\0');
+    interned[s] = offset;
+    return offset;
+}
+
+uint32_t AstWriter::record(NodeKind kind, uint16_t flags, uint32_t text, uint32_t text2,
+                           const vector<AstLink>& links, int64_t i, double f) {
+    AstRecord rec;
+    memset(&rec, 0, sizeof rec);
+    rec.kind = kind;
+    rec.flags = flags;
+    rec.count = links.size();
+    rec.text = text;
+    rec.text2 = text2;
+    if (kind == FLOATLIT_NODE) rec.value.f = f;
+    else rec.value.i = i;
+
+    uint32_t offset = nodes.size();
+    nodes.insert(nodes.end(), (char*)&rec, (char*)&rec + sizeof rec);
+    if (!links.empty())
+        nodes.insert(nodes.end(), (char*)links.data(), (char*)(links.data() + links.size()));
+    while (nodes.size() % 8) nodes.push_back('\0');
+    ++nodeCount;
+    return offset;
+}
+
+vector<char> AstWriter::write(ProgramNode& pn) {
+    nodes.assign(sizeof(AstHeader), '\0');
+    strings.clear();
+    interned.clear();
+    shared.clear();
+    nodeCount = 0;
+
+    uint32_t root = program(pn);
+
+    AstHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, AST_MAGIC, sizeof header.magic);
+    header.version = AST_VERSION;
+    header.root = root;
+    header.strings = nodes.size();
+    header.stringBytes = strings.size();
+    header.fileSize = nodes.size() + strings.size();
+    header.nodeCount = nodeCount;
+
+    vector<char> file(nodes);
+    memcpy(file.data(), &header, sizeof header);
+    file.insert(file.end(), strings.begin(), strings.end());
+    return file;
+}
+
+uint32_t AstWriter::program(ProgramNode& pn) {
+    uint32_t compound = statement(*pn.block->firstCompound);
+    uint32_t block = record(BLOCK_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, {{0, compound}});
+    return record(PROGRAM_NODE, 0, intern(pn.id), AST_NO_TEXT, {{0, block}});
+}
+
+uint32_t AstWriter::statement(StatementNode& sn) {
+    vector<AstLink> links;
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        links.push_back({0, expression(*an.expression)});
+        return record(ASSIGNMENT_NODE, 0, intern(an.id), AST_NO_TEXT, links);
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        links.push_back({0, statement(*cn.firstStatement)});
+        for (StatementNode* s : cn.restStatements)
+            links.push_back({0, statement(*s)});
+        return record(COMPOUND_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        links.push_back({AST_COND, expression(*in.expression)});
+        for (StatementNode* s : in.firstStatement)
+            links.push_back({AST_THEN, statement(*s)});
+        for (StatementNode* s : in.restStatements)
+            links.push_back({AST_ELSE, statement(*s)});
+        return record(IF_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        links.push_back({AST_COND, expression(*wn.expression)});
+        links.push_back({AST_BODY, statement(*wn.firstStatement)});
+        return record(WHILE_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        links.push_back({AST_FROM, expression(*fn.start)});
+        links.push_back({AST_LIMIT, expression(*fn.limit)});
+        links.push_back({AST_BODY, statement(*fn.firstStatement)});
+        return record(FOR_NODE, fn.down ? AST_DOWNTO : 0, intern(fn.id), AST_NO_TEXT, links);
+    }
+    case BREAK_NODE:
+    case CONTINUE_NODE:
+        return record(sn.kind, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    case READ_NODE:
+        return record(READ_NODE, 0, intern(((ReadNode&)sn).id), AST_NO_TEXT, links);
+    case WRITE_NODE:
+        return record(WRITE_NODE, 0, intern(((WriteNode&)sn).id), AST_NO_TEXT, links);
+    default:
+        throw "unknown statement node";
+    }
+}
+
+// A hash-consed subtree (hash_cons.h) is written once and linked to from
+// every parent, so the file holds the DAG
+template <class Node, class Write>
+uint32_t AstWriter::once(Node& node, Write write) {
+    if (!node.shared)
+        return write();
+    auto found = shared.find(&node);
+    if (found != shared.end())
+        return found->second;
+    uint32_t offset = write();
+    shared[&node] = offset;
+    return offset;
+}
+
+uint32_t AstWriter::expression(ExprNode& en) {
+    return once(en, [&] {
+        vector<AstLink> links;
+        links.push_back({0, simpleExpression(*en.simpleExpr)});
+        for (size_t i = 0; i < en.restExpOps.size(); ++i)
+            links.push_back({(uint32_t)en.restExpOps[i], simpleExpression(*en.restExpr[i])});
+        return record(EXPR_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    });
+}
+
+uint32_t AstWriter::simpleExpression(SimpleExprNode& sn) {
+    return once(sn, [&] {
+        vector<AstLink> links;
+        links.push_back({0, term(*sn.firstTerm)});
+        for (size_t i = 0; i < sn.restTermOps.size(); ++i)
+            links.push_back({(uint32_t)sn.restTermOps[i], term(*sn.restTerms[i])});
+        return record(SIMPLE_EXPR_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    });
+}
+
+uint32_t AstWriter::term(TermNode& tn) {
+    return once(tn, [&] {
+        vector<AstLink> links;
+        links.push_back({0, factor(*tn.firstFactor)});
+        for (size_t i = 0; i < tn.restFactorOps.size(); ++i)
+            links.push_back({(uint32_t)tn.restFactorOps[i], factor(*tn.restFactors[i])});
+        return record(TERM_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, links);
+    });
+}
+
+uint32_t AstWriter::factor(FactorNode& fn) {
+    return once(fn, [&] {
+        switch (fn.kind) {
+        case ID_NODE: {
+            IdNode& id = (IdNode&)fn;
+            return record(ID_NODE, id.compoundname ? AST_COMPOUNDED : 0, intern(id.id), AST_NO_TEXT, {});
+        }
+        case INTLIT_NODE: {
+            IntLitNode& in = (IntLitNode&)fn;
+            uint32_t text = in.compoudedFactorInt != "" ? intern(in.compoudedFactorInt) : AST_NO_TEXT;
+            return record(INTLIT_NODE, 0, text, AST_NO_TEXT, {}, in.int_literal);
+        }
+        case FLOATLIT_NODE:
+            return record(FLOATLIT_NODE, 0, AST_NO_TEXT, AST_NO_TEXT, {}, 0, ((FloatLitNode&)fn).float_literal);
+        case NESTED_EXPR_NODE: {
+            NestedExprNode& nn = (NestedExprNode&)fn;
+            uint32_t expr = expression(*nn.exprPtr);
+            return record(NESTED_EXPR_NODE, 0, intern(nn.additional), intern(nn.end), {{0, expr}});
+        }
+        default:
+            throw "unknown factor node";
+        }
+    });
+}
+
+//*****************************************************************************
+// Reader: a view over an encoded tree (usually an mmap'ed file). Nothing is
+// copied; records and strings are read where they lie.
+class AstView {
+public:
+    const char* base = nullptr;
+    size_t size = 0;
+
+    bool open(const void* data, size_t bytes);
+
+    const AstHeader& header() const { return *(const AstHeader*)base; }
+    const AstRecord& root() const { return node(header().root); }
+    const AstRecord& node(uint32_t offset) const { return *(const AstRecord*)(base + offset); }
+    const AstRecord& child(const AstRecord& rec, uint32_t i) const { return node(rec.links()[i].node); }
+    string_view text(uint32_t offset) const;
+
+private:
+    bool validText(uint32_t offset) const;
+    static bool validLinks(const AstRecord& rec, const vector<uint8_t>& kinds);
+};
+
+// Check the header, then every record in file order: it and its links lie
+// before the string table, its texts inside it, and each link points at an
+// earlier record of a kind its parent can have. Children come before their
+// parents, so there are no cycles either, and node(), child() and text()
+// can follow the offsets without further checks.
+bool AstView::open(const void* data, size_t bytes) {
+    base = (const char*)data;
+    size = bytes;
+    if (size < sizeof(AstHeader)) return false;
+    const AstHeader& h = header();
+    if (memcmp(h.magic, AST_MAGIC, sizeof h.magic) != 0 || h.version != AST_VERSION
+        || h.fileSize > size || h.strings < sizeof(AstHeader) || h.strings % 8
+        || (uint64_t)h.strings + h.stringBytes > h.fileSize)
+        return false;
+
+    // kind + 1 of the record at each 8-byte offset, 0 where none starts
+    vector<uint8_t> kinds(h.strings / 8, 0);
+    uint32_t offset = sizeof(AstHeader);
+    while (offset < h.strings) {
+        if (h.strings - offset < sizeof(AstRecord)) return false;
+        const AstRecord& rec = node(offset);
+        if (rec.count > (h.strings - offset - sizeof(AstRecord)) / sizeof(AstLink)
+            || !validText(rec.text) || !validText(rec.text2) || !validLinks(rec, kinds))
+            return false;
+        kinds[offset / 8] = rec.kind + 1;
+        offset += (sizeof(AstRecord) + rec.count * sizeof(AstLink) + 7) & ~(size_t)7;
+    }
+    return h.root % 8 == 0 && h.root < h.strings && kinds[h.root / 8] == PROGRAM_NODE + 1;
+}
+
+bool AstView::validText(uint32_t offset) const {
+    if (offset == AST_NO_TEXT) return true;
+    const AstHeader& h = header();
+    if (offset % 4 || (uint64_t)offset + sizeof(uint32_t) > h.stringBytes) return false;
+    uint32_t length;
+    memcpy(&length, base + h.strings + offset, sizeof length);
+    return (uint64_t)offset + sizeof length + length <= h.stringBytes;
+}
+
+// The links a record of each kind has, as AstWriter writes them
+bool AstView::validLinks(const AstRecord& rec, const vector<uint8_t>& kinds) {
+    auto kindOf = [&](uint32_t i) -> int {
+        uint32_t target = rec.links()[i].node;
+        return target % 8 || target / 8 >= kinds.size() ? -1 : kinds[target / 8] - 1;
+    };
+    auto isStatement = [](int kind) {
+        return (kind >= ASSIGNMENT_NODE && kind <= WRITE_NODE) || (kind >= FOR_NODE && kind <= CONTINUE_NODE);
+    };
+    auto all = [&](uint32_t from, auto ok) {
+        for (uint32_t i = from; i < rec.count; ++i)
+            if (!ok(kindOf(i))) return false;
+        return true;
+    };
+
+    switch (rec.kind) {
+    case PROGRAM_NODE:
+        return rec.count == 1 && kindOf(0) == BLOCK_NODE;
+    case BLOCK_NODE:
+        return rec.count == 1 && kindOf(0) == COMPOUND_NODE;
+    case ASSIGNMENT_NODE:
+    case NESTED_EXPR_NODE:
+        return rec.count == 1 && kindOf(0) == EXPR_NODE;
+    case COMPOUND_NODE:
+        return rec.count >= 1 && all(0, isStatement);
+    case IF_NODE:
+        return rec.count >= 1 && kindOf(0) == EXPR_NODE && all(1, isStatement);
+    case WHILE_NODE:
+        return rec.count == 2 && kindOf(0) == EXPR_NODE && isStatement(kindOf(1));
+    case FOR_NODE:
+        return rec.count == 3 && kindOf(0) == EXPR_NODE && kindOf(1) == EXPR_NODE && isStatement(kindOf(2));
+    case EXPR_NODE:
+        return rec.count >= 1 && all(0, [](int kind) { return kind == SIMPLE_EXPR_NODE; });
+    case SIMPLE_EXPR_NODE:
+        return rec.count >= 1 && all(0, [](int kind) { return kind == TERM_NODE; });
+    case TERM_NODE:
+        return rec.count >= 1 && all(0, [](int kind) { return kind >= ID_NODE && kind <= NESTED_EXPR_NODE; });
+    case ID_NODE: case INTLIT_NODE: case FLOATLIT_NODE:
+    case READ_NODE: case WRITE_NODE: case BREAK_NODE: case CONTINUE_NODE:
+        return rec.count == 0;
+    default:
+        return false;
+    }
+}
+
+string_view AstView::text(uint32_t offset) const {
+    if (offset == AST_NO_TEXT) return string_view();
+    const char* entry = base + header().strings + offset;
+    uint32_t length;
+    memcpy(&length, entry, sizeof length);
+    return string_view(entry + sizeof length, length);
+}
+
+//*****************************************************************************
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    void* data = nullptr;  // never null once open, an empty file included
+    size_t size = 0;
+
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;  // one owner per mapping
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool open(const char* path);
+    ~MappedFile();
+};
+
+bool MappedFile::open(const char* path) {
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0 && S_ISREG(st.st_mode)) {
+        // there is nothing to map, but the file is there and empty
+        static char empty[1];
+        close(fd);
+        data = empty;
+        return true;
+    }
+    size = st.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        size = 0;
+        return false;
+    }
+    return true;
+}
+
+MappedFile::~MappedFile() {
+    if (size) munmap(data, size);
+}
+
+//*****************************************************************************
+// In-order traversal straight off the binary tree, the same text TreeWriter
+// produces for the ProgramNode it was written from
+class AstTreeWriter {
+public:
+    const AstView& ast;
+    TreeWriter& w;
+
+    AstTreeWriter(const AstView& view, TreeWriter& writer) : ast(view), w(writer) {}
+
+    void text(uint32_t offset) {
+        string_view s = ast.text(offset);
+        w.out.append(s.data(), s.size());
+    }
+    void program(const AstRecord& rec);
+    void statement(const AstRecord& rec);
+    void expression(const AstRecord& rec);
+    void simpleExpression(const AstRecord& rec);
+    void term(const AstRecord& rec);
+    void factor(const AstRecord& rec);
+};
+
+void AstTreeWriter::program(const AstRecord& rec) {
+    w.out.lit("Program Name ");
+    text(rec.text);
+    w.out.lit("\n");
+    statement(ast.child(ast.child(rec, 0), 0));
+    w.out.lit("\n");
+}
+
+void AstTreeWriter::statement(const AstRecord& rec) {
+    switch (rec.kind) {
+    case ASSIGNMENT_NODE:
+        w.out.lit("Assignment ");
+        text(rec.text);
+        w.out.lit(" := ");
+        expression(ast.child(rec, 0));
+        w.out.lit("\n");
+        break;
+    case COMPOUND_NODE:
+        w.out.lit("Begin Compound Statement\n");
+        for (uint32_t i = 0; i < rec.count; ++i)
+            statement(ast.child(rec, i));
+        w.out.lit("End Compound Statement");
+        break;
+    case IF_NODE: {
+        bool hasElse = false;
+        w.out.lit("If ");
+        expression(ast.child(rec, 0));
+        w.out.lit("\n%%%%%%%% True Statement %%%%%%%%\n");
+        for (uint32_t i = 1; i < rec.count; ++i) {
+            if (rec.links()[i].op != AST_THEN) {
+                hasElse = true;
+                continue;
+            }
+            const AstRecord& s = ast.child(rec, i);
+            statement(s);
+            if (s.kind == COMPOUND_NODE) w.out.lit("\n");
+        }
+        w.out.lit("%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        if (hasElse) {
+            w.out.lit("%%%%%%%% False Statement %%%%%%%%\n");
+            for (uint32_t i = 1; i < rec.count; ++i) {
+                if (rec.links()[i].op != AST_ELSE) continue;
+                statement(ast.child(rec, i));
+                w.out.lit("\n");
+            }
+            w.out.lit("%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        }
+        break;
+    }
+    case WHILE_NODE:
+        w.out.lit("While ");
+        expression(ast.child(rec, 0));
+        w.out.lit("\n%%%%%%%% Loop Body %%%%%%%%\n");
+        statement(ast.child(rec, 1));
+        w.out.lit("\n%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        break;
+    case FOR_NODE:
+        w.out.lit("For ");
+        text(rec.text);
+        w.out.lit(" := ");
+        expression(ast.child(rec, 0));
+        if (rec.flags & AST_DOWNTO) w.out.lit(" DownTo ");
+        else w.out.lit(" To ");
+        expression(ast.child(rec, 1));
+        w.out.lit("\n%%%%%%%% Loop Body %%%%%%%%\n");
+        statement(ast.child(rec, 2));
+        w.out.lit("\n%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        break;
+    case BREAK_NODE:
+        w.out.lit("Break\n");
+        break;
+    case CONTINUE_NODE:
+        w.out.lit("Continue\n");
+        break;
+    case READ_NODE:
+        w.out.lit("Read Value ");
+        text(rec.text);
+        w.out.lit("\n");
+        break;
+    case WRITE_NODE:
+        w.out.lit("Write ");
+        text(rec.text);
+        w.out.lit("\n");
+        break;
+    default:
+        break;
+    }
+}
+
+void AstTreeWriter::expression(const AstRecord& rec) {
+    w.out.lit("expression( ");
+    simpleExpression(ast.child(rec, 0));
+    for (uint32_t i = 1; i < rec.count; ++i) {
+        w.op(rec.links()[i].op);
+        simpleExpression(ast.child(rec, i));
+    }
+    w.out.lit(")");
+}
+
+void AstTreeWriter::simpleExpression(const AstRecord& rec) {
+    w.out.lit("simple_expression( ");
+    term(ast.child(rec, 0));
+    for (uint32_t i = 1; i < rec.count; ++i) {
+        if (rec.links()[i].op == TOK_PLUS) w.out.lit("+ ");
+        else w.out.lit("- ");
+        term(ast.child(rec, i));
+    }
+    w.out.lit(") ");
+}
+
+void AstTreeWriter::term(const AstRecord& rec) {
+    w.out.lit("term( ");
+    factor(ast.child(rec, 0));
+    for (uint32_t i = 1; i < rec.count; ++i) {
+        if (rec.links()[i].op == TOK_MULTIPLY) w.out.lit("* ");
+        else if (rec.links()[i].op == TOK_MOD) w.out.lit("MOD ");
+        else w.out.lit("/ ");
+        factor(ast.child(rec, i));
+    }
+    w.out.lit(") ");
+}
+
+void AstTreeWriter::factor(const AstRecord& rec) {
+    switch (rec.kind) {
+    case ID_NODE:
+        w.out.lit("factor( ");
+        text(rec.text);
+        w.out.lit(" ) ");
+        break;
+    case INTLIT_NODE:
+        w.out.lit("factor( ");
+        if (rec.text != AST_NO_TEXT) text(rec.text);
+        else w.number((int)rec.value.i);
+        w.out.lit(" ) ");
+        break;
+    case FLOATLIT_NODE:
+        w.out.lit("factor( ");
+        w.number((float)rec.value.f);
+        w.out.lit(" ) ");
+        break;
+    case NESTED_EXPR_NODE:
+        text(rec.text);
+        w.out.lit("nested_expression( ");
+        expression(ast.child(rec, 0));
+        w.out.lit(" ) ");
+        text(rec.text2);
+        break;
+    default:
+        break;
+    }
+}
+
+#endif /* AST_BINARY_H */
@@ -0,0 +1,22 @@
+PROGRAM HOIST;
+VAR
+  N: INTEGER;
+  A: INTEGER;
+  B: INTEGER;
+  I: INTEGER;
+  S: INTEGER;
+BEGIN
+  READ(N);
+  READ(A);
+  READ(B);
+  I := 0;
+  S := 0;
+  WHILE I < N
+  BEGIN
+    S := S + (A * B + A / 3) * (B - A) + I MOD 8;
+    IF S > 1000000 THEN
+      S := S - (A * B + A / 3) * 7;
+    I := I + 1
+  END;
+  WRITE(S)
+END
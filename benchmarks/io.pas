@@ -0,0 +1,17 @@
+PROGRAM IO;
+VAR
+    N: INTEGER;
+    I: INTEGER;
+    X: REAL;
+BEGIN
+    READ(N);
+    I := 0;
+    WHILE I < N
+    BEGIN
+        X := I / 7.0;
+        WRITE(I);
+        WRITE(X);
+        WRITE('A LINE OF TEXT FROM THE PROGRAM');
+        I := I + 1
+    END
+END
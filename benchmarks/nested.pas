@@ -0,0 +1,30 @@
+PROGRAM NESTED;
+VAR
+  N: INTEGER;
+  M: INTEGER;
+  I: INTEGER;
+  J: INTEGER;
+  S: INTEGER;
+  R: REAL;
+  SCALE: REAL;
+BEGIN
+  READ(N);
+  READ(M);
+  READ(SCALE);
+  I := 0;
+  S := 0;
+  R := 0;
+  WHILE I < N
+  BEGIN
+    J := 0;
+    WHILE J < M
+    BEGIN
+      S := S + I * M + J * 4;
+      R := R + SCALE * 2.5 / M;
+      J := J + 1
+    END;
+    I := I + 1
+  END;
+  WRITE(S);
+  WRITE(R)
+END
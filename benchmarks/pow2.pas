@@ -0,0 +1,20 @@
+PROGRAM POW2;
+VAR
+  N: INTEGER;
+  I: INTEGER;
+  X: INTEGER;
+  H: INTEGER;
+BEGIN
+  READ(N);
+  READ(X);
+  I := 0;
+  H := 0;
+  WHILE I < N
+  BEGIN
+    X := (X * 32 + I) MOD 65536 - 30000;
+    H := H + X / 16 - X MOD 4;
+    I := I + 1
+  END;
+  WRITE(X);
+  WRITE(H)
+END
@@ -0,0 +1,13 @@
+#!/bin/bash
+# Regenerates superinstructions.h from a profile of the opcode pairs the vm
+# runs on every unit test and benchmark program, each with its .in file if
+# it has one. Run after make, then make again.
+cd "$(dirname "$0")/.."
+rm -f TEST.profile
+for prog in unit_tests/*.pas benchmarks/*.pas; do
+    input=${prog%.pas}.in
+    [ -f "$input" ] || input=/dev/null
+    ./tips_parse --run --profile=TEST.profile "$prog" < "$input" > /dev/null
+done
+./tips_parse --gen-super=TEST.profile > superinstructions.h
+rm -f TEST.profile
@@ -0,0 +1,18 @@
+#!/bin/bash
+# Times every benchmark program on each engine: the vm as written (--no-opt)
+# and optimized, then the tree walker, the closure compiler and the jit.
+# BENCH times include compiling the program for the engine, which is what
+# straight.pas, run once, measures. Run after make; each program reads its
+# .in file.
+cd "$(dirname "$0")/.."
+for prog in benchmarks/*.pas; do
+    echo "=== $prog"
+    for opt in --no-opt --opt --engine=tree --engine=closure --engine=jit; do
+        flag=$opt
+        [ "$opt" = --opt ] && flag=
+        ./tips_parse --run --bench $flag "$prog" < "${prog%.pas}.in" 2>&1 >/dev/null | sed "s/^/$(printf "%-17s" $opt)/"
+    done
+done
+# io.pas again, its output written with writev instead of buffered
+echo "=== benchmarks/io.pas --writev"
+./tips_parse --run --bench --writev benchmarks/io.pas < benchmarks/io.in 2>&1 >/dev/null | sed "s/^/$(printf "%-17s" --writev)/"
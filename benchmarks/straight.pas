@@ -0,0 +1,2021 @@
+PROGRAM STRAIGHT;
+VAR
+  A: INTEGER;
+  B: INTEGER;
+  C: INTEGER;
+  D: INTEGER;
+  E: INTEGER;
+  F: INTEGER;
+  G: INTEGER;
+  H: INTEGER;
+BEGIN
+  READ(A);
+  H := A + 1 * D - A MOD 1;
+  IF E > D THEN C := E - 1 ELSE C := D / 2;
+  F := (E + H) * 3 MOD 1000;
+  A := A - C + 3;
+  D := H + 5 * A - H MOD 5;
+  IF C > F THEN B := C - 0 ELSE B := F / 3;
+  E := (F + C) * 7 MOD 1000;
+  B := A - G + 7;
+  F := F + 9 * D - F MOD 2;
+  IF C > E THEN C := C - 4 ELSE C := E / 1;
+  E := (E + H) * 11 MOD 1000;
+  C := H - D + 11;
+  G := B + 4 * C - B MOD 6;
+  IF D > A THEN B := D - 3 ELSE B := A / 2;
+  H := (E + B) * 4 MOD 1000;
+  D := H - D + 2;
+  H := B + 8 * H - B MOD 3;
+  IF F > H THEN E := F - 2 ELSE E := H / 3;
+  D := (B + A) * 8 MOD 1000;
+  C := C - G + 6;
+  H := B + 3 * G - B MOD 7;
+  IF D > A THEN G := D - 1 ELSE G := A / 1;
+  H := (D + D) * 1 MOD 1000;
+  H := C - D + 10;
+  C := E + 7 * E - E MOD 4;
+  IF B > C THEN F := B - 0 ELSE F := C / 2;
+  C := (D + A) * 5 MOD 1000;
+  D := A - C + 1;
+  D := D + 2 * G - D MOD 1;
+  IF G > H THEN E := G - 4 ELSE E := H / 3;
+  E := (D + A) * 9 MOD 1000;
+  G := C - A + 5;
+  C := E + 6 * A - E MOD 5;
+  IF E > F THEN G := E - 3 ELSE G := F / 1;
+  G := (F + A) * 2 MOD 1000;
+  E := E - H + 9;
+  A := D + 1 * A - D MOD 2;
+  IF F > E THEN B := F - 2 ELSE B := E / 2;
+  A := (A + E) * 6 MOD 1000;
+  A := B - E + 0;
+  C := C + 5 * A - C MOD 6;
+  IF A > F THEN D := A - 1 ELSE D := F / 3;
+  F := (G + H) * 10 MOD 1000;
+  A := E - C + 4;
+  A := H + 9 * B - H MOD 3;
+  IF D > H THEN H := D - 0 ELSE H := H / 1;
+  E := (H + D) * 3 MOD 1000;
+  H := F - G + 8;
+  H := H + 4 * A - H MOD 7;
+  IF D > G THEN F := D - 4 ELSE F := G / 2;
+  C := (G + G) * 7 MOD 1000;
+  A := A - D + 12;
+  A := C + 8 * F - C MOD 4;
+  IF B > D THEN F := B - 3 ELSE F := D / 3;
+  G := (F + A) * 11 MOD 1000;
+  D := C - B + 3;
+  C := G + 3 * B - G MOD 1;
+  IF B > D THEN G := B - 2 ELSE G := D / 1;
+  H := (B + A) * 4 MOD 1000;
+  B := E - E + 7;
+  A := D + 7 * H - D MOD 5;
+  IF F > C THEN G := F - 1 ELSE G := C / 2;
+  D := (B + G) * 8 MOD 1000;
+  C := A - B + 11;
+  H := D + 2 * H - D MOD 2;
+  IF G > B THEN E := G - 0 ELSE E := B / 3;
+  H := (H + D) * 1 MOD 1000;
+  H := E - C + 2;
+  H := H + 6 * F - H MOD 6;
+  IF G > D THEN A := G - 4 ELSE A := D / 1;
+  B := (B + A) * 5 MOD 1000;
+  B := D - B + 6;
+  H := E + 1 * D - E MOD 3;
+  IF G > C THEN H := G - 3 ELSE H := C / 2;
+  D := (H + G) * 9 MOD 1000;
+  E := A - B + 10;
+  C := B + 5 * G - B MOD 7;
+  IF F > H THEN G := F - 2 ELSE G := H / 3;
+  D := (F + F) * 2 MOD 1000;
+  G := B - C + 1;
+  G := B + 9 * E - B MOD 4;
+  IF A > A THEN F := A - 1 ELSE F := A / 1;
+  D := (C + F) * 6 MOD 1000;
+  G := H - B + 5;
+  F := H + 4 * H - H MOD 1;
+  IF F > D THEN H := F - 0 ELSE H := D / 2;
+  D := (F + D) * 10 MOD 1000;
+  F := C - H + 9;
+  A := E + 8 * H - E MOD 5;
+  IF C > A THEN C := C - 4 ELSE C := A / 3;
+  G := (E + G) * 3 MOD 1000;
+  C := E - C + 0;
+  A := D + 3 * A - D MOD 2;
+  IF C > C THEN C := C - 3 ELSE C := C / 1;
+  G := (C + E) * 7 MOD 1000;
+  B := F - G + 4;
+  B := B + 7 * A - B MOD 6;
+  IF F > F THEN H := F - 2 ELSE H := F / 2;
+  C := (E + B) * 11 MOD 1000;
+  B := D - F + 8;
+  H := A + 2 * G - A MOD 3;
+  IF A > C THEN D := A - 1 ELSE D := C / 3;
+  D := (D + H) * 4 MOD 1000;
+  D := A - D + 12;
+  H := H + 6 * H - H MOD 7;
+  IF F > A THEN C := F - 0 ELSE C := A / 1;
+  H := (C + E) * 8 MOD 1000;
+  C := B - E + 3;
+  H := D + 1 * F - D MOD 4;
+  IF H > H THEN D := H - 4 ELSE D := H / 2;
+  D := (A + D) * 1 MOD 1000;
+  E := H - E + 7;
+  B := B + 5 * D - B MOD 1;
+  IF A > A THEN G := A - 3 ELSE G := A / 3;
+  E := (H + D) * 5 MOD 1000;
+  B := A - H + 11;
+  H := G + 9 * D - G MOD 5;
+  IF E > G THEN E := E - 2 ELSE E := G / 1;
+  B := (H + B) * 9 MOD 1000;
+  D := B - H + 2;
+  E := H + 4 * G - H MOD 2;
+  IF F > B THEN C := F - 1 ELSE C := B / 2;
+  A := (A + G) * 2 MOD 1000;
+  B := H - B + 6;
+  G := A + 8 * G - A MOD 6;
+  IF H > G THEN F := H - 0 ELSE F := G / 3;
+  G := (C + A) * 6 MOD 1000;
+  F := E - H + 10;
+  C := B + 3 * A - B MOD 3;
+  IF H > C THEN E := H - 4 ELSE E := C / 1;
+  C := (H + C) * 10 MOD 1000;
+  F := F - G + 1;
+  G := E + 7 * G - E MOD 7;
+  IF C > H THEN H := C - 3 ELSE H := H / 2;
+  E := (D + D) * 3 MOD 1000;
+  B := G - F + 5;
+  D := C + 2 * G - C MOD 4;
+  IF D > H THEN G := D - 2 ELSE G := H / 3;
+  G := (C + D) * 7 MOD 1000;
+  C := D - F + 9;
+  F := C + 6 * C - C MOD 1;
+  IF H > E THEN H := H - 1 ELSE H := E / 1;
+  C := (D + E) * 11 MOD 1000;
+  F := D - B + 0;
+  F := A + 1 * G - A MOD 5;
+  IF H > A THEN E := H - 0 ELSE E := A / 2;
+  A := (A + G) * 4 MOD 1000;
+  G := D - F + 4;
+  C := G + 5 * C - G MOD 2;
+  IF C > F THEN G := C - 4 ELSE G := F / 3;
+  F := (H + A) * 8 MOD 1000;
+  C := A - G + 8;
+  B := C + 9 * B - C MOD 6;
+  IF H > B THEN B := H - 3 ELSE B := B / 1;
+  A := (C + A) * 1 MOD 1000;
+  B := G - A + 12;
+  H := E + 4 * F - E MOD 3;
+  IF F > B THEN A := F - 2 ELSE A := B / 2;
+  G := (E + A) * 5 MOD 1000;
+  B := A - C + 3;
+  F := C + 8 * B - C MOD 7;
+  IF G > G THEN D := G - 1 ELSE D := G / 3;
+  B := (G + B) * 9 MOD 1000;
+  C := D - F + 7;
+  F := E + 3 * H - E MOD 4;
+  IF H > E THEN E := H - 0 ELSE E := E / 1;
+  B := (C + A) * 2 MOD 1000;
+  G := G - B + 11;
+  F := C + 7 * A - C MOD 1;
+  IF H > H THEN B := H - 4 ELSE B := H / 2;
+  E := (E + F) * 6 MOD 1000;
+  H := B - A + 2;
+  B := D + 2 * H - D MOD 5;
+  IF E > A THEN B := E - 3 ELSE B := A / 3;
+  E := (B + E) * 10 MOD 1000;
+  B := C - G + 6;
+  D := A + 6 * F - A MOD 2;
+  IF B > B THEN A := B - 2 ELSE A := B / 1;
+  C := (F + F) * 3 MOD 1000;
+  F := D - B + 10;
+  G := F + 1 * G - F MOD 6;
+  IF C > B THEN F := C - 1 ELSE F := B / 2;
+  H := (A + H) * 7 MOD 1000;
+  C := G - D + 1;
+  A := B + 5 * H - B MOD 3;
+  IF A > B THEN A := A - 0 ELSE A := B / 3;
+  G := (C + G) * 11 MOD 1000;
+  C := B - C + 5;
+  H := G + 9 * A - G MOD 7;
+  IF A > G THEN G := A - 4 ELSE G := G / 1;
+  E := (B + G) * 4 MOD 1000;
+  A := B - C + 9;
+  G := B + 4 * A - B MOD 4;
+  IF E > B THEN H := E - 3 ELSE H := B / 2;
+  F := (H + G) * 8 MOD 1000;
+  F := A - A + 0;
+  E := C + 8 * F - C MOD 1;
+  IF G > C THEN D := G - 2 ELSE D := C / 3;
+  F := (F + A) * 1 MOD 1000;
+  B := F - D + 4;
+  A := E + 3 * C - E MOD 5;
+  IF E > G THEN A := E - 1 ELSE A := G / 1;
+  B := (H + D) * 5 MOD 1000;
+  C := D - A + 8;
+  F := D + 7 * G - D MOD 2;
+  IF A > F THEN C := A - 0 ELSE C := F / 2;
+  G := (E + F) * 9 MOD 1000;
+  D := E - C + 12;
+  H := A + 2 * E - A MOD 6;
+  IF F > C THEN D := F - 4 ELSE D := C / 3;
+  E := (H + G) * 2 MOD 1000;
+  E := B - G + 3;
+  G := H + 6 * H - H MOD 3;
+  IF F > C THEN B := F - 3 ELSE B := C / 1;
+  F := (E + F) * 6 MOD 1000;
+  D := B - D + 7;
+  H := C + 1 * A - C MOD 7;
+  IF C > G THEN H := C - 2 ELSE H := G / 2;
+  B := (C + B) * 10 MOD 1000;
+  B := E - G + 11;
+  F := D + 5 * D - D MOD 4;
+  IF E > E THEN A := E - 1 ELSE A := E / 3;
+  D := (H + H) * 3 MOD 1000;
+  A := E - G + 2;
+  A := F + 9 * D - F MOD 1;
+  IF G > B THEN H := G - 0 ELSE H := B / 1;
+  H := (B + C) * 7 MOD 1000;
+  G := B - G + 6;
+  E := H + 4 * F - H MOD 5;
+  IF G > D THEN G := G - 4 ELSE G := D / 2;
+  B := (G + E) * 11 MOD 1000;
+  A := F - B + 10;
+  B := A + 8 * F - A MOD 2;
+  IF B > F THEN F := B - 3 ELSE F := F / 3;
+  C := (F + F) * 4 MOD 1000;
+  E := H - D + 1;
+  C := A + 3 * A - A MOD 6;
+  IF C > B THEN H := C - 2 ELSE H := B / 1;
+  H := (E + A) * 8 MOD 1000;
+  G := A - C + 5;
+  B := B + 7 * D - B MOD 3;
+  IF A > A THEN B := A - 1 ELSE B := A / 2;
+  A := (G + H) * 1 MOD 1000;
+  D := D - D + 9;
+  B := F + 2 * G - F MOD 7;
+  IF D > E THEN A := D - 0 ELSE A := E / 3;
+  E := (E + A) * 5 MOD 1000;
+  E := B - G + 0;
+  E := A + 6 * H - A MOD 4;
+  IF A > C THEN C := A - 4 ELSE C := C / 1;
+  C := (C + A) * 9 MOD 1000;
+  A := D - G + 4;
+  H := H + 1 * A - H MOD 1;
+  IF F > E THEN B := F - 3 ELSE B := E / 2;
+  A := (H + F) * 2 MOD 1000;
+  B := G - F + 8;
+  D := B + 5 * C - B MOD 5;
+  IF D > D THEN G := D - 2 ELSE G := D / 3;
+  C := (D + C) * 6 MOD 1000;
+  H := E - E + 12;
+  B := F + 9 * F - F MOD 2;
+  IF F > D THEN A := F - 1 ELSE A := D / 1;
+  G := (F + E) * 10 MOD 1000;
+  H := E - H + 3;
+  C := D + 4 * A - D MOD 6;
+  IF C > C THEN G := C - 0 ELSE G := C / 2;
+  E := (F + F) * 3 MOD 1000;
+  E := G - D + 7;
+  A := H + 8 * G - H MOD 3;
+  IF F > D THEN E := F - 4 ELSE E := D / 3;
+  C := (A + C) * 7 MOD 1000;
+  C := D - D + 11;
+  G := D + 3 * F - D MOD 7;
+  IF E > B THEN D := E - 3 ELSE D := B / 1;
+  B := (F + B) * 11 MOD 1000;
+  E := C - F + 2;
+  F := E + 7 * H - E MOD 4;
+  IF A > C THEN E := A - 2 ELSE E := C / 2;
+  B := (D + H) * 4 MOD 1000;
+  A := E - A + 6;
+  A := A + 2 * H - A MOD 1;
+  IF A > G THEN E := A - 1 ELSE E := G / 3;
+  H := (C + H) * 8 MOD 1000;
+  G := A - A + 10;
+  C := H + 6 * G - H MOD 5;
+  IF C > B THEN C := C - 0 ELSE C := B / 1;
+  G := (B + H) * 1 MOD 1000;
+  E := H - F + 1;
+  G := B + 1 * C - B MOD 2;
+  IF A > G THEN H := A - 4 ELSE H := G / 2;
+  B := (H + D) * 5 MOD 1000;
+  E := B - B + 5;
+  F := E + 5 * H - E MOD 6;
+  IF H > F THEN H := H - 3 ELSE H := F / 3;
+  E := (B + A) * 9 MOD 1000;
+  B := C - F + 9;
+  H := D + 9 * G - D MOD 3;
+  IF C > D THEN E := C - 2 ELSE E := D / 1;
+  F := (H + G) * 2 MOD 1000;
+  G := H - B + 0;
+  C := C + 4 * C - C MOD 7;
+  IF G > H THEN A := G - 1 ELSE A := H / 2;
+  F := (C + E) * 6 MOD 1000;
+  F := B - D + 4;
+  C := D + 8 * A - D MOD 4;
+  IF C > G THEN F := C - 0 ELSE F := G / 3;
+  D := (D + A) * 10 MOD 1000;
+  H := F - E + 8;
+  C := F + 3 * D - F MOD 1;
+  IF H > H THEN C := H - 4 ELSE C := H / 1;
+  B := (A + H) * 3 MOD 1000;
+  F := D - C + 12;
+  A := E + 7 * C - E MOD 5;
+  IF F > A THEN E := F - 3 ELSE E := A / 2;
+  A := (G + H) * 7 MOD 1000;
+  B := D - G + 3;
+  G := A + 2 * G - A MOD 2;
+  IF H > C THEN H := H - 2 ELSE H := C / 3;
+  E := (G + A) * 11 MOD 1000;
+  C := H - D + 7;
+  A := D + 6 * E - D MOD 6;
+  IF E > H THEN D := E - 1 ELSE D := H / 1;
+  C := (E + B) * 4 MOD 1000;
+  F := H - H + 11;
+  F := A + 1 * H - A MOD 3;
+  IF C > G THEN F := C - 0 ELSE F := G / 2;
+  G := (F + G) * 8 MOD 1000;
+  H := H - C + 2;
+  F := E + 5 * B - E MOD 7;
+  IF H > H THEN D := H - 4 ELSE D := H / 3;
+  G := (A + B) * 1 MOD 1000;
+  E := A - H + 6;
+  G := G + 9 * A - G MOD 4;
+  IF A > C THEN D := A - 3 ELSE D := C / 1;
+  G := (G + C) * 5 MOD 1000;
+  F := G - E + 10;
+  D := B + 4 * A - B MOD 1;
+  IF H > B THEN G := H - 2 ELSE G := B / 2;
+  C := (C + D) * 9 MOD 1000;
+  B := G - B + 1;
+  B := D + 8 * C - D MOD 5;
+  IF E > E THEN F := E - 1 ELSE F := E / 3;
+  E := (A + G) * 2 MOD 1000;
+  E := B - D + 5;
+  F := F + 3 * E - F MOD 2;
+  IF H > E THEN A := H - 0 ELSE A := E / 1;
+  F := (C + F) * 6 MOD 1000;
+  B := G - E + 9;
+  C := H + 7 * A - H MOD 6;
+  IF F > C THEN A := F - 4 ELSE A := C / 2;
+  D := (F + D) * 10 MOD 1000;
+  G := E - A + 0;
+  C := A + 2 * A - A MOD 3;
+  IF C > A THEN B := C - 3 ELSE B := A / 3;
+  G := (A + B) * 3 MOD 1000;
+  D := D - B + 4;
+  A := B + 6 * B - B MOD 7;
+  IF F > C THEN C := F - 2 ELSE C := C / 1;
+  D := (C + G) * 7 MOD 1000;
+  G := F - E + 8;
+  A := E + 1 * F - E MOD 4;
+  IF F > B THEN G := F - 1 ELSE G := B / 2;
+  G := (C + H) * 11 MOD 1000;
+  B := E - D + 12;
+  A := F + 5 * F - F MOD 1;
+  IF H > E THEN G := H - 0 ELSE G := E / 3;
+  G := (F + B) * 4 MOD 1000;
+  A := A - C + 3;
+  F := A + 9 * H - A MOD 5;
+  IF G > A THEN G := G - 4 ELSE G := A / 1;
+  A := (G + E) * 8 MOD 1000;
+  A := E - C + 7;
+  F := F + 4 * F - F MOD 2;
+  IF H > A THEN E := H - 3 ELSE E := A / 2;
+  E := (C + E) * 1 MOD 1000;
+  D := H - F + 11;
+  H := B + 8 * D - B MOD 6;
+  IF C > H THEN E := C - 2 ELSE E := H / 3;
+  G := (G + E) * 5 MOD 1000;
+  C := D - A + 2;
+  H := D + 3 * D - D MOD 3;
+  IF D > B THEN D := D - 1 ELSE D := B / 1;
+  B := (A + B) * 9 MOD 1000;
+  E := B - D + 6;
+  C := G + 7 * D - G MOD 7;
+  IF F > A THEN B := F - 0 ELSE B := A / 2;
+  F := (H + E) * 2 MOD 1000;
+  G := A - A + 10;
+  E := D + 2 * G - D MOD 4;
+  IF G > A THEN C := G - 4 ELSE C := A / 3;
+  H := (G + F) * 6 MOD 1000;
+  E := G - G + 1;
+  F := D + 6 * H - D MOD 1;
+  IF A > G THEN C := A - 3 ELSE C := G / 1;
+  D := (G + H) * 10 MOD 1000;
+  D := H - E + 5;
+  H := G + 1 * A - G MOD 5;
+  IF A > H THEN E := A - 2 ELSE E := H / 2;
+  D := (D + F) * 3 MOD 1000;
+  B := D - A + 9;
+  F := D + 5 * G - D MOD 2;
+  IF C > G THEN A := C - 1 ELSE A := G / 3;
+  H := (E + E) * 7 MOD 1000;
+  D := C - C + 0;
+  D := G + 9 * A - G MOD 6;
+  IF E > D THEN D := E - 0 ELSE D := D / 1;
+  E := (B + F) * 11 MOD 1000;
+  D := B - B + 4;
+  C := D + 4 * G - D MOD 3;
+  IF G > D THEN F := G - 4 ELSE F := D / 2;
+  A := (B + H) * 4 MOD 1000;
+  B := A - H + 8;
+  G := H + 8 * G - H MOD 7;
+  IF E > C THEN D := E - 3 ELSE D := C / 3;
+  F := (D + C) * 8 MOD 1000;
+  A := C - C + 12;
+  F := D + 3 * H - D MOD 4;
+  IF D > D THEN B := D - 2 ELSE B := D / 1;
+  F := (E + D) * 1 MOD 1000;
+  H := E - A + 3;
+  A := G + 7 * E - G MOD 1;
+  IF G > C THEN A := G - 1 ELSE A := C / 2;
+  D := (F + E) * 5 MOD 1000;
+  F := H - F + 7;
+  E := G + 2 * D - G MOD 5;
+  IF H > H THEN G := H - 0 ELSE G := H / 3;
+  B := (H + B) * 9 MOD 1000;
+  F := F - E + 11;
+  C := F + 6 * G - F MOD 2;
+  IF H > A THEN C := H - 4 ELSE C := A / 1;
+  C := (F + C) * 2 MOD 1000;
+  C := E - F + 2;
+  E := B + 1 * E - B MOD 6;
+  IF A > H THEN A := A - 3 ELSE A := H / 2;
+  F := (C + D) * 6 MOD 1000;
+  F := C - B + 6;
+  H := C + 5 * D - C MOD 3;
+  IF D > F THEN G := D - 2 ELSE G := F / 3;
+  E := (H + A) * 10 MOD 1000;
+  H := E - F + 10;
+  C := F + 9 * B - F MOD 7;
+  IF E > A THEN B := E - 1 ELSE B := A / 1;
+  G := (F + G) * 3 MOD 1000;
+  H := F - F + 1;
+  B := C + 4 * F - C MOD 4;
+  IF C > A THEN G := C - 0 ELSE G := A / 2;
+  G := (F + D) * 7 MOD 1000;
+  F := D - F + 5;
+  H := B + 8 * F - B MOD 1;
+  IF G > C THEN A := G - 4 ELSE A := C / 3;
+  E := (D + A) * 11 MOD 1000;
+  F := H - F + 9;
+  B := D + 3 * D - D MOD 5;
+  IF F > F THEN D := F - 3 ELSE D := F / 1;
+  C := (A + H) * 4 MOD 1000;
+  H := F - A + 0;
+  H := G + 7 * B - G MOD 2;
+  IF H > A THEN E := H - 2 ELSE E := A / 2;
+  H := (G + C) * 8 MOD 1000;
+  F := F - G + 4;
+  H := E + 2 * A - E MOD 6;
+  IF D > D THEN A := D - 1 ELSE A := D / 3;
+  F := (B + E) * 1 MOD 1000;
+  A := F - D + 8;
+  E := F + 6 * B - F MOD 3;
+  IF F > D THEN D := F - 0 ELSE D := D / 1;
+  E := (B + C) * 5 MOD 1000;
+  H := H - A + 12;
+  A := A + 1 * E - A MOD 7;
+  IF G > H THEN F := G - 4 ELSE F := H / 2;
+  D := (A + B) * 9 MOD 1000;
+  F := H - C + 3;
+  E := F + 5 * A - F MOD 4;
+  IF E > A THEN H := E - 3 ELSE H := A / 3;
+  G := (A + E) * 2 MOD 1000;
+  C := A - E + 7;
+  E := E + 9 * B - E MOD 1;
+  IF B > E THEN B := B - 2 ELSE B := E / 1;
+  G := (E + E) * 6 MOD 1000;
+  H := H - E + 11;
+  D := E + 4 * A - E MOD 5;
+  IF D > C THEN E := D - 1 ELSE E := C / 2;
+  F := (F + E) * 10 MOD 1000;
+  E := F - E + 2;
+  F := F + 8 * G - F MOD 2;
+  IF C > A THEN A := C - 0 ELSE A := A / 3;
+  F := (G + A) * 3 MOD 1000;
+  B := H - G + 6;
+  C := F + 3 * E - F MOD 6;
+  IF G > G THEN C := G - 4 ELSE C := G / 1;
+  B := (F + H) * 7 MOD 1000;
+  E := D - B + 10;
+  D := C + 7 * H - C MOD 3;
+  IF A > H THEN F := A - 3 ELSE F := H / 2;
+  D := (C + H) * 11 MOD 1000;
+  F := E - H + 1;
+  C := H + 2 * F - H MOD 7;
+  IF D > C THEN B := D - 2 ELSE B := C / 3;
+  C := (A + H) * 4 MOD 1000;
+  F := C - H + 5;
+  D := C + 6 * H - C MOD 4;
+  IF B > F THEN E := B - 1 ELSE E := F / 1;
+  A := (G + H) * 8 MOD 1000;
+  H := H - H + 9;
+  F := H + 1 * B - H MOD 1;
+  IF C > E THEN C := C - 0 ELSE C := E / 2;
+  C := (D + G) * 1 MOD 1000;
+  D := E - A + 0;
+  E := C + 5 * B - C MOD 5;
+  IF B > C THEN B := B - 4 ELSE B := C / 3;
+  D := (G + F) * 5 MOD 1000;
+  D := C - D + 4;
+  E := B + 9 * E - B MOD 2;
+  IF A > B THEN D := A - 3 ELSE D := B / 1;
+  E := (G + H) * 9 MOD 1000;
+  E := G - H + 8;
+  A := E + 4 * A - E MOD 6;
+  IF B > E THEN F := B - 2 ELSE F := E / 2;
+  A := (C + H) * 2 MOD 1000;
+  A := D - F + 12;
+  B := B + 8 * D - B MOD 3;
+  IF G > D THEN D := G - 1 ELSE D := D / 3;
+  G := (E + E) * 6 MOD 1000;
+  H := H - F + 3;
+  B := H + 3 * G - H MOD 7;
+  IF D > C THEN E := D - 0 ELSE E := C / 1;
+  D := (D + C) * 10 MOD 1000;
+  F := E - A + 7;
+  F := C + 7 * F - C MOD 4;
+  IF A > F THEN D := A - 4 ELSE D := F / 2;
+  H := (G + A) * 3 MOD 1000;
+  G := E - G + 11;
+  G := G + 2 * E - G MOD 1;
+  IF B > D THEN A := B - 3 ELSE A := D / 3;
+  G := (G + B) * 7 MOD 1000;
+  A := C - F + 2;
+  H := G + 6 * G - G MOD 5;
+  IF F > G THEN C := F - 2 ELSE C := G / 1;
+  G := (E + B) * 11 MOD 1000;
+  F := A - G + 6;
+  E := F + 1 * E - F MOD 2;
+  IF C > H THEN C := C - 1 ELSE C := H / 2;
+  F := (F + E) * 4 MOD 1000;
+  B := H - B + 10;
+  A := D + 5 * B - D MOD 6;
+  IF C > A THEN F := C - 0 ELSE F := A / 3;
+  G := (D + H) * 8 MOD 1000;
+  H := E - F + 1;
+  D := E + 9 * B - E MOD 3;
+  IF H > G THEN G := H - 4 ELSE G := G / 1;
+  F := (E + C) * 1 MOD 1000;
+  F := E - A + 5;
+  D := B + 4 * B - B MOD 7;
+  IF G > C THEN G := G - 3 ELSE G := C / 2;
+  B := (G + G) * 5 MOD 1000;
+  G := G - H + 9;
+  B := C + 8 * H - C MOD 4;
+  IF F > G THEN B := F - 2 ELSE B := G / 3;
+  B := (H + H) * 9 MOD 1000;
+  D := G - H + 0;
+  F := H + 3 * A - H MOD 1;
+  IF A > G THEN F := A - 1 ELSE F := G / 1;
+  A := (E + B) * 2 MOD 1000;
+  E := B - H + 4;
+  H := F + 7 * C - F MOD 5;
+  IF G > D THEN F := G - 0 ELSE F := D / 2;
+  E := (F + E) * 6 MOD 1000;
+  B := E - G + 8;
+  C := F + 2 * E - F MOD 2;
+  IF D > G THEN E := D - 4 ELSE E := G / 3;
+  F := (D + A) * 10 MOD 1000;
+  D := B - E + 12;
+  C := E + 6 * H - E MOD 6;
+  IF H > G THEN B := H - 3 ELSE B := G / 1;
+  F := (F + D) * 3 MOD 1000;
+  H := G - D + 3;
+  H := H + 1 * E - H MOD 3;
+  IF C > C THEN H := C - 2 ELSE H := C / 2;
+  C := (A + H) * 7 MOD 1000;
+  F := A - F + 7;
+  B := C + 5 * C - C MOD 7;
+  IF C > H THEN A := C - 1 ELSE A := H / 3;
+  B := (E + E) * 11 MOD 1000;
+  B := F - A + 11;
+  A := G + 9 * G - G MOD 4;
+  IF H > G THEN F := H - 0 ELSE F := G / 1;
+  G := (C + D) * 4 MOD 1000;
+  A := E - A + 2;
+  B := H + 4 * E - H MOD 1;
+  IF H > F THEN E := H - 4 ELSE E := F / 2;
+  F := (G + F) * 8 MOD 1000;
+  G := C - G + 6;
+  H := G + 8 * C - G MOD 5;
+  IF E > G THEN F := E - 3 ELSE F := G / 3;
+  F := (H + H) * 1 MOD 1000;
+  H := F - A + 10;
+  A := C + 3 * H - C MOD 2;
+  IF H > H THEN F := H - 2 ELSE F := H / 1;
+  E := (G + H) * 5 MOD 1000;
+  E := B - A + 1;
+  E := E + 7 * G - E MOD 6;
+  IF B > G THEN B := B - 1 ELSE B := G / 2;
+  E := (G + C) * 9 MOD 1000;
+  F := F - B + 5;
+  B := B + 2 * H - B MOD 3;
+  IF C > D THEN G := C - 0 ELSE G := D / 3;
+  H := (F + C) * 2 MOD 1000;
+  F := F - F + 9;
+  H := F + 6 * G - F MOD 7;
+  IF F > F THEN E := F - 4 ELSE E := F / 1;
+  D := (F + B) * 6 MOD 1000;
+  C := H - B + 0;
+  B := H + 1 * D - H MOD 4;
+  IF B > A THEN D := B - 3 ELSE D := A / 2;
+  C := (H + F) * 10 MOD 1000;
+  G := B - A + 4;
+  G := B + 5 * H - B MOD 1;
+  IF F > D THEN B := F - 2 ELSE B := D / 3;
+  B := (F + C) * 3 MOD 1000;
+  E := B - C + 8;
+  G := D + 9 * G - D MOD 5;
+  IF G > A THEN E := G - 1 ELSE E := A / 1;
+  D := (G + G) * 7 MOD 1000;
+  C := A - G + 12;
+  E := E + 4 * B - E MOD 2;
+  IF E > H THEN E := E - 0 ELSE E := H / 2;
+  C := (B + B) * 11 MOD 1000;
+  G := D - D + 3;
+  E := B + 8 * F - B MOD 6;
+  IF F > B THEN C := F - 4 ELSE C := B / 3;
+  D := (B + H) * 4 MOD 1000;
+  F := D - H + 7;
+  E := F + 3 * H - F MOD 3;
+  IF E > E THEN C := E - 3 ELSE C := E / 1;
+  D := (F + G) * 8 MOD 1000;
+  F := F - H + 11;
+  B := B + 7 * E - B MOD 7;
+  IF C > B THEN B := C - 2 ELSE B := B / 2;
+  E := (E + H) * 1 MOD 1000;
+  D := E - E + 2;
+  G := E + 2 * D - E MOD 4;
+  IF H > B THEN H := H - 1 ELSE H := B / 3;
+  F := (E + C) * 5 MOD 1000;
+  G := B - G + 6;
+  D := E + 6 * H - E MOD 1;
+  IF A > F THEN G := A - 0 ELSE G := F / 1;
+  H := (A + G) * 9 MOD 1000;
+  C := C - G + 10;
+  E := F + 1 * E - F MOD 5;
+  IF D > H THEN A := D - 4 ELSE A := H / 2;
+  G := (A + F) * 2 MOD 1000;
+  H := G - E + 1;
+  D := C + 5 * D - C MOD 2;
+  IF H > C THEN B := H - 3 ELSE B := C / 3;
+  H := (F + H) * 6 MOD 1000;
+  H := F - A + 5;
+  E := C + 9 * B - C MOD 6;
+  IF H > G THEN F := H - 2 ELSE F := G / 1;
+  B := (D + F) * 10 MOD 1000;
+  H := D - G + 9;
+  C := B + 4 * E - B MOD 3;
+  IF D > A THEN C := D - 1 ELSE C := A / 2;
+  G := (G + H) * 3 MOD 1000;
+  F := B - C + 0;
+  B := A + 8 * E - A MOD 7;
+  IF F > B THEN E := F - 0 ELSE E := B / 3;
+  D := (G + A) * 7 MOD 1000;
+  C := B - G + 4;
+  G := H + 3 * H - H MOD 4;
+  IF E > B THEN C := E - 4 ELSE C := B / 1;
+  F := (B + E) * 11 MOD 1000;
+  G := G - B + 8;
+  D := F + 7 * A - F MOD 1;
+  IF F > C THEN A := F - 3 ELSE A := C / 2;
+  G := (E + H) * 4 MOD 1000;
+  E := E - B + 12;
+  B := C + 2 * D - C MOD 5;
+  IF E > B THEN H := E - 2 ELSE H := B / 3;
+  B := (B + H) * 8 MOD 1000;
+  D := C - F + 3;
+  F := D + 6 * F - D MOD 2;
+  IF G > H THEN A := G - 1 ELSE A := H / 1;
+  F := (G + G) * 1 MOD 1000;
+  F := C - A + 7;
+  F := C + 1 * G - C MOD 6;
+  IF D > B THEN F := D - 0 ELSE F := B / 2;
+  F := (G + A) * 5 MOD 1000;
+  D := B - E + 11;
+  C := G + 5 * E - G MOD 3;
+  IF G > B THEN E := G - 4 ELSE E := B / 3;
+  A := (B + G) * 9 MOD 1000;
+  E := E - E + 2;
+  H := E + 9 * F - E MOD 7;
+  IF F > G THEN E := F - 3 ELSE E := G / 1;
+  B := (F + G) * 2 MOD 1000;
+  D := H - B + 6;
+  B := C + 4 * A - C MOD 4;
+  IF A > G THEN B := A - 2 ELSE B := G / 2;
+  A := (G + E) * 6 MOD 1000;
+  H := C - F + 10;
+  H := D + 8 * H - D MOD 1;
+  IF D > A THEN G := D - 1 ELSE G := A / 3;
+  F := (E + D) * 10 MOD 1000;
+  C := E - E + 1;
+  D := F + 3 * B - F MOD 5;
+  IF B > A THEN C := B - 0 ELSE C := A / 1;
+  F := (A + C) * 3 MOD 1000;
+  G := C - B + 5;
+  A := G + 7 * G - G MOD 2;
+  IF H > B THEN B := H - 4 ELSE B := B / 2;
+  B := (F + H) * 7 MOD 1000;
+  H := F - C + 9;
+  F := F + 2 * H - F MOD 6;
+  IF C > C THEN A := C - 3 ELSE A := C / 3;
+  E := (F + E) * 11 MOD 1000;
+  G := A - C + 0;
+  C := E + 6 * A - E MOD 3;
+  IF G > H THEN A := G - 2 ELSE A := H / 1;
+  C := (B + A) * 4 MOD 1000;
+  H := D - D + 4;
+  G := E + 1 * F - E MOD 7;
+  IF A > B THEN G := A - 1 ELSE G := B / 2;
+  G := (F + A) * 8 MOD 1000;
+  H := D - E + 8;
+  C := B + 5 * F - B MOD 4;
+  IF G > F THEN D := G - 0 ELSE D := F / 3;
+  H := (B + A) * 1 MOD 1000;
+  C := E - G + 12;
+  H := C + 9 * C - C MOD 1;
+  IF H > C THEN A := H - 4 ELSE A := C / 1;
+  F := (D + G) * 5 MOD 1000;
+  H := B - H + 3;
+  F := A + 4 * C - A MOD 5;
+  IF H > A THEN A := H - 3 ELSE A := A / 2;
+  D := (H + A) * 9 MOD 1000;
+  G := H - D + 7;
+  D := B + 8 * C - B MOD 2;
+  IF H > G THEN E := H - 2 ELSE E := G / 3;
+  H := (B + B) * 2 MOD 1000;
+  G := A - C + 11;
+  A := H + 3 * H - H MOD 6;
+  IF A > F THEN D := A - 1 ELSE D := F / 1;
+  E := (D + A) * 6 MOD 1000;
+  C := A - H + 2;
+  B := C + 7 * F - C MOD 3;
+  IF E > D THEN B := E - 0 ELSE B := D / 2;
+  G := (H + A) * 10 MOD 1000;
+  D := A - D + 6;
+  A := E + 2 * H - E MOD 7;
+  IF E > H THEN E := E - 4 ELSE E := H / 3;
+  G := (E + D) * 3 MOD 1000;
+  A := A - F + 10;
+  A := A + 6 * F - A MOD 4;
+  IF H > A THEN G := H - 3 ELSE G := A / 1;
+  B := (H + B) * 7 MOD 1000;
+  A := B - F + 1;
+  H := F + 1 * G - F MOD 1;
+  IF H > D THEN G := H - 2 ELSE G := D / 2;
+  E := (H + C) * 11 MOD 1000;
+  B := H - F + 5;
+  F := F + 5 * B - F MOD 5;
+  IF B > B THEN B := B - 1 ELSE B := B / 3;
+  A := (A + H) * 4 MOD 1000;
+  A := F - F + 9;
+  D := B + 9 * A - B MOD 2;
+  IF D > D THEN D := D - 0 ELSE D := D / 1;
+  G := (A + D) * 8 MOD 1000;
+  C := H - B + 0;
+  D := H + 4 * H - H MOD 6;
+  IF E > E THEN D := E - 4 ELSE D := E / 2;
+  B := (B + F) * 1 MOD 1000;
+  A := G - H + 4;
+  H := C + 8 * F - C MOD 3;
+  IF D > D THEN B := D - 3 ELSE B := D / 3;
+  B := (F + D) * 5 MOD 1000;
+  G := B - G + 8;
+  D := D + 3 * C - D MOD 7;
+  IF H > E THEN B := H - 2 ELSE B := E / 1;
+  B := (C + A) * 9 MOD 1000;
+  C := F - H + 12;
+  D := E + 7 * D - E MOD 4;
+  IF H > H THEN E := H - 1 ELSE E := H / 2;
+  G := (E + G) * 2 MOD 1000;
+  D := C - E + 3;
+  C := A + 2 * E - A MOD 1;
+  IF D > G THEN D := D - 0 ELSE D := G / 3;
+  F := (D + H) * 6 MOD 1000;
+  D := G - E + 7;
+  H := E + 6 * A - E MOD 5;
+  IF H > F THEN A := H - 4 ELSE A := F / 1;
+  B := (C + G) * 10 MOD 1000;
+  C := B - D + 11;
+  F := H + 1 * A - H MOD 2;
+  IF A > A THEN D := A - 3 ELSE D := A / 2;
+  G := (B + D) * 3 MOD 1000;
+  B := H - G + 2;
+  F := G + 5 * A - G MOD 6;
+  IF A > D THEN C := A - 2 ELSE C := D / 3;
+  G := (F + D) * 7 MOD 1000;
+  D := H - E + 6;
+  H := B + 9 * C - B MOD 3;
+  IF F > D THEN A := F - 1 ELSE A := D / 1;
+  D := (G + H) * 11 MOD 1000;
+  A := F - F + 10;
+  D := E + 4 * C - E MOD 7;
+  IF H > D THEN D := H - 0 ELSE D := D / 2;
+  D := (D + H) * 4 MOD 1000;
+  F := D - F + 1;
+  F := A + 8 * G - A MOD 4;
+  IF B > H THEN G := B - 4 ELSE G := H / 3;
+  E := (G + F) * 8 MOD 1000;
+  B := H - E + 5;
+  D := H + 3 * B - H MOD 1;
+  IF H > F THEN D := H - 3 ELSE D := F / 1;
+  B := (D + C) * 1 MOD 1000;
+  G := E - H + 9;
+  A := A + 7 * H - A MOD 5;
+  IF C > F THEN B := C - 2 ELSE B := F / 2;
+  A := (C + D) * 5 MOD 1000;
+  G := C - F + 0;
+  F := F + 2 * G - F MOD 2;
+  IF D > A THEN H := D - 1 ELSE H := A / 3;
+  B := (D + F) * 9 MOD 1000;
+  F := H - A + 4;
+  G := C + 6 * A - C MOD 6;
+  IF E > A THEN D := E - 0 ELSE D := A / 1;
+  A := (H + E) * 2 MOD 1000;
+  B := D - D + 8;
+  G := C + 1 * F - C MOD 3;
+  IF A > F THEN B := A - 4 ELSE B := F / 2;
+  A := (F + E) * 6 MOD 1000;
+  D := E - A + 12;
+  B := H + 5 * G - H MOD 7;
+  IF D > G THEN B := D - 3 ELSE B := G / 3;
+  H := (G + G) * 10 MOD 1000;
+  B := B - F + 3;
+  F := F + 9 * C - F MOD 4;
+  IF D > B THEN C := D - 2 ELSE C := B / 1;
+  G := (H + H) * 3 MOD 1000;
+  E := C - A + 7;
+  F := E + 4 * B - E MOD 1;
+  IF B > D THEN G := B - 1 ELSE G := D / 2;
+  H := (B + C) * 7 MOD 1000;
+  E := H - B + 11;
+  A := A + 8 * D - A MOD 5;
+  IF E > C THEN F := E - 0 ELSE F := C / 3;
+  A := (A + B) * 11 MOD 1000;
+  D := B - C + 2;
+  F := A + 3 * H - A MOD 2;
+  IF G > E THEN H := G - 4 ELSE H := E / 1;
+  F := (B + A) * 4 MOD 1000;
+  C := A - D + 6;
+  E := F + 7 * D - F MOD 6;
+  IF H > H THEN H := H - 3 ELSE H := H / 2;
+  C := (D + E) * 8 MOD 1000;
+  F := D - B + 10;
+  E := B + 2 * E - B MOD 3;
+  IF G > D THEN E := G - 2 ELSE E := D / 3;
+  A := (B + H) * 1 MOD 1000;
+  F := G - A + 1;
+  C := B + 6 * D - B MOD 7;
+  IF B > C THEN G := B - 1 ELSE G := C / 1;
+  H := (G + C) * 5 MOD 1000;
+  C := D - B + 5;
+  H := F + 1 * D - F MOD 4;
+  IF F > F THEN C := F - 0 ELSE C := F / 2;
+  E := (D + B) * 9 MOD 1000;
+  A := B - H + 9;
+  H := F + 5 * A - F MOD 1;
+  IF B > B THEN D := B - 4 ELSE D := B / 3;
+  E := (E + A) * 2 MOD 1000;
+  C := E - D + 0;
+  C := G + 9 * F - G MOD 5;
+  IF C > G THEN F := C - 3 ELSE F := G / 1;
+  B := (E + H) * 6 MOD 1000;
+  D := B - E + 4;
+  D := H + 4 * E - H MOD 2;
+  IF D > G THEN D := D - 2 ELSE D := G / 2;
+  A := (C + H) * 10 MOD 1000;
+  F := C - C + 8;
+  C := B + 8 * F - B MOD 6;
+  IF E > C THEN E := E - 1 ELSE E := C / 3;
+  A := (E + C) * 3 MOD 1000;
+  F := D - H + 12;
+  E := B + 3 * C - B MOD 3;
+  IF B > E THEN D := B - 0 ELSE D := E / 1;
+  G := (D + G) * 7 MOD 1000;
+  D := C - B + 3;
+  B := D + 7 * E - D MOD 7;
+  IF B > C THEN C := B - 4 ELSE C := C / 2;
+  E := (B + H) * 11 MOD 1000;
+  F := B - A + 7;
+  E := F + 2 * H - F MOD 4;
+  IF G > B THEN C := G - 3 ELSE C := B / 3;
+  E := (C + F) * 4 MOD 1000;
+  C := G - B + 11;
+  B := D + 6 * C - D MOD 1;
+  IF B > C THEN B := B - 2 ELSE B := C / 1;
+  H := (H + B) * 8 MOD 1000;
+  G := A - A + 2;
+  C := A + 1 * F - A MOD 5;
+  IF A > H THEN F := A - 1 ELSE F := H / 2;
+  D := (H + H) * 1 MOD 1000;
+  E := G - F + 6;
+  H := G + 5 * F - G MOD 2;
+  IF G > E THEN B := G - 0 ELSE B := E / 3;
+  C := (E + E) * 5 MOD 1000;
+  D := H - D + 10;
+  D := F + 9 * C - F MOD 6;
+  IF B > C THEN H := B - 4 ELSE H := C / 1;
+  H := (B + D) * 9 MOD 1000;
+  G := B - H + 1;
+  C := G + 4 * G - G MOD 3;
+  IF H > A THEN C := H - 3 ELSE C := A / 2;
+  E := (G + F) * 2 MOD 1000;
+  F := F - H + 5;
+  F := D + 8 * D - D MOD 7;
+  IF F > A THEN H := F - 2 ELSE H := A / 3;
+  F := (F + G) * 6 MOD 1000;
+  A := H - D + 9;
+  E := E + 3 * G - E MOD 4;
+  IF B > C THEN H := B - 1 ELSE H := C / 1;
+  B := (D + B) * 10 MOD 1000;
+  G := G - G + 0;
+  G := A + 7 * B - A MOD 1;
+  IF A > F THEN F := A - 0 ELSE F := F / 2;
+  D := (B + C) * 3 MOD 1000;
+  F := F - B + 4;
+  A := A + 2 * H - A MOD 5;
+  IF E > C THEN G := E - 4 ELSE G := C / 3;
+  D := (H + C) * 7 MOD 1000;
+  A := G - E + 8;
+  C := C + 6 * G - C MOD 2;
+  IF D > G THEN E := D - 3 ELSE E := G / 1;
+  C := (G + C) * 11 MOD 1000;
+  A := E - D + 12;
+  F := C + 1 * G - C MOD 6;
+  IF H > G THEN G := H - 2 ELSE G := G / 2;
+  B := (D + E) * 4 MOD 1000;
+  C := B - E + 3;
+  A := E + 5 * A - E MOD 3;
+  IF A > C THEN H := A - 1 ELSE H := C / 3;
+  F := (A + F) * 8 MOD 1000;
+  A := D - B + 7;
+  G := G + 9 * B - G MOD 7;
+  IF C > A THEN A := C - 0 ELSE A := A / 1;
+  C := (A + G) * 1 MOD 1000;
+  G := G - A + 11;
+  H := G + 4 * E - G MOD 4;
+  IF F > B THEN A := F - 4 ELSE A := B / 2;
+  F := (E + G) * 5 MOD 1000;
+  G := B - B + 2;
+  E := B + 8 * C - B MOD 1;
+  IF D > C THEN A := D - 3 ELSE A := C / 3;
+  G := (H + C) * 9 MOD 1000;
+  G := H - G + 6;
+  H := F + 3 * F - F MOD 5;
+  IF E > H THEN E := E - 2 ELSE E := H / 1;
+  C := (B + G) * 2 MOD 1000;
+  H := D - H + 10;
+  D := D + 7 * A - D MOD 2;
+  IF H > H THEN B := H - 1 ELSE B := H / 2;
+  B := (D + C) * 6 MOD 1000;
+  F := C - G + 1;
+  B := G + 2 * A - G MOD 6;
+  IF F > A THEN C := F - 0 ELSE C := A / 3;
+  H := (B + B) * 10 MOD 1000;
+  F := B - G + 5;
+  B := C + 6 * A - C MOD 3;
+  IF A > H THEN G := A - 4 ELSE G := H / 1;
+  E := (H + C) * 3 MOD 1000;
+  A := C - G + 9;
+  C := C + 1 * G - C MOD 7;
+  IF A > G THEN F := A - 3 ELSE F := G / 2;
+  E := (F + D) * 7 MOD 1000;
+  E := H - E + 0;
+  E := B + 5 * A - B MOD 4;
+  IF B > F THEN C := B - 2 ELSE C := F / 3;
+  F := (C + F) * 11 MOD 1000;
+  E := H - A + 4;
+  C := B + 9 * H - B MOD 1;
+  IF A > C THEN B := A - 1 ELSE B := C / 1;
+  C := (E + E) * 4 MOD 1000;
+  B := E - A + 8;
+  F := B + 4 * C - B MOD 5;
+  IF H > C THEN E := H - 0 ELSE E := C / 2;
+  H := (F + A) * 8 MOD 1000;
+  F := D - C + 12;
+  D := G + 8 * A - G MOD 2;
+  IF D > G THEN A := D - 4 ELSE A := G / 3;
+  E := (H + C) * 1 MOD 1000;
+  A := A - H + 3;
+  F := F + 3 * E - F MOD 6;
+  IF G > F THEN C := G - 3 ELSE C := F / 1;
+  A := (C + D) * 5 MOD 1000;
+  F := F - C + 7;
+  B := B + 7 * C - B MOD 3;
+  IF D > H THEN E := D - 2 ELSE E := H / 2;
+  B := (G + B) * 9 MOD 1000;
+  F := E - G + 11;
+  G := D + 2 * C - D MOD 7;
+  IF G > F THEN H := G - 1 ELSE H := F / 3;
+  A := (C + E) * 2 MOD 1000;
+  A := D - D + 2;
+  D := C + 6 * H - C MOD 4;
+  IF H > A THEN H := H - 0 ELSE H := A / 1;
+  F := (D + B) * 6 MOD 1000;
+  A := D - H + 6;
+  H := E + 1 * A - E MOD 1;
+  IF E > F THEN D := E - 4 ELSE D := F / 2;
+  A := (H + F) * 10 MOD 1000;
+  B := G - H + 10;
+  C := G + 5 * H - G MOD 5;
+  IF G > E THEN E := G - 3 ELSE E := E / 3;
+  C := (H + F) * 3 MOD 1000;
+  D := D - G + 1;
+  F := H + 9 * H - H MOD 2;
+  IF D > B THEN B := D - 2 ELSE B := B / 1;
+  E := (E + H) * 7 MOD 1000;
+  A := H - E + 5;
+  F := G + 4 * H - G MOD 6;
+  IF H > F THEN B := H - 1 ELSE B := F / 2;
+  D := (E + F) * 11 MOD 1000;
+  G := D - A + 9;
+  C := A + 8 * G - A MOD 3;
+  IF F > H THEN D := F - 0 ELSE D := H / 3;
+  B := (D + F) * 4 MOD 1000;
+  A := F - C + 0;
+  H := F + 3 * F - F MOD 7;
+  IF H > A THEN A := H - 4 ELSE A := A / 1;
+  F := (E + H) * 8 MOD 1000;
+  C := F - D + 4;
+  E := D + 7 * B - D MOD 4;
+  IF H > F THEN F := H - 3 ELSE F := F / 2;
+  E := (D + D) * 1 MOD 1000;
+  A := E - F + 8;
+  H := D + 2 * C - D MOD 1;
+  IF B > B THEN C := B - 2 ELSE C := B / 3;
+  E := (E + G) * 5 MOD 1000;
+  H := A - H + 12;
+  G := B + 6 * G - B MOD 5;
+  IF F > C THEN E := F - 1 ELSE E := C / 1;
+  G := (G + F) * 9 MOD 1000;
+  E := B - E + 3;
+  A := G + 1 * B - G MOD 2;
+  IF C > B THEN A := C - 0 ELSE A := B / 2;
+  G := (D + E) * 2 MOD 1000;
+  D := B - D + 7;
+  G := B + 5 * D - B MOD 6;
+  IF B > F THEN H := B - 4 ELSE H := F / 3;
+  B := (C + A) * 6 MOD 1000;
+  B := E - F + 11;
+  A := B + 9 * H - B MOD 3;
+  IF E > F THEN G := E - 3 ELSE G := F / 1;
+  B := (G + F) * 10 MOD 1000;
+  B := B - H + 2;
+  G := C + 4 * B - C MOD 7;
+  IF A > D THEN G := A - 2 ELSE G := D / 2;
+  H := (H + D) * 3 MOD 1000;
+  F := B - F + 6;
+  B := B + 8 * D - B MOD 4;
+  IF F > C THEN F := F - 1 ELSE F := C / 3;
+  F := (A + H) * 7 MOD 1000;
+  B := C - B + 10;
+  A := D + 3 * G - D MOD 1;
+  IF D > D THEN H := D - 0 ELSE H := D / 1;
+  G := (D + H) * 11 MOD 1000;
+  G := C - E + 1;
+  G := B + 7 * F - B MOD 5;
+  IF B > H THEN D := B - 4 ELSE D := H / 2;
+  D := (G + G) * 4 MOD 1000;
+  E := A - A + 5;
+  E := A + 2 * D - A MOD 2;
+  IF F > C THEN G := F - 3 ELSE G := C / 3;
+  F := (H + C) * 8 MOD 1000;
+  A := D - A + 9;
+  H := B + 6 * B - B MOD 6;
+  IF F > B THEN D := F - 2 ELSE D := B / 1;
+  A := (H + C) * 1 MOD 1000;
+  H := A - F + 0;
+  E := B + 1 * F - B MOD 3;
+  IF G > B THEN H := G - 1 ELSE H := B / 2;
+  C := (G + F) * 5 MOD 1000;
+  A := E - G + 4;
+  H := E + 5 * G - E MOD 7;
+  IF C > H THEN F := C - 0 ELSE F := H / 3;
+  E := (G + A) * 9 MOD 1000;
+  G := H - A + 8;
+  H := C + 9 * G - C MOD 4;
+  IF G > G THEN B := G - 4 ELSE B := G / 1;
+  B := (B + B) * 2 MOD 1000;
+  B := F - A + 12;
+  G := B + 4 * D - B MOD 1;
+  IF E > H THEN F := E - 3 ELSE F := H / 2;
+  G := (F + C) * 6 MOD 1000;
+  B := D - C + 3;
+  B := H + 8 * B - H MOD 5;
+  IF A > G THEN A := A - 2 ELSE A := G / 3;
+  H := (G + E) * 10 MOD 1000;
+  H := A - D + 7;
+  B := D + 3 * F - D MOD 2;
+  IF B > E THEN G := B - 1 ELSE G := E / 1;
+  C := (D + D) * 3 MOD 1000;
+  H := A - E + 11;
+  A := B + 7 * D - B MOD 6;
+  IF A > A THEN E := A - 0 ELSE E := A / 2;
+  A := (F + A) * 7 MOD 1000;
+  D := C - B + 2;
+  D := C + 2 * A - C MOD 3;
+  IF H > B THEN C := H - 4 ELSE C := B / 3;
+  F := (A + E) * 11 MOD 1000;
+  G := D - G + 6;
+  H := B + 6 * F - B MOD 7;
+  IF E > G THEN F := E - 3 ELSE F := G / 1;
+  E := (B + E) * 4 MOD 1000;
+  E := C - D + 10;
+  H := F + 1 * A - F MOD 4;
+  IF A > G THEN C := A - 2 ELSE C := G / 2;
+  A := (C + A) * 8 MOD 1000;
+  C := C - F + 1;
+  F := A + 5 * A - A MOD 1;
+  IF A > D THEN C := A - 1 ELSE C := D / 3;
+  E := (F + E) * 1 MOD 1000;
+  A := F - F + 5;
+  C := A + 9 * A - A MOD 5;
+  IF E > D THEN F := E - 0 ELSE F := D / 1;
+  D := (E + G) * 5 MOD 1000;
+  B := H - D + 9;
+  D := H + 4 * A - H MOD 2;
+  IF C > D THEN G := C - 4 ELSE G := D / 2;
+  G := (A + A) * 9 MOD 1000;
+  B := C - F + 0;
+  G := B + 8 * F - B MOD 6;
+  IF B > A THEN E := B - 3 ELSE E := A / 3;
+  D := (F + F) * 2 MOD 1000;
+  E := A - H + 4;
+  D := F + 3 * F - F MOD 3;
+  IF G > C THEN C := G - 2 ELSE C := C / 1;
+  D := (D + F) * 6 MOD 1000;
+  A := G - C + 8;
+  A := F + 7 * A - F MOD 7;
+  IF F > A THEN G := F - 1 ELSE G := A / 2;
+  H := (E + G) * 10 MOD 1000;
+  G := F - C + 12;
+  B := H + 2 * A - H MOD 4;
+  IF F > A THEN D := F - 0 ELSE D := A / 3;
+  B := (B + G) * 3 MOD 1000;
+  D := E - D + 3;
+  F := B + 6 * B - B MOD 1;
+  IF E > G THEN C := E - 4 ELSE C := G / 1;
+  D := (G + G) * 7 MOD 1000;
+  D := D - G + 7;
+  B := C + 1 * D - C MOD 5;
+  IF F > F THEN H := F - 3 ELSE H := F / 2;
+  F := (A + B) * 11 MOD 1000;
+  G := F - G + 11;
+  F := F + 5 * C - F MOD 2;
+  IF A > E THEN H := A - 2 ELSE H := E / 3;
+  H := (H + A) * 4 MOD 1000;
+  F := B - E + 2;
+  A := E + 9 * H - E MOD 6;
+  IF E > C THEN F := E - 1 ELSE F := C / 1;
+  D := (F + D) * 8 MOD 1000;
+  G := E - G + 6;
+  E := D + 4 * G - D MOD 3;
+  IF C > E THEN E := C - 0 ELSE E := E / 2;
+  A := (E + E) * 1 MOD 1000;
+  D := H - B + 10;
+  F := B + 8 * D - B MOD 7;
+  IF E > E THEN E := E - 4 ELSE E := E / 3;
+  D := (F + C) * 5 MOD 1000;
+  G := E - C + 1;
+  G := G + 3 * F - G MOD 4;
+  IF H > G THEN A := H - 3 ELSE A := G / 1;
+  E := (G + B) * 9 MOD 1000;
+  F := A - B + 5;
+  E := A + 7 * A - A MOD 1;
+  IF H > E THEN B := H - 2 ELSE B := E / 2;
+  A := (E + A) * 2 MOD 1000;
+  H := B - A + 9;
+  F := D + 2 * E - D MOD 5;
+  IF G > A THEN C := G - 1 ELSE C := A / 3;
+  E := (C + B) * 6 MOD 1000;
+  C := C - E + 0;
+  G := A + 6 * E - A MOD 2;
+  IF H > A THEN G := H - 0 ELSE G := A / 1;
+  B := (H + F) * 10 MOD 1000;
+  A := E - G + 4;
+  C := E + 1 * D - E MOD 6;
+  IF G > H THEN F := G - 4 ELSE F := H / 2;
+  C := (A + E) * 3 MOD 1000;
+  B := D - D + 8;
+  C := H + 5 * F - H MOD 3;
+  IF B > H THEN G := B - 3 ELSE G := H / 3;
+  H := (A + E) * 7 MOD 1000;
+  G := A - H + 12;
+  A := E + 9 * D - E MOD 7;
+  IF H > A THEN A := H - 2 ELSE A := A / 1;
+  A := (D + A) * 11 MOD 1000;
+  F := G - H + 3;
+  E := B + 4 * D - B MOD 4;
+  IF F > F THEN F := F - 1 ELSE F := F / 2;
+  A := (D + C) * 4 MOD 1000;
+  B := H - D + 7;
+  B := G + 8 * B - G MOD 1;
+  IF F > F THEN F := F - 0 ELSE F := F / 3;
+  D := (E + G) * 8 MOD 1000;
+  C := H - B + 11;
+  H := B + 3 * F - B MOD 5;
+  IF C > H THEN F := C - 4 ELSE F := H / 1;
+  E := (B + C) * 1 MOD 1000;
+  A := F - B + 2;
+  D := H + 7 * D - H MOD 2;
+  IF G > H THEN G := G - 3 ELSE G := H / 2;
+  F := (H + D) * 5 MOD 1000;
+  D := D - G + 6;
+  B := A + 2 * E - A MOD 6;
+  IF G > H THEN D := G - 2 ELSE D := H / 3;
+  A := (C + A) * 9 MOD 1000;
+  G := E - H + 10;
+  F := C + 6 * F - C MOD 3;
+  IF D > D THEN D := D - 1 ELSE D := D / 1;
+  D := (E + E) * 2 MOD 1000;
+  G := D - H + 1;
+  A := B + 1 * G - B MOD 7;
+  IF B > E THEN A := B - 0 ELSE A := E / 2;
+  B := (E + F) * 6 MOD 1000;
+  D := D - C + 5;
+  D := G + 5 * E - G MOD 4;
+  IF C > G THEN H := C - 4 ELSE H := G / 3;
+  A := (A + D) * 10 MOD 1000;
+  H := A - C + 9;
+  C := C + 9 * B - C MOD 1;
+  IF F > C THEN H := F - 3 ELSE H := C / 1;
+  F := (E + A) * 3 MOD 1000;
+  G := D - B + 0;
+  G := F + 4 * C - F MOD 5;
+  IF B > D THEN H := B - 2 ELSE H := D / 2;
+  F := (G + D) * 7 MOD 1000;
+  F := A - A + 4;
+  A := D + 8 * B - D MOD 2;
+  IF D > D THEN D := D - 1 ELSE D := D / 3;
+  G := (G + G) * 11 MOD 1000;
+  D := F - E + 8;
+  E := B + 3 * F - B MOD 6;
+  IF C > F THEN D := C - 0 ELSE D := F / 1;
+  D := (E + A) * 4 MOD 1000;
+  F := E - D + 12;
+  D := C + 7 * F - C MOD 3;
+  IF F > B THEN G := F - 4 ELSE G := B / 2;
+  G := (D + E) * 8 MOD 1000;
+  F := E - C + 3;
+  B := H + 2 * C - H MOD 7;
+  IF D > H THEN B := D - 3 ELSE B := H / 3;
+  B := (C + E) * 1 MOD 1000;
+  B := H - D + 7;
+  A := A + 6 * B - A MOD 4;
+  IF B > E THEN F := B - 2 ELSE F := E / 1;
+  B := (F + D) * 5 MOD 1000;
+  H := H - D + 11;
+  D := F + 1 * B - F MOD 1;
+  IF A > D THEN E := A - 1 ELSE E := D / 2;
+  A := (F + B) * 9 MOD 1000;
+  B := B - D + 2;
+  D := C + 5 * H - C MOD 5;
+  IF F > G THEN A := F - 0 ELSE A := G / 3;
+  D := (E + D) * 2 MOD 1000;
+  D := F - H + 6;
+  A := A + 9 * A - A MOD 2;
+  IF A > B THEN C := A - 4 ELSE C := B / 1;
+  C := (A + E) * 6 MOD 1000;
+  G := B - A + 10;
+  A := E + 4 * E - E MOD 6;
+  IF H > F THEN G := H - 3 ELSE G := F / 2;
+  C := (G + A) * 10 MOD 1000;
+  E := E - D + 1;
+  F := E + 8 * A - E MOD 3;
+  IF B > B THEN D := B - 2 ELSE D := B / 3;
+  E := (A + G) * 3 MOD 1000;
+  C := H - F + 5;
+  D := F + 3 * D - F MOD 7;
+  IF B > G THEN C := B - 1 ELSE C := G / 1;
+  B := (G + D) * 7 MOD 1000;
+  F := A - A + 9;
+  H := G + 7 * C - G MOD 4;
+  IF F > E THEN F := F - 0 ELSE F := E / 2;
+  A := (E + B) * 11 MOD 1000;
+  H := A - C + 0;
+  F := E + 2 * F - E MOD 1;
+  IF H > H THEN D := H - 4 ELSE D := H / 3;
+  B := (F + B) * 4 MOD 1000;
+  D := B - E + 4;
+  H := H + 6 * H - H MOD 5;
+  IF E > E THEN D := E - 3 ELSE D := E / 1;
+  F := (A + G) * 8 MOD 1000;
+  C := A - G + 8;
+  C := G + 1 * C - G MOD 2;
+  IF D > A THEN G := D - 2 ELSE G := A / 2;
+  E := (G + C) * 1 MOD 1000;
+  B := H - D + 12;
+  A := G + 5 * B - G MOD 6;
+  IF B > H THEN H := B - 1 ELSE H := H / 3;
+  B := (A + B) * 5 MOD 1000;
+  E := A - D + 3;
+  G := B + 9 * E - B MOD 3;
+  IF F > H THEN D := F - 0 ELSE D := H / 1;
+  A := (F + C) * 9 MOD 1000;
+  B := D - A + 7;
+  A := H + 4 * D - H MOD 7;
+  IF A > C THEN H := A - 4 ELSE H := C / 2;
+  D := (G + E) * 2 MOD 1000;
+  E := A - G + 11;
+  A := E + 8 * H - E MOD 4;
+  IF A > D THEN D := A - 3 ELSE D := D / 3;
+  D := (G + C) * 6 MOD 1000;
+  B := E - G + 2;
+  H := D + 3 * A - D MOD 1;
+  IF H > G THEN E := H - 2 ELSE E := G / 1;
+  E := (B + B) * 10 MOD 1000;
+  D := F - G + 6;
+  H := F + 7 * G - F MOD 5;
+  IF C > G THEN C := C - 1 ELSE C := G / 2;
+  B := (B + B) * 3 MOD 1000;
+  C := G - H + 10;
+  G := F + 2 * B - F MOD 2;
+  IF A > H THEN C := A - 0 ELSE C := H / 3;
+  D := (G + D) * 7 MOD 1000;
+  F := D - E + 1;
+  F := C + 6 * C - C MOD 6;
+  IF G > C THEN G := G - 4 ELSE G := C / 1;
+  G := (C + G) * 11 MOD 1000;
+  F := G - D + 5;
+  E := F + 1 * C - F MOD 3;
+  IF A > F THEN F := A - 3 ELSE F := F / 2;
+  A := (G + E) * 4 MOD 1000;
+  F := H - C + 9;
+  B := B + 5 * A - B MOD 7;
+  IF A > H THEN E := A - 2 ELSE E := H / 3;
+  C := (H + B) * 8 MOD 1000;
+  G := H - B + 0;
+  G := C + 9 * A - C MOD 4;
+  IF C > E THEN D := C - 1 ELSE D := E / 1;
+  F := (A + D) * 1 MOD 1000;
+  H := D - E + 4;
+  A := F + 4 * B - F MOD 1;
+  IF G > H THEN B := G - 0 ELSE B := H / 2;
+  C := (H + E) * 5 MOD 1000;
+  C := A - E + 8;
+  H := B + 8 * C - B MOD 5;
+  IF D > D THEN D := D - 4 ELSE D := D / 3;
+  E := (F + A) * 9 MOD 1000;
+  G := A - F + 12;
+  G := A + 3 * G - A MOD 2;
+  IF D > C THEN G := D - 3 ELSE G := C / 1;
+  C := (B + B) * 2 MOD 1000;
+  D := E - F + 3;
+  A := G + 7 * D - G MOD 6;
+  IF A > F THEN H := A - 2 ELSE H := F / 2;
+  D := (F + H) * 6 MOD 1000;
+  B := E - B + 7;
+  G := G + 2 * D - G MOD 3;
+  IF E > E THEN E := E - 1 ELSE E := E / 3;
+  B := (H + C) * 10 MOD 1000;
+  C := H - E + 11;
+  B := A + 6 * H - A MOD 7;
+  IF H > E THEN F := H - 0 ELSE F := E / 1;
+  A := (G + E) * 3 MOD 1000;
+  A := D - E + 2;
+  A := G + 1 * D - G MOD 4;
+  IF A > D THEN D := A - 4 ELSE D := D / 2;
+  H := (B + B) * 7 MOD 1000;
+  H := A - H + 6;
+  D := G + 5 * B - G MOD 1;
+  IF B > H THEN H := B - 3 ELSE H := H / 3;
+  A := (G + C) * 11 MOD 1000;
+  D := C - B + 10;
+  H := C + 9 * B - C MOD 5;
+  IF D > B THEN C := D - 2 ELSE C := B / 1;
+  F := (H + H) * 4 MOD 1000;
+  A := G - G + 1;
+  G := F + 4 * D - F MOD 2;
+  IF G > D THEN B := G - 1 ELSE B := D / 2;
+  D := (F + H) * 8 MOD 1000;
+  A := F - G + 5;
+  D := A + 8 * H - A MOD 6;
+  IF A > F THEN E := A - 0 ELSE E := F / 3;
+  B := (D + D) * 1 MOD 1000;
+  D := G - B + 9;
+  H := A + 3 * E - A MOD 3;
+  IF A > B THEN A := A - 4 ELSE A := B / 1;
+  A := (E + A) * 5 MOD 1000;
+  B := A - H + 0;
+  A := E + 7 * E - E MOD 7;
+  IF B > B THEN H := B - 3 ELSE H := B / 2;
+  H := (A + C) * 9 MOD 1000;
+  C := D - B + 4;
+  C := C + 2 * E - C MOD 4;
+  IF F > E THEN A := F - 2 ELSE A := E / 3;
+  E := (H + F) * 2 MOD 1000;
+  C := D - D + 8;
+  A := D + 6 * H - D MOD 1;
+  IF B > G THEN E := B - 1 ELSE E := G / 1;
+  D := (H + C) * 6 MOD 1000;
+  H := A - B + 12;
+  F := C + 1 * B - C MOD 5;
+  IF G > H THEN B := G - 0 ELSE B := H / 2;
+  D := (D + F) * 10 MOD 1000;
+  G := D - F + 3;
+  G := H + 5 * G - H MOD 2;
+  IF B > F THEN G := B - 4 ELSE G := F / 3;
+  B := (F + F) * 3 MOD 1000;
+  E := G - G + 7;
+  F := H + 9 * E - H MOD 6;
+  IF C > F THEN A := C - 3 ELSE A := F / 1;
+  C := (G + D) * 7 MOD 1000;
+  G := E - G + 11;
+  H := F + 4 * E - F MOD 3;
+  IF C > B THEN A := C - 2 ELSE A := B / 2;
+  G := (C + G) * 11 MOD 1000;
+  D := B - H + 2;
+  C := B + 8 * A - B MOD 7;
+  IF D > B THEN F := D - 1 ELSE F := B / 3;
+  F := (D + G) * 4 MOD 1000;
+  G := G - G + 6;
+  E := C + 3 * E - C MOD 4;
+  IF H > E THEN E := H - 0 ELSE E := E / 1;
+  C := (C + A) * 8 MOD 1000;
+  C := F - G + 10;
+  F := G + 7 * C - G MOD 1;
+  IF A > F THEN G := A - 4 ELSE G := F / 2;
+  B := (B + G) * 1 MOD 1000;
+  F := B - C + 1;
+  A := D + 2 * E - D MOD 5;
+  IF A > D THEN F := A - 3 ELSE F := D / 3;
+  G := (F + E) * 5 MOD 1000;
+  B := D - G + 5;
+  D := D + 6 * A - D MOD 2;
+  IF E > D THEN H := E - 2 ELSE H := D / 1;
+  D := (H + A) * 9 MOD 1000;
+  H := B - A + 9;
+  G := B + 1 * C - B MOD 6;
+  IF G > C THEN B := G - 1 ELSE B := C / 2;
+  D := (D + E) * 2 MOD 1000;
+  H := C - B + 0;
+  F := H + 5 * A - H MOD 3;
+  IF A > G THEN H := A - 0 ELSE H := G / 3;
+  C := (G + C) * 6 MOD 1000;
+  C := E - C + 4;
+  F := G + 9 * C - G MOD 7;
+  IF A > D THEN B := A - 4 ELSE B := D / 1;
+  C := (G + A) * 10 MOD 1000;
+  E := C - C + 8;
+  B := A + 4 * E - A MOD 4;
+  IF A > A THEN H := A - 3 ELSE H := A / 2;
+  F := (G + E) * 3 MOD 1000;
+  A := C - C + 12;
+  A := A + 8 * A - A MOD 1;
+  IF A > A THEN B := A - 2 ELSE B := A / 3;
+  H := (F + A) * 7 MOD 1000;
+  H := A - H + 3;
+  E := A + 3 * D - A MOD 5;
+  IF E > G THEN E := E - 1 ELSE E := G / 1;
+  H := (D + G) * 11 MOD 1000;
+  A := E - F + 7;
+  E := H + 7 * D - H MOD 2;
+  IF G > F THEN G := G - 0 ELSE G := F / 2;
+  B := (C + B) * 4 MOD 1000;
+  G := H - F + 11;
+  C := H + 2 * B - H MOD 6;
+  IF F > F THEN E := F - 4 ELSE E := F / 3;
+  G := (B + B) * 8 MOD 1000;
+  D := H - H + 2;
+  D := G + 6 * D - G MOD 3;
+  IF C > C THEN B := C - 3 ELSE B := C / 1;
+  F := (A + E) * 1 MOD 1000;
+  B := H - B + 6;
+  E := F + 1 * D - F MOD 7;
+  IF G > G THEN G := G - 2 ELSE G := G / 2;
+  C := (H + C) * 5 MOD 1000;
+  B := E - A + 10;
+  A := D + 5 * H - D MOD 4;
+  IF F > D THEN B := F - 1 ELSE B := D / 3;
+  G := (G + F) * 9 MOD 1000;
+  B := F - B + 1;
+  H := G + 9 * B - G MOD 1;
+  IF E > F THEN E := E - 0 ELSE E := F / 1;
+  B := (E + B) * 2 MOD 1000;
+  D := G - B + 5;
+  G := C + 4 * E - C MOD 5;
+  IF G > F THEN A := G - 4 ELSE A := F / 2;
+  A := (D + D) * 6 MOD 1000;
+  C := E - D + 9;
+  A := B + 8 * A - B MOD 2;
+  IF B > B THEN E := B - 3 ELSE E := B / 3;
+  B := (B + C) * 10 MOD 1000;
+  H := B - C + 0;
+  D := C + 3 * G - C MOD 6;
+  IF F > F THEN A := F - 2 ELSE A := F / 1;
+  C := (B + G) * 3 MOD 1000;
+  G := B - E + 4;
+  F := H + 7 * C - H MOD 3;
+  IF D > A THEN H := D - 1 ELSE H := A / 2;
+  B := (D + G) * 7 MOD 1000;
+  A := C - B + 8;
+  F := B + 2 * C - B MOD 7;
+  IF A > A THEN E := A - 0 ELSE E := A / 3;
+  F := (D + A) * 11 MOD 1000;
+  H := F - G + 12;
+  C := F + 6 * F - F MOD 4;
+  IF D > E THEN A := D - 4 ELSE A := E / 1;
+  F := (H + B) * 4 MOD 1000;
+  F := H - D + 3;
+  D := B + 1 * C - B MOD 1;
+  IF B > D THEN F := B - 3 ELSE F := D / 2;
+  G := (A + A) * 8 MOD 1000;
+  G := B - A + 7;
+  C := E + 5 * D - E MOD 5;
+  IF H > A THEN H := H - 2 ELSE H := A / 3;
+  A := (A + G) * 1 MOD 1000;
+  D := D - E + 11;
+  F := G + 9 * B - G MOD 2;
+  IF H > E THEN C := H - 1 ELSE C := E / 1;
+  D := (E + B) * 5 MOD 1000;
+  G := A - B + 2;
+  B := C + 4 * F - C MOD 6;
+  IF E > B THEN C := E - 0 ELSE C := B / 2;
+  A := (D + H) * 9 MOD 1000;
+  A := C - C + 6;
+  G := E + 8 * C - E MOD 3;
+  IF D > E THEN F := D - 4 ELSE F := E / 3;
+  F := (G + E) * 2 MOD 1000;
+  A := F - D + 10;
+  D := A + 3 * A - A MOD 7;
+  IF G > B THEN A := G - 3 ELSE A := B / 1;
+  G := (A + C) * 6 MOD 1000;
+  G := C - B + 1;
+  E := E + 7 * A - E MOD 4;
+  IF C > E THEN E := C - 2 ELSE E := E / 2;
+  E := (D + D) * 10 MOD 1000;
+  E := C - C + 5;
+  A := H + 2 * H - H MOD 1;
+  IF F > B THEN C := F - 1 ELSE C := B / 3;
+  H := (G + D) * 3 MOD 1000;
+  B := F - H + 9;
+  G := H + 6 * A - H MOD 5;
+  IF B > B THEN C := B - 0 ELSE C := B / 1;
+  G := (F + D) * 7 MOD 1000;
+  G := H - D + 0;
+  A := D + 1 * D - D MOD 2;
+  IF E > D THEN D := E - 4 ELSE D := D / 2;
+  A := (C + B) * 11 MOD 1000;
+  D := G - H + 4;
+  D := C + 5 * B - C MOD 6;
+  IF A > D THEN D := A - 3 ELSE D := D / 3;
+  C := (B + C) * 4 MOD 1000;
+  H := E - G + 8;
+  B := A + 9 * H - A MOD 3;
+  IF E > A THEN G := E - 2 ELSE G := A / 1;
+  A := (E + F) * 8 MOD 1000;
+  G := C - F + 12;
+  A := D + 4 * A - D MOD 7;
+  IF B > F THEN H := B - 1 ELSE H := F / 2;
+  H := (A + F) * 1 MOD 1000;
+  D := D - D + 3;
+  B := E + 8 * C - E MOD 4;
+  IF C > E THEN A := C - 0 ELSE A := E / 3;
+  E := (G + H) * 5 MOD 1000;
+  A := B - D + 7;
+  D := G + 3 * G - G MOD 1;
+  IF G > E THEN E := G - 4 ELSE E := E / 1;
+  D := (D + C) * 9 MOD 1000;
+  E := A - A + 11;
+  A := G + 7 * H - G MOD 5;
+  IF F > A THEN A := F - 3 ELSE A := A / 2;
+  A := (F + D) * 2 MOD 1000;
+  B := H - F + 2;
+  F := H + 2 * H - H MOD 2;
+  IF A > A THEN D := A - 2 ELSE D := A / 3;
+  D := (E + H) * 6 MOD 1000;
+  E := G - H + 6;
+  F := E + 6 * A - E MOD 6;
+  IF G > D THEN D := G - 1 ELSE D := D / 1;
+  H := (E + B) * 10 MOD 1000;
+  F := H - E + 10;
+  G := B + 1 * H - B MOD 3;
+  IF H > C THEN G := H - 0 ELSE G := C / 2;
+  H := (F + G) * 3 MOD 1000;
+  G := B - H + 1;
+  C := A + 5 * E - A MOD 7;
+  IF H > C THEN D := H - 4 ELSE D := C / 3;
+  D := (H + G) * 7 MOD 1000;
+  E := F - C + 5;
+  G := F + 9 * H - F MOD 4;
+  IF E > C THEN H := E - 3 ELSE H := C / 1;
+  B := (E + G) * 11 MOD 1000;
+  B := H - A + 9;
+  G := E + 4 * A - E MOD 1;
+  IF B > H THEN H := B - 2 ELSE H := H / 2;
+  E := (E + G) * 4 MOD 1000;
+  A := D - B + 0;
+  G := F + 8 * F - F MOD 5;
+  IF C > C THEN G := C - 1 ELSE G := C / 3;
+  D := (C + F) * 8 MOD 1000;
+  H := F - A + 4;
+  D := D + 3 * F - D MOD 2;
+  IF H > E THEN D := H - 0 ELSE D := E / 1;
+  C := (H + F) * 1 MOD 1000;
+  D := E - B + 8;
+  G := C + 7 * C - C MOD 6;
+  IF A > B THEN F := A - 4 ELSE F := B / 2;
+  G := (G + G) * 5 MOD 1000;
+  G := B - F + 12;
+  G := C + 2 * F - C MOD 3;
+  IF C > G THEN D := C - 3 ELSE D := G / 3;
+  B := (D + E) * 9 MOD 1000;
+  G := A - E + 3;
+  H := D + 6 * F - D MOD 7;
+  IF B > F THEN C := B - 2 ELSE C := F / 1;
+  B := (D + A) * 2 MOD 1000;
+  D := E - F + 7;
+  A := H + 1 * C - H MOD 4;
+  IF B > F THEN A := B - 1 ELSE A := F / 2;
+  D := (B + C) * 6 MOD 1000;
+  B := E - H + 11;
+  H := E + 5 * H - E MOD 1;
+  IF A > A THEN E := A - 0 ELSE E := A / 3;
+  B := (E + F) * 10 MOD 1000;
+  H := B - H + 2;
+  G := H + 9 * B - H MOD 5;
+  IF H > G THEN H := H - 4 ELSE H := G / 1;
+  C := (A + B) * 3 MOD 1000;
+  E := G - D + 6;
+  D := B + 4 * C - B MOD 2;
+  IF H > B THEN B := H - 3 ELSE B := B / 2;
+  E := (G + G) * 7 MOD 1000;
+  B := A - B + 10;
+  C := H + 8 * A - H MOD 6;
+  IF H > F THEN E := H - 2 ELSE E := F / 3;
+  C := (E + G) * 11 MOD 1000;
+  C := G - F + 1;
+  B := E + 3 * C - E MOD 3;
+  IF A > D THEN B := A - 1 ELSE B := D / 1;
+  D := (D + F) * 4 MOD 1000;
+  G := B - E + 5;
+  F := H + 7 * G - H MOD 7;
+  IF E > E THEN F := E - 0 ELSE F := E / 2;
+  H := (D + B) * 8 MOD 1000;
+  B := E - D + 9;
+  D := G + 2 * B - G MOD 4;
+  IF G > D THEN D := G - 4 ELSE D := D / 3;
+  E := (H + B) * 1 MOD 1000;
+  A := D - E + 0;
+  H := E + 6 * B - E MOD 1;
+  IF C > C THEN H := C - 3 ELSE H := C / 1;
+  G := (F + B) * 5 MOD 1000;
+  H := D - G + 4;
+  D := F + 1 * E - F MOD 5;
+  IF C > C THEN D := C - 2 ELSE D := C / 2;
+  E := (E + A) * 9 MOD 1000;
+  G := D - H + 8;
+  G := B + 5 * A - B MOD 2;
+  IF G > F THEN D := G - 1 ELSE D := F / 3;
+  D := (A + A) * 2 MOD 1000;
+  F := F - D + 12;
+  G := E + 9 * C - E MOD 6;
+  IF D > F THEN A := D - 0 ELSE A := F / 1;
+  F := (E + F) * 6 MOD 1000;
+  E := A - B + 3;
+  C := B + 4 * G - B MOD 3;
+  IF C > B THEN C := C - 4 ELSE C := B / 2;
+  C := (B + F) * 10 MOD 1000;
+  B := F - C + 7;
+  G := H + 8 * F - H MOD 7;
+  IF E > D THEN F := E - 3 ELSE F := D / 3;
+  C := (C + G) * 3 MOD 1000;
+  F := C - B + 11;
+  E := A + 3 * D - A MOD 4;
+  IF B > B THEN B := B - 2 ELSE B := B / 1;
+  E := (D + C) * 7 MOD 1000;
+  B := E - C + 2;
+  H := H + 7 * G - H MOD 1;
+  IF H > F THEN H := H - 1 ELSE H := F / 2;
+  F := (C + E) * 11 MOD 1000;
+  E := D - E + 6;
+  H := H + 2 * G - H MOD 5;
+  IF C > G THEN D := C - 0 ELSE D := G / 3;
+  A := (D + C) * 4 MOD 1000;
+  D := G - A + 10;
+  E := A + 6 * D - A MOD 2;
+  IF B > E THEN H := B - 4 ELSE H := E / 1;
+  G := (H + G) * 8 MOD 1000;
+  C := F - F + 1;
+  H := A + 1 * F - A MOD 6;
+  IF C > H THEN H := C - 3 ELSE H := H / 2;
+  C := (D + A) * 1 MOD 1000;
+  G := G - B + 5;
+  E := A + 5 * G - A MOD 3;
+  IF G > H THEN C := G - 2 ELSE C := H / 3;
+  A := (H + E) * 5 MOD 1000;
+  D := A - A + 9;
+  C := G + 9 * C - G MOD 7;
+  IF B > H THEN H := B - 1 ELSE H := H / 1;
+  F := (H + C) * 9 MOD 1000;
+  E := E - C + 0;
+  C := C + 4 * E - C MOD 4;
+  IF E > C THEN D := E - 0 ELSE D := C / 2;
+  E := (A + C) * 2 MOD 1000;
+  A := B - F + 4;
+  G := H + 8 * G - H MOD 1;
+  IF F > H THEN B := F - 4 ELSE B := H / 3;
+  G := (H + D) * 6 MOD 1000;
+  H := C - H + 8;
+  E := B + 3 * C - B MOD 5;
+  IF A > C THEN D := A - 3 ELSE D := C / 1;
+  B := (C + C) * 10 MOD 1000;
+  G := C - B + 12;
+  F := H + 7 * H - H MOD 2;
+  IF F > B THEN B := F - 2 ELSE B := B / 2;
+  D := (B + G) * 3 MOD 1000;
+  A := F - A + 3;
+  A := F + 2 * G - F MOD 6;
+  IF G > B THEN B := G - 1 ELSE B := B / 3;
+  B := (E + C) * 7 MOD 1000;
+  G := D - A + 7;
+  F := B + 6 * H - B MOD 3;
+  IF D > E THEN E := D - 0 ELSE E := E / 1;
+  H := (C + C) * 11 MOD 1000;
+  F := B - A + 11;
+  E := F + 1 * A - F MOD 7;
+  IF F > A THEN B := F - 4 ELSE B := A / 2;
+  E := (G + E) * 4 MOD 1000;
+  C := G - D + 2;
+  A := F + 5 * D - F MOD 4;
+  IF E > B THEN E := E - 3 ELSE E := B / 3;
+  H := (B + A) * 8 MOD 1000;
+  B := D - B + 6;
+  B := F + 9 * C - F MOD 1;
+  IF F > A THEN D := F - 2 ELSE D := A / 1;
+  F := (E + E) * 1 MOD 1000;
+  H := A - D + 10;
+  B := A + 4 * B - A MOD 5;
+  IF A > B THEN E := A - 1 ELSE E := B / 2;
+  B := (A + C) * 5 MOD 1000;
+  H := B - A + 1;
+  A := H + 8 * B - H MOD 2;
+  IF B > F THEN B := B - 0 ELSE B := F / 3;
+  E := (G + D) * 9 MOD 1000;
+  G := B - E + 5;
+  B := G + 3 * A - G MOD 6;
+  IF A > F THEN D := A - 4 ELSE D := F / 1;
+  A := (A + B) * 2 MOD 1000;
+  G := H - H + 9;
+  C := H + 7 * G - H MOD 3;
+  IF G > D THEN B := G - 3 ELSE B := D / 2;
+  A := (E + C) * 6 MOD 1000;
+  C := G - B + 0;
+  C := E + 2 * G - E MOD 7;
+  IF F > C THEN H := F - 2 ELSE H := C / 3;
+  A := (A + B) * 10 MOD 1000;
+  B := A - A + 4;
+  B := G + 6 * D - G MOD 4;
+  IF F > H THEN H := F - 1 ELSE H := H / 1;
+  D := (B + C) * 3 MOD 1000;
+  C := G - F + 8;
+  B := H + 1 * B - H MOD 1;
+  IF A > A THEN A := A - 0 ELSE A := A / 2;
+  E := (C + C) * 7 MOD 1000;
+  D := E - E + 12;
+  C := D + 5 * H - D MOD 5;
+  IF D > D THEN E := D - 4 ELSE E := D / 3;
+  C := (F + H) * 11 MOD 1000;
+  A := F - D + 3;
+  H := E + 9 * A - E MOD 2;
+  IF A > B THEN D := A - 3 ELSE D := B / 1;
+  H := (F + F) * 4 MOD 1000;
+  D := G - C + 7;
+  A := E + 4 * C - E MOD 6;
+  IF D > C THEN A := D - 2 ELSE A := C / 2;
+  H := (A + D) * 8 MOD 1000;
+  A := A - C + 11;
+  H := E + 8 * A - E MOD 3;
+  IF E > C THEN E := E - 1 ELSE E := C / 3;
+  G := (F + H) * 1 MOD 1000;
+  B := B - B + 2;
+  E := D + 3 * B - D MOD 7;
+  IF H > H THEN H := H - 0 ELSE H := H / 1;
+  B := (F + B) * 5 MOD 1000;
+  A := E - F + 6;
+  D := G + 7 * C - G MOD 4;
+  IF A > D THEN C := A - 4 ELSE C := D / 2;
+  D := (D + H) * 9 MOD 1000;
+  F := G - D + 10;
+  A := F + 2 * C - F MOD 1;
+  IF F > A THEN E := F - 3 ELSE E := A / 3;
+  F := (F + G) * 2 MOD 1000;
+  F := F - E + 1;
+  G := D + 6 * D - D MOD 5;
+  IF A > D THEN F := A - 2 ELSE F := D / 1;
+  C := (G + F) * 6 MOD 1000;
+  G := G - A + 5;
+  E := F + 1 * F - F MOD 2;
+  IF B > C THEN F := B - 1 ELSE F := C / 2;
+  F := (C + G) * 10 MOD 1000;
+  E := C - H + 9;
+  F := H + 5 * A - H MOD 6;
+  IF B > B THEN A := B - 0 ELSE A := B / 3;
+  B := (H + B) * 3 MOD 1000;
+  B := G - C + 0;
+  G := G + 9 * F - G MOD 3;
+  IF G > B THEN B := G - 4 ELSE B := B / 1;
+  G := (H + F) * 7 MOD 1000;
+  F := D - F + 4;
+  C := G + 4 * E - G MOD 7;
+  IF F > B THEN D := F - 3 ELSE D := B / 2;
+  D := (D + G) * 11 MOD 1000;
+  C := E - C + 8;
+  H := G + 8 * A - G MOD 4;
+  IF G > G THEN E := G - 2 ELSE E := G / 3;
+  C := (C + F) * 4 MOD 1000;
+  H := G - G + 12;
+  E := D + 3 * E - D MOD 1;
+  IF B > H THEN G := B - 1 ELSE G := H / 1;
+  H := (D + G) * 8 MOD 1000;
+  A := A - A + 3;
+  F := H + 7 * H - H MOD 5;
+  IF C > G THEN B := C - 0 ELSE B := G / 2;
+  D := (H + H) * 1 MOD 1000;
+  A := G - F + 7;
+  D := H + 2 * D - H MOD 2;
+  IF G > F THEN B := G - 4 ELSE B := F / 3;
+  H := (H + H) * 5 MOD 1000;
+  A := G - G + 11;
+  G := H + 6 * D - H MOD 6;
+  IF B > C THEN G := B - 3 ELSE G := C / 1;
+  H := (H + G) * 9 MOD 1000;
+  C := E - E + 2;
+  G := G + 1 * D - G MOD 3;
+  IF C > F THEN H := C - 2 ELSE H := F / 2;
+  H := (C + E) * 2 MOD 1000;
+  E := F - F + 6;
+  F := C + 5 * A - C MOD 7;
+  IF H > F THEN B := H - 1 ELSE B := F / 3;
+  G := (A + C) * 6 MOD 1000;
+  E := F - D + 10;
+  A := G + 9 * C - G MOD 4;
+  IF D > F THEN A := D - 0 ELSE A := F / 1;
+  F := (F + B) * 10 MOD 1000;
+  G := F - D + 1;
+  F := H + 4 * H - H MOD 1;
+  IF E > D THEN E := E - 4 ELSE E := D / 2;
+  C := (C + G) * 3 MOD 1000;
+  A := C - H + 5;
+  G := E + 8 * G - E MOD 5;
+  IF H > F THEN C := H - 3 ELSE C := F / 3;
+  F := (E + A) * 7 MOD 1000;
+  E := D - E + 9;
+  C := H + 3 * E - H MOD 2;
+  IF C > A THEN A := C - 2 ELSE A := A / 1;
+  D := (F + C) * 11 MOD 1000;
+  C := G - E + 0;
+  D := C + 7 * H - C MOD 6;
+  IF H > G THEN H := H - 1 ELSE H := G / 2;
+  G := (D + A) * 4 MOD 1000;
+  H := F - A + 4;
+  C := B + 2 * E - B MOD 3;
+  IF B > B THEN H := B - 0 ELSE H := B / 3;
+  E := (F + D) * 8 MOD 1000;
+  C := C - E + 8;
+  F := C + 6 * H - C MOD 7;
+  IF F > G THEN C := F - 4 ELSE C := G / 1;
+  H := (G + C) * 1 MOD 1000;
+  F := F - F + 12;
+  G := H + 1 * E - H MOD 4;
+  IF D > E THEN F := D - 3 ELSE F := E / 2;
+  C := (A + E) * 5 MOD 1000;
+  E := B - E + 3;
+  E := D + 5 * F - D MOD 1;
+  IF F > D THEN E := F - 2 ELSE E := D / 3;
+  F := (D + E) * 9 MOD 1000;
+  F := C - G + 7;
+  D := C + 9 * D - C MOD 5;
+  IF A > A THEN E := A - 1 ELSE E := A / 1;
+  C := (F + D) * 2 MOD 1000;
+  A := B - D + 11;
+  B := G + 4 * C - G MOD 2;
+  IF E > C THEN A := E - 0 ELSE A := C / 2;
+  H := (F + B) * 6 MOD 1000;
+  E := G - G + 2;
+  E := B + 8 * A - B MOD 6;
+  IF A > H THEN B := A - 4 ELSE B := H / 3;
+  H := (H + F) * 10 MOD 1000;
+  B := F - C + 6;
+  B := D + 3 * F - D MOD 3;
+  IF E > D THEN D := E - 3 ELSE D := D / 1;
+  C := (E + H) * 3 MOD 1000;
+  F := C - H + 10;
+  E := C + 7 * G - C MOD 7;
+  IF E > G THEN F := E - 2 ELSE F := G / 2;
+  H := (F + E) * 7 MOD 1000;
+  D := E - A + 1;
+  D := E + 2 * C - E MOD 4;
+  IF E > G THEN H := E - 1 ELSE H := G / 3;
+  B := (D + E) * 11 MOD 1000;
+  F := G - D + 5;
+  H := E + 6 * B - E MOD 1;
+  IF E > C THEN H := E - 0 ELSE H := C / 1;
+  A := (E + C) * 4 MOD 1000;
+  D := G - A + 9;
+  G := D + 1 * E - D MOD 5;
+  IF A > E THEN C := A - 4 ELSE C := E / 2;
+  H := (F + D) * 8 MOD 1000;
+  A := C - F + 0;
+  B := F + 5 * F - F MOD 2;
+  IF B > F THEN E := B - 3 ELSE E := F / 3;
+  G := (F + B) * 1 MOD 1000;
+  C := H - C + 4;
+  D := E + 9 * B - E MOD 6;
+  IF H > D THEN C := H - 2 ELSE C := D / 1;
+  H := (A + C) * 5 MOD 1000;
+  D := F - F + 8;
+  B := G + 4 * C - G MOD 3;
+  IF B > G THEN G := B - 1 ELSE G := G / 2;
+  F := (F + C) * 9 MOD 1000;
+  G := H - B + 12;
+  H := G + 8 * A - G MOD 7;
+  IF B > B THEN H := B - 0 ELSE H := B / 3;
+  D := (D + C) * 2 MOD 1000;
+  D := C - G + 3;
+  B := D + 3 * A - D MOD 4;
+  IF C > E THEN B := C - 4 ELSE B := E / 1;
+  H := (G + D) * 6 MOD 1000;
+  F := A - F + 7;
+  B := A + 7 * D - A MOD 1;
+  IF A > C THEN H := A - 3 ELSE H := C / 2;
+  B := (F + D) * 10 MOD 1000;
+  D := E - G + 11;
+  B := C + 2 * H - C MOD 5;
+  IF F > G THEN A := F - 2 ELSE A := G / 3;
+  E := (H + B) * 3 MOD 1000;
+  C := D - A + 2;
+  G := G + 6 * E - G MOD 2;
+  IF H > F THEN H := H - 1 ELSE H := F / 1;
+  E := (A + F) * 7 MOD 1000;
+  F := G - D + 6;
+  C := F + 1 * C - F MOD 6;
+  IF F > G THEN B := F - 0 ELSE B := G / 2;
+  H := (B + E) * 11 MOD 1000;
+  D := A - B + 10;
+  E := B + 5 * G - B MOD 3;
+  IF A > G THEN H := A - 4 ELSE H := G / 3;
+  E := (D + B) * 4 MOD 1000;
+  D := G - E + 1;
+  F := D + 9 * F - D MOD 7;
+  IF B > G THEN G := B - 3 ELSE G := G / 1;
+  B := (C + D) * 8 MOD 1000;
+  A := D - B + 5;
+  D := B + 4 * B - B MOD 4;
+  IF D > D THEN D := D - 2 ELSE D := D / 2;
+  C := (C + F) * 1 MOD 1000;
+  C := B - C + 9;
+  B := H + 8 * E - H MOD 1;
+  IF A > C THEN G := A - 1 ELSE G := C / 3;
+  B := (H + H) * 5 MOD 1000;
+  B := E - H + 0;
+  C := H + 3 * G - H MOD 5;
+  IF E > G THEN F := E - 0 ELSE F := G / 1;
+  C := (H + E) * 9 MOD 1000;
+  C := B - B + 4;
+  G := C + 7 * F - C MOD 2;
+  IF G > H THEN B := G - 4 ELSE B := H / 2;
+  C := (E + F) * 2 MOD 1000;
+  F := A - H + 8;
+  D := D + 2 * E - D MOD 6;
+  IF H > D THEN E := H - 3 ELSE E := D / 3;
+  A := (F + G) * 6 MOD 1000;
+  H := H - G + 12;
+  D := B + 6 * D - B MOD 3;
+  IF G > H THEN F := G - 2 ELSE F := H / 1;
+  G := (C + C) * 10 MOD 1000;
+  F := B - G + 3;
+  D := F + 1 * G - F MOD 7;
+  IF C > F THEN C := C - 1 ELSE C := F / 2;
+  G := (H + E) * 3 MOD 1000;
+  B := D - B + 7;
+  B := B + 5 * G - B MOD 4;
+  IF H > D THEN A := H - 0 ELSE A := D / 3;
+  F := (D + H) * 7 MOD 1000;
+  H := A - H + 11;
+  H := C + 9 * A - C MOD 1;
+  IF D > D THEN A := D - 4 ELSE A := D / 1;
+  D := (G + C) * 11 MOD 1000;
+  D := G - E + 2;
+  A := A + 4 * B - A MOD 5;
+  IF F > F THEN E := F - 3 ELSE E := F / 2;
+  D := (B + G) * 4 MOD 1000;
+  F := D - A + 6;
+  F := D + 8 * H - D MOD 2;
+  IF F > B THEN G := F - 2 ELSE G := B / 3;
+  E := (A + G) * 8 MOD 1000;
+  D := E - H + 10;
+  WRITE(A);
+  WRITE(B);
+  WRITE(C);
+  WRITE(D);
+  WRITE(E);
+  WRITE(F);
+  WRITE(G);
+  WRITE(H)
+END
@@ -0,0 +1,576 @@
+//*****************************************************************************
+// Register bytecode for TIPS programs and the compiler from the parse tree
+//
+// Every instruction names its operands directly as registers of one frame:
+//
+//   [ variables | constants | temporaries ]
+//
+// Variables live in the registers numbered by their slots (see
+// BlockNode::variables), so execution never looks a name up. Constants are
+// preloaded into their registers when the VM starts, so literals need no
+// load instructions either.
+//
+// The code is typed: the type checker has decided every operation's type,
+// so there are separate INTEGER (I) and REAL (F) instructions, conversions
+// are explicit (I2F) and registers hold untagged 64-bit slots. BOOLEAN
+// values are INTEGER 0 / 1.
+//*****************************************************************************
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+#include "runtime.h"
+#include "typecheck.h"
+
+using namespace std;
+
+// Operand kinds: register, jump target, string table index, immediate
+// number, unused
+enum OperandKind { OPND_R, OPND_J, OPND_S, OPND_I, OPND__ };
+
+// X(name, a, b, c): every opcode with the kinds of its three operands
+#define TIPS_OPCODES(X) \
+    X(MOVE,   R, R, _)   /* R[a] = R[b]                       */ \
+    X(ADDI,   R, R, R)   /* R[a] = R[b] + R[c]                */ \
+    X(SUBI,   R, R, R)                                            \
+    X(MULI,   R, R, R)                                            \
+    X(DIVI,   R, R, R)   /* truncating, traps on zero         */ \
+    X(MODI,   R, R, R)                                            \
+    X(SHLI,   R, R, I)   /* R[a] = R[b] * 2^c                 */ \
+    X(DIVPI,  R, R, I)   /* R[a] = R[b] / 2^c, truncating     */ \
+    X(MODPI,  R, R, I)   /* R[a] = R[b] MOD 2^c               */ \
+    X(ADDF,   R, R, R)                                            \
+    X(SUBF,   R, R, R)                                            \
+    X(MULF,   R, R, R)                                            \
+    X(DIVF,   R, R, R)                                            \
+    X(EQI,    R, R, R)   /* R[a] = R[b] = R[c] ? 1 : 0        */ \
+    X(NEI,    R, R, R)                                            \
+    X(LTI,    R, R, R)                                            \
+    X(GTI,    R, R, R)                                            \
+    X(EQF,    R, R, R)                                            \
+    X(NEF,    R, R, R)                                            \
+    X(LTF,    R, R, R)                                            \
+    X(GTF,    R, R, R)                                            \
+    X(AND,    R, R, R)   /* R[a] = R[b] <> 0 AND R[c] <> 0    */ \
+    X(OR,     R, R, R)                                            \
+    X(NEGI,   R, R, _)   /* R[a] = -R[b]                      */ \
+    X(NEGF,   R, R, _)                                            \
+    X(NOT,    R, R, _)   /* R[a] = R[b] = 0 ? 1 : 0           */ \
+    X(I2F,    R, R, _)   /* R[a] = REAL(R[b])                 */ \
+    X(JMP,    _, J, _)   /* goto b                            */ \
+    X(JMPF,   R, J, _)   /* if R[a] = 0 goto b                */ \
+    X(JMPT,   R, J, _)   /* if R[a] <> 0 goto b               */ \
+    X(FORUP,  R, J, R)   /* if R[a]++ < R[c] goto b           */ \
+    X(FORDN,  R, J, R)   /* if R[a]-- > R[c] goto b           */ \
+    X(READI,  R, _, _)   /* R[a] = next input INTEGER         */ \
+    X(READF,  R, _, _)   /* R[a] = next input number as REAL  */ \
+    X(WRITEI, R, _, _)   /* print R[a]                        */ \
+    X(WRITEF, R, _, _)                                            \
+    X(WRITES, _, S, _)   /* print strings[b]                  */ \
+    X(HALT,   _, _, _)
+
+enum Opcode : uint8_t {
+#define TIPS_OPCODE_ENUM(name, a, b, c) OP_##name,
+    TIPS_OPCODES(TIPS_OPCODE_ENUM)
+#undef TIPS_OPCODE_ENUM
+    OP_COUNT
+};
+
+struct OpcodeInfo {
+    const char* name;
+    OperandKind a, b, c;
+};
+
+const OpcodeInfo opcodeInfo[] = {
+#define TIPS_OPCODE_INFO(name, a, b, c) {#name, OPND_##a, OPND_##b, OPND_##c},
+    TIPS_OPCODES(TIPS_OPCODE_INFO)
+#undef TIPS_OPCODE_INFO
+};
+
+// A register: the type of its contents is known statically
+union Slot {
+    int64_t i;
+    double f;
+};
+
+// 12 bytes: an 8-bit opcode, a 24-bit destination and two 32-bit sources
+struct Instr {
+    uint32_t op : 8;
+    uint32_t a : 24;
+    uint32_t b;
+    uint32_t c;
+};
+
+// The VM handlers call these even in unoptimized builds (TIPS_ALWAYS_INLINE,
+// runtime.h)
+// INTEGER division and MOD by 2^k, k in 1..62, truncating toward zero like
+// DIVI and MODI: a negative dividend is biased by 2^k - 1 before the
+// arithmetic shift, so -5 / 2 = -2 and -5 MOD 2 = -1
+TIPS_ALWAYS_INLINE int64_t divPow2(int64_t x, unsigned k) {
+    int64_t bias = (x >> 63) & (((int64_t)1 << k) - 1);
+    return (x + bias) >> k;
+}
+
+TIPS_ALWAYS_INLINE int64_t modPow2(int64_t x, unsigned k) {
+    int64_t bias = (x >> 63) & (((int64_t)1 << k) - 1);
+    return x - ((x + bias) & ~(((int64_t)1 << k) - 1));
+}
+
+//*****************************************************************************
+// A compiled program
+struct Chunk {
+    vector<Instr> code;
+    vector<Value> constants;   // preloaded into registers numVars ...
+    vector<string> strings;    // WRITE string literals, without quotes
+    vector<string> varNames;   // variable in each of the first numVars registers
+    vector<TipsType> varTypes;
+    uint32_t numVars = 0;
+    uint32_t numRegs = 0;
+
+    uint32_t firstConst() const { return numVars; }
+    uint32_t firstTemp() const { return numVars + constants.size(); }
+};
+
+// A fresh register frame: zeroes with the constants preloaded
+void initRegisters(const Chunk& chunk, vector<Slot>& regs) {
+    regs.assign(chunk.numRegs, Slot());
+    for (size_t k = 0; k < chunk.constants.size(); ++k) {
+        const Value& v = chunk.constants[k];
+        if (v.isReal) regs[chunk.firstConst() + k].f = v.r;
+        else regs[chunk.firstConst() + k].i = v.i;
+    }
+}
+
+//*****************************************************************************
+// Compiler from the parse tree to a Chunk
+//
+// While compiling, constant and temporary registers are numbered in their
+// own spaces (tagged with REG_CONST / REG_TEMP) because their final position
+// depends on how many variables and constants there are; finish() relocates
+// them. Temporaries are allocated like a stack and reused between statements.
+class BytecodeCompiler {
+public:
+    static const uint32_t REG_CONST = 1u << 22;
+    static const uint32_t REG_TEMP  = 1u << 23;
+    static const uint32_t NO_REG    = 0xFFFFFFFF;
+
+    Chunk chunk;
+    map<pair<bool, int64_t>, uint32_t> constIndex;  // (isReal, bits) -> index
+    uint32_t nextTemp = 0;
+    uint32_t maxTemps = 0;
+    uint32_t reserved = 0;  // temporaries held by the enclosing FOR loops
+
+    // The JMPs of the BREAKs and CONTINUEs in the innermost loop, patched
+    // once the loop's exit and the place an iteration ends are known
+    struct LoopJumps {
+        vector<uint32_t> breaks, continues;
+    };
+    LoopJumps* loop = nullptr;
+
+    Chunk compile(ProgramNode& pn);
+
+    uint32_t emit(Opcode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0);
+    uint32_t here() const { return chunk.code.size(); }
+    void patch(uint32_t at, uint32_t target) { chunk.code[at].b = target; }
+    void patch(const vector<uint32_t>& at, uint32_t target) {
+        for (uint32_t jump : at) patch(jump, target);
+    }
+
+    uint32_t constant(const Value& v);
+    uint32_t temp();
+    void release(uint32_t reg);
+    uint32_t toReal(uint32_t reg, TipsType type);
+
+    void statement(StatementNode& sn);
+    uint32_t expression(ExprNode& en, uint32_t target = NO_REG);
+    uint32_t simpleExpression(SimpleExprNode& sn, uint32_t target = NO_REG);
+    uint32_t term(TermNode& tn, uint32_t target = NO_REG);
+    uint32_t factor(FactorNode& fn, uint32_t target = NO_REG);
+    template <class Node>
+    uint32_t chain(const vector<int>& ops, const vector<TipsType>& opTypes,
+                   uint32_t first, TipsType firstType, const vector<Node*>& rest,
+                   uint32_t (BytecodeCompiler::*operand)(Node&, uint32_t), uint32_t target);
+    void assignTo(uint32_t slot, ExprNode& en);
+    void finish();
+};
+
+Opcode binaryOpcode(int tok, TipsType opType) {
+    bool real = opType == TYPE_REAL;
+    switch (tok) {
+    case TOK_PLUS:        return real ? OP_ADDF : OP_ADDI;
+    case TOK_MINUS:       return real ? OP_SUBF : OP_SUBI;
+    case TOK_MULTIPLY:    return real ? OP_MULF : OP_MULI;
+    case TOK_DIVIDE:      return real ? OP_DIVF : OP_DIVI;
+    case TOK_MOD:         return OP_MODI;
+    case TOK_AND:         return OP_AND;
+    case TOK_OR:          return OP_OR;
+    case TOK_EQUALTO:     return real ? OP_EQF : OP_EQI;
+    case TOK_NOTEQUALTO:  return real ? OP_NEF : OP_NEI;
+    case TOK_LESSTHAN:    return real ? OP_LTF : OP_LTI;
+    case TOK_GREATERTHAN: return real ? OP_GTF : OP_GTI;
+    default:              throw "unknown operator";
+    }
+}
+
+Chunk BytecodeCompiler::compile(ProgramNode& pn) {
+    chunk.varNames = pn.block->variables;
+    chunk.varTypes = pn.block->variableTypes;
+    statement(*pn.block->firstCompound);
+    emit(OP_HALT);
+    finish();
+    return chunk;
+}
+
+uint32_t BytecodeCompiler::emit(Opcode op, uint32_t a, uint32_t b, uint32_t c) {
+    Instr in;
+    in.op = op;
+    in.a = a;
+    in.b = b;
+    in.c = c;
+    chunk.code.push_back(in);
+    return chunk.code.size() - 1;
+}
+
+uint32_t BytecodeCompiler::constant(const Value& v) {
+    int64_t bits;
+    memcpy(&bits, &v.i, sizeof bits);
+    auto key = make_pair(v.isReal, bits);
+    auto found = constIndex.find(key);
+    if (found != constIndex.end())
+        return REG_CONST | found->second;
+    uint32_t index = chunk.constants.size();
+    chunk.constants.push_back(v);
+    constIndex[key] = index;
+    return REG_CONST | index;
+}
+
+uint32_t BytecodeCompiler::temp() {
+    uint32_t t = nextTemp++;
+    maxTemps = max(maxTemps, nextTemp);
+    return REG_TEMP | t;
+}
+
+// Temporaries are released in reverse order of allocation
+void BytecodeCompiler::release(uint32_t reg) {
+    if (reg != NO_REG && (reg & REG_TEMP) && (reg & ~REG_TEMP) == nextTemp - 1)
+        --nextTemp;
+}
+
+// Convert an INTEGER (or BOOLEAN) operand to REAL. A constant becomes a
+// REAL constant; anything else is converted into a temporary, in place when
+// it is the topmost one.
+uint32_t BytecodeCompiler::toReal(uint32_t reg, TipsType type) {
+    if (type == TYPE_REAL)
+        return reg;
+    if (reg & REG_CONST)
+        return constant(Value::real(chunk.constants[reg & ~REG_CONST].i));
+    release(reg);
+    uint32_t dest = temp();
+    emit(OP_I2F, dest, reg);
+    return dest;
+}
+
+void BytecodeCompiler::assignTo(uint32_t slot, ExprNode& en) {
+    if (chunk.varTypes[slot] == TYPE_REAL && en.type != TYPE_REAL) {
+        uint32_t r = expression(en);
+        if (r & REG_CONST) emit(OP_MOVE, slot, toReal(r, en.type));
+        else emit(OP_I2F, slot, r);
+    }
+    else {
+        uint32_t r = expression(en, slot);
+        if (r != slot)
+            emit(OP_MOVE, slot, r);
+    }
+    nextTemp = reserved;
+}
+
+void BytecodeCompiler::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        assignTo(an.slot, *an.expression);
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        statement(*cn.firstStatement);
+        for (StatementNode* s : cn.restStatements)
+            statement(*s);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        uint32_t cond = expression(*in.expression);
+        nextTemp = reserved;
+        NodeKind only = in.firstStatement.size() == 1 ? in.firstStatement[0]->kind : IF_NODE;
+        if (only == BREAK_NODE || only == CONTINUE_NODE) {
+            // IF ... THEN BREAK is one conditional jump out of the loop
+            (only == BREAK_NODE ? loop->breaks : loop->continues).push_back(emit(OP_JMPT, cond));
+            for (StatementNode* s : in.restStatements)
+                statement(*s);
+            break;
+        }
+        uint32_t toElse = emit(OP_JMPF, cond);
+        for (StatementNode* s : in.firstStatement)
+            statement(*s);
+        if (in.restStatements.empty()) {
+            patch(toElse, here());
+            break;
+        }
+        uint32_t toEnd = emit(OP_JMP);
+        patch(toElse, here());
+        for (StatementNode* s : in.restStatements)
+            statement(*s);
+        patch(toEnd, here());
+        break;
+    }
+    case WHILE_NODE: {
+        // Rotated so each iteration takes a single backward branch:
+        //     JMP cond; body: ...; cond: ...; JMPT body
+        WhileNode& wn = (WhileNode&)sn;
+        LoopJumps jumps, *outer = loop;
+        loop = &jumps;
+        uint32_t toCond = emit(OP_JMP);
+        uint32_t body = here();
+        statement(*wn.firstStatement);
+        patch(toCond, here());
+        patch(jumps.continues, here());
+        uint32_t cond = expression(*wn.expression);
+        nextTemp = reserved;
+        emit(OP_JMPT, cond, body);
+        patch(jumps.breaks, here());
+        loop = outer;
+        break;
+    }
+    case FOR_NODE: {
+        // The limit is computed once, into a temporary the body leaves
+        // alone (unless it is a constant), and each iteration ends in one
+        // instruction that steps the variable and branches back:
+        //     v := start; GTI t, v, limit; JMPT t, exit; body: ...; FORUP v, body, limit
+        ForNode& fn = (ForNode&)sn;
+        uint32_t limit = temp();
+        uint32_t first = expression(*fn.start);
+        uint32_t last = expression(*fn.limit, limit);
+        if (last & REG_CONST)
+            limit = last;
+        else if (last != limit)
+            emit(OP_MOVE, limit, last);
+        if (first != (uint32_t)fn.slot)
+            emit(OP_MOVE, fn.slot, first);
+        uint32_t outerReserved = reserved;
+        reserved = limit & REG_CONST ? outerReserved : (limit & ~REG_TEMP) + 1;
+        nextTemp = reserved;
+        uint32_t past = temp();
+        emit(fn.down ? OP_LTI : OP_GTI, past, fn.slot, limit);
+        uint32_t toExit = emit(OP_JMPT, past);
+        nextTemp = reserved;
+        LoopJumps jumps, *outer = loop;
+        loop = &jumps;
+        uint32_t body = here();
+        statement(*fn.firstStatement);
+        patch(jumps.continues, here());
+        emit(fn.down ? OP_FORDN : OP_FORUP, fn.slot, body, limit);
+        patch(toExit, here());
+        patch(jumps.breaks, here());
+        loop = outer;
+        reserved = outerReserved;
+        nextTemp = reserved;
+        break;
+    }
+    case BREAK_NODE:
+        loop->breaks.push_back(emit(OP_JMP));
+        break;
+    case CONTINUE_NODE:
+        loop->continues.push_back(emit(OP_JMP));
+        break;
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        emit(chunk.varTypes[slot] == TYPE_REAL ? OP_READF : OP_READI, slot);
+        break;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        if (wn.isString()) {
+            chunk.strings.push_back(wn.operand());
+            emit(OP_WRITES, 0, chunk.strings.size() - 1);
+        }
+        else
+            emit(chunk.varTypes[wn.slot] == TYPE_REAL ? OP_WRITEF : OP_WRITEI, wn.slot);
+        break;
+    }
+    default:
+        throw "statement cannot be compiled";
+    }
+}
+
+// Each level of an expression returns the register holding its value. The
+// target, when given, is where the caller wants the value; it is handed down
+// to the last operation so the result lands there without an extra MOVE.
+// Operands are converted to the operation's type as soon as they have been
+// computed, which keeps the temporaries in stack order.
+template <class Node>
+uint32_t BytecodeCompiler::chain(const vector<int>& ops, const vector<TipsType>& opTypes,
+                                 uint32_t first, TipsType firstType, const vector<Node*>& rest,
+                                 uint32_t (BytecodeCompiler::*operand)(Node&, uint32_t), uint32_t target) {
+    uint32_t r = first;
+    TipsType type = firstType;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (opTypes[i] == TYPE_REAL)
+            r = toReal(r, type);
+        uint32_t right = (this->*operand)(*rest[i], NO_REG);
+        if (opTypes[i] == TYPE_REAL)
+            right = toReal(right, rest[i]->type);
+        release(right);
+        release(r);
+        uint32_t dest = i + 1 == ops.size() && target != NO_REG ? target : temp();
+        emit(binaryOpcode(ops[i], opTypes[i]), dest, r, right);
+        r = dest;
+        type = resultType(ops[i], opTypes[i]);
+    }
+    return r;
+}
+
+uint32_t BytecodeCompiler::expression(ExprNode& en, uint32_t target) {
+    bool single = en.restExpOps.empty();
+    uint32_t first = simpleExpression(*en.simpleExpr, single ? target : NO_REG);
+    return chain(en.restExpOps, en.opTypes, first, en.simpleExpr->type, en.restExpr,
+                 &BytecodeCompiler::simpleExpression, target);
+}
+
+uint32_t BytecodeCompiler::simpleExpression(SimpleExprNode& sn, uint32_t target) {
+    bool single = sn.restTermOps.empty();
+    uint32_t first = term(*sn.firstTerm, single ? target : NO_REG);
+    return chain(sn.restTermOps, sn.opTypes, first, sn.firstTerm->type, sn.restTerms,
+                 &BytecodeCompiler::term, target);
+}
+
+uint32_t BytecodeCompiler::term(TermNode& tn, uint32_t target) {
+    bool single = tn.restFactorOps.empty();
+    uint32_t first = factor(*tn.firstFactor, single ? target : NO_REG);
+    return chain(tn.restFactorOps, tn.opTypes, first, tn.firstFactor->type, tn.restFactors,
+                 &BytecodeCompiler::factor, target);
+}
+
+uint32_t BytecodeCompiler::factor(FactorNode& fn, uint32_t target) {
+    size_t n = fn.unaryOps.size();
+    uint32_t r;
+    TipsType type;
+    switch (fn.kind) {
+    case ID_NODE:
+        r = ((IdNode&)fn).slot;
+        type = chunk.varTypes[r];
+        break;
+    case INTLIT_NODE:
+        r = constant(Value::integer(((IntLitNode&)fn).int_literal));
+        type = TYPE_INTEGER;
+        break;
+    case FLOATLIT_NODE:
+        r = constant(Value::real(((FloatLitNode&)fn).double_literal));
+        type = TYPE_REAL;
+        break;
+    case NESTED_EXPR_NODE:
+        r = expression(*((NestedExprNode&)fn).exprPtr, n == 0 ? target : NO_REG);
+        type = ((NestedExprNode&)fn).exprPtr->type;
+        break;
+    default:
+        throw "factor cannot be compiled";
+    }
+
+    // innermost operator first
+    for (size_t i = n; i-- > 0; ) {
+        release(r);
+        uint32_t dest = i == 0 && target != NO_REG ? target : temp();
+        if (fn.unaryOps[i] == TOK_NOT) {
+            emit(OP_NOT, dest, r);
+            type = TYPE_BOOLEAN;
+        }
+        else {
+            emit(type == TYPE_REAL ? OP_NEGF : OP_NEGI, dest, r);
+            if (type == TYPE_BOOLEAN) type = TYPE_INTEGER;
+        }
+        r = dest;
+    }
+    return r;
+}
+
+// Move constants and temporaries to their final registers
+void BytecodeCompiler::finish() {
+    chunk.numVars = chunk.varNames.size();
+    chunk.numRegs = chunk.firstTemp() + maxTemps;
+
+    auto relocate = [&](uint32_t reg) -> uint32_t {
+        if (reg & REG_TEMP) return chunk.firstTemp() + (reg & ~REG_TEMP);
+        if (reg & REG_CONST) return chunk.firstConst() + (reg & ~REG_CONST);
+        return reg;
+    };
+    for (Instr& in : chunk.code) {
+        const OpcodeInfo& info = opcodeInfo[in.op];
+        if (info.a == OPND_R) in.a = relocate(in.a);
+        if (info.b == OPND_R) in.b = relocate(in.b);
+        if (info.c == OPND_R) in.c = relocate(in.c);
+    }
+}
+
+//*****************************************************************************
+// Human readable listing of a chunk (tips_parse --disasm)
+void printOperand(ostream& os, const Chunk& chunk, OperandKind kind, uint32_t value) {
+    switch (kind) {
+    case OPND_R:
+        if (value < chunk.numVars) os << chunk.varNames[value];
+        else if (value < chunk.firstTemp()) {
+            const Value& k = chunk.constants[value - chunk.firstConst()];
+            if (!k.isReal) os << "#" << k.i;
+            else {
+                ostringstream text;
+                text << k.r;
+                os << "#" << text.str();
+                if (text.str().find_first_of(".einf") == string::npos) os << ".0";
+            }
+        }
+        else os << "t" << value - chunk.firstTemp();
+        break;
+    case OPND_J:
+        os << "@" << value;
+        break;
+    case OPND_S:
+        os << "'" << chunk.strings[value] << "'";
+        break;
+    case OPND_I:
+        os << value;
+        break;
+    default:
+        break;
+    }
+}
+
+void disassemble(const Chunk& chunk, ostream& os) {
+    os << "; " << chunk.numVars << " variables, " << chunk.constants.size() << " constants, "
+       << chunk.numRegs - chunk.firstTemp() << " temporaries" << endl;
+    for (size_t pc = 0; pc < chunk.code.size(); ++pc) {
+        const Instr& in = chunk.code[pc];
+        const OpcodeInfo& info = opcodeInfo[in.op];
+        os << setw(4) << pc << "  " << info.name;
+        OperandKind kinds[3] = {info.a, info.b, info.c};
+        uint32_t values[3] = {in.a, in.b, in.c};
+        bool first = true;
+        for (int i = 0; i < 3; ++i) {
+            if (kinds[i] == OPND__) continue;
+            if (first) os << string(7 - strlen(info.name), ' ');
+            else os << ", ";
+            printOperand(os, chunk, kinds[i], values[i]);
+            first = false;
+        }
+        os << endl;
+    }
+}
+
+#endif /* BYTECODE_H */
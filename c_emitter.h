@@ -0,0 +1,433 @@
+//*****************************************************************************
+// Ahead-of-time translation of a program to C (tips_parse --emit-c)
+//
+// The output is one self-contained C99 translation unit, so
+//     tips_parse --emit-c prog.pas > prog.c && gcc -O2 prog.c -o prog
+// gives a native executable that behaves like tips_parse --run prog.pas:
+// same READ tokens, same WRITE formatting, same runtime error messages.
+//
+// Variables become locals of main and expressions are translated from the
+// type checker's annotations, converting operands to double where an
+// operator works on REAL. INTEGER arithmetic goes through small inline
+// helpers that wrap around on overflow and trap on division by zero, so
+// the C compiler may not assume overflow away. AND and OR evaluate both
+// operands like the other engines do.
+//*****************************************************************************
+#ifndef C_EMITTER_H
+#define C_EMITTER_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+#include "typecheck.h"
+
+using namespace std;
+
+// Support code at the top of every translation unit
+const char* const cRuntime = R"(#include <ctype.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline void tips_error(const char* msg) {
+    fflush(stdout);
+    printf("***RUNTIME ERROR: %s\n", msg);
+    exit(EXIT_FAILURE);
+}
+
+/* The next whitespace separated token of the input */
+static inline char* tips_token(void) {
+    static char* buf = NULL;
+    static size_t cap = 0;
+    size_t len = 0;
+    int ch;
+    do ch = getchar(); while (ch != EOF && isspace(ch));
+    if (ch == EOF) tips_error("READ past the end of the input");
+    do {
+        if (len + 1 >= cap) {
+            cap = cap ? 2 * cap : 64;
+            buf = (char*)realloc(buf, cap);
+            if (!buf) tips_error("out of memory");
+        }
+        buf[len++] = (char)ch;
+        ch = getchar();
+    } while (ch != EOF && !isspace(ch));
+    buf[len] = '\0';
+    return buf;
+}
+
+static inline int64_t tips_read_integer(void) {
+    char* t = tips_token();
+    char* end;
+    if (strpbrk(t, ".eE")) {
+        strtod(t, &end);
+        if (*end == '\0') tips_error("READ expects an INTEGER");
+    }
+    else {
+        long long i = strtoll(t, &end, 10);
+        if (*end == '\0') return i;
+    }
+    tips_error("READ expects a number");
+    return 0;
+}
+
+static inline double tips_read_real(void) {
+    char* t = tips_token();
+    char* end;
+    if (strpbrk(t, ".eE")) {
+        double r = strtod(t, &end);
+        if (*end == '\0') return r;
+    }
+    else {
+        long long i = strtoll(t, &end, 10);
+        if (*end == '\0') return (double)i;
+    }
+    tips_error("READ expects a number");
+    return 0;
+}
+
+static inline void tips_write_integer(int64_t i) { printf("%" PRId64 "\n", i); }
+// every NaN prints as "nan", whatever its sign, like Runtime::writeReal
+static inline void tips_write_real(double r) { printf("%g\n", r != r ? fabs(r) : r); }
+static inline void tips_write_string(const char* s) { puts(s); }
+
+/* INTEGER arithmetic wraps around */
+static inline int64_t tips_add(int64_t a, int64_t b) { return (int64_t)((uint64_t)a + (uint64_t)b); }
+static inline int64_t tips_sub(int64_t a, int64_t b) { return (int64_t)((uint64_t)a - (uint64_t)b); }
+static inline int64_t tips_mul(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }
+static inline int64_t tips_neg(int64_t a) { return (int64_t)(0 - (uint64_t)a); }
+
+static inline int64_t tips_div(int64_t a, int64_t b) {
+    if (b == 0) tips_error("division by zero");
+    return b == -1 ? tips_neg(a) : a / b;
+}
+
+static inline int64_t tips_mod(int64_t a, int64_t b) {
+    if (b == 0) tips_error("division by zero");
+    return b == -1 ? 0 : a % b;
+}
+
+/* The end of a FOR iteration: steps the variable and tells whether the
+   value it had was short of the limit */
+static inline int tips_for_up(int64_t* v, int64_t last) {
+    int64_t i = *v;
+    *v = tips_add(i, 1);
+    return i < last;
+}
+
+static inline int tips_for_down(int64_t* v, int64_t last) {
+    int64_t i = *v;
+    *v = tips_sub(i, 1);
+    return i > last;
+}
+
+/* A REAL constant that has no literal, such as a NaN */
+static inline double tips_real_bits(uint64_t u) {
+    double r;
+    memcpy(&r, &u, sizeof r);
+    return r;
+}
+)";
+
+class CEmitter {
+public:
+    ostream& os;
+    const vector<string>* names = nullptr;
+    const vector<TipsType>* types = nullptr;
+    int depth = 1;  // indentation level of the statement being emitted
+
+    CEmitter(ostream& output) : os(output) {}
+
+    void program(ProgramNode& pn);
+    void statement(StatementNode& sn);
+    void statements(const vector<StatementNode*>& list);
+    void indent() { os << string(4 * depth, ' '); }
+
+    string variable(int slot) { return "v_" + (*names)[slot]; }
+    string expression(ExprNode& en);
+    string simpleExpression(SimpleExprNode& sn);
+    string term(TermNode& tn);
+    string factor(FactorNode& fn);
+    template <class Node>
+    string chain(const vector<int>& ops, const vector<TipsType>& opTypes,
+                 string first, TipsType firstType, const vector<Node*>& rest,
+                 string (CEmitter::*operand)(Node&));
+};
+
+string cOperation(int tok, TipsType opType, const string& x, const string& y) {
+    if (opType == TYPE_REAL) {
+        switch (tok) {
+        case TOK_PLUS:        return "(" + x + " + " + y + ")";
+        case TOK_MINUS:       return "(" + x + " - " + y + ")";
+        case TOK_MULTIPLY:    return "(" + x + " * " + y + ")";
+        case TOK_DIVIDE:      return "(" + x + " / " + y + ")";
+        default:              break;
+        }
+    }
+    switch (tok) {
+    case TOK_PLUS:        return "tips_add(" + x + ", " + y + ")";
+    case TOK_MINUS:       return "tips_sub(" + x + ", " + y + ")";
+    case TOK_MULTIPLY:    return "tips_mul(" + x + ", " + y + ")";
+    case TOK_DIVIDE:      return "tips_div(" + x + ", " + y + ")";
+    case TOK_MOD:         return "tips_mod(" + x + ", " + y + ")";
+    case TOK_AND:         return "((" + x + " != 0) & (" + y + " != 0))";
+    case TOK_OR:          return "((" + x + " != 0) | (" + y + " != 0))";
+    case TOK_EQUALTO:     return "(" + x + " == " + y + ")";
+    case TOK_NOTEQUALTO:  return "(" + x + " != " + y + ")";
+    case TOK_LESSTHAN:    return "(" + x + " < " + y + ")";
+    case TOK_GREATERTHAN: return "(" + x + " > " + y + ")";
+    default:              throw "unknown operator";
+    }
+}
+
+// A C literal that reads back as exactly r
+string cRealLiteral(double r) {
+    char text[64];
+    if (isfinite(r))
+        snprintf(text, sizeof text, "%a", r);
+    else {
+        uint64_t bits;
+        memcpy(&bits, &r, sizeof bits);
+        snprintf(text, sizeof text, "tips_real_bits(UINT64_C(0x%016llx))", (unsigned long long)bits);
+    }
+    return text;
+}
+
+string cStringLiteral(const string& s) {
+    string lit = "\"";
+    for (unsigned char ch : s) {
+        if (ch == '"' || ch == '\\') {
+            lit += '\\';
+            lit += ch;
+        }
+        else if (ch < ' ' || ch >= 0x7F) {
+            char octal[8];
+            snprintf(octal, sizeof octal, "\\%03o", ch);
+            lit += octal;
+        }
+        else
+            lit += ch;
+    }
+    return lit + "\"";
+}
+
+void CEmitter::program(ProgramNode& pn) {
+    names = &pn.block->variables;
+    types = &pn.block->variableTypes;
+    os << "/* PROGRAM " << *pn.id << ", translated by tips_parse --emit-c */" << endl;
+    os << cRuntime << endl;
+    os << "int main(void) {" << endl;
+    for (size_t slot = 0; slot < names->size(); ++slot) {
+        indent();
+        if ((*types)[slot] == TYPE_REAL) os << "double " << variable(slot) << " = 0.0;" << endl;
+        else os << "int64_t " << variable(slot) << " = 0;" << endl;
+    }
+    statement(*pn.block->firstCompound);
+    indent();
+    os << "return EXIT_SUCCESS;" << endl;
+    os << "}" << endl;
+}
+
+void CEmitter::statements(const vector<StatementNode*>& list) {
+    for (StatementNode* s : list)
+        statement(*s);
+}
+
+void CEmitter::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        string value = expression(*an.expression);
+        if ((*types)[an.slot] == TYPE_REAL && an.expression->type != TYPE_REAL)
+            value = "(double)" + value;
+        indent();
+        os << variable(an.slot) << " = " << value << ";" << endl;
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        statement(*cn.firstStatement);
+        statements(cn.restStatements);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        indent();
+        os << "if (" << expression(*in.expression) << " != 0) {" << endl;
+        ++depth;
+        statements(in.firstStatement);
+        --depth;
+        if (!in.restStatements.empty()) {
+            indent();
+            os << "}" << endl;
+            indent();
+            os << "else {" << endl;
+            ++depth;
+            statements(in.restStatements);
+            --depth;
+        }
+        indent();
+        os << "}" << endl;
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        indent();
+        os << "while (" << expression(*wn.expression) << " != 0) {" << endl;
+        ++depth;
+        statement(*wn.firstStatement);
+        --depth;
+        indent();
+        os << "}" << endl;
+        break;
+    }
+    case FOR_NODE: {
+        // the bounds are computed once, start first
+        ForNode& fn = (ForNode&)sn;
+        string first = "tips_first" + to_string(depth), last = "tips_last" + to_string(depth);
+        indent();
+        os << "{" << endl;
+        ++depth;
+        indent();
+        os << "int64_t " << first << " = " << expression(*fn.start) << ";" << endl;
+        indent();
+        os << "int64_t " << last << " = " << expression(*fn.limit) << ";" << endl;
+        indent();
+        os << variable(fn.slot) << " = " << first << ";" << endl;
+        indent();
+        os << "if (" << first << (fn.down ? " >= " : " <= ") << last << ") {" << endl;
+        ++depth;
+        indent();
+        os << "do {" << endl;
+        ++depth;
+        statement(*fn.firstStatement);
+        --depth;
+        indent();
+        os << "} while (" << (fn.down ? "tips_for_down(&" : "tips_for_up(&") << variable(fn.slot) << ", " << last
+           << "));" << endl;
+        --depth;
+        indent();
+        os << "}" << endl;
+        --depth;
+        indent();
+        os << "}" << endl;
+        break;
+    }
+    case BREAK_NODE:
+        // C's break and continue mean the same; CONTINUE in FOR reaches the
+        // do ... while condition, which steps the variable
+        indent();
+        os << "break;" << endl;
+        break;
+    case CONTINUE_NODE:
+        indent();
+        os << "continue;" << endl;
+        break;
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        indent();
+        os << variable(slot) << " = "
+           << ((*types)[slot] == TYPE_REAL ? "tips_read_real()" : "tips_read_integer()") << ";" << endl;
+        break;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        indent();
+        if (wn.isString())
+            os << "tips_write_string(" << cStringLiteral(wn.operand()) << ");" << endl;
+        else if ((*types)[wn.slot] == TYPE_REAL)
+            os << "tips_write_real(" << variable(wn.slot) << ");" << endl;
+        else
+            os << "tips_write_integer(" << variable(wn.slot) << ");" << endl;
+        break;
+    }
+    default:
+        throw "statement cannot be translated";
+    }
+}
+
+template <class Node>
+string CEmitter::chain(const vector<int>& ops, const vector<TipsType>& opTypes,
+                       string first, TipsType firstType, const vector<Node*>& rest,
+                       string (CEmitter::*operand)(Node&)) {
+    string x = first;
+    TipsType type = firstType;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        string y = (this->*operand)(*rest[i]);
+        if (opTypes[i] == TYPE_REAL) {
+            if (type != TYPE_REAL) x = "(double)" + x;
+            if (rest[i]->type != TYPE_REAL) y = "(double)" + y;
+        }
+        x = cOperation(ops[i], opTypes[i], x, y);
+        type = resultType(ops[i], opTypes[i]);
+    }
+    return x;
+}
+
+string CEmitter::expression(ExprNode& en) {
+    return chain(en.restExpOps, en.opTypes, simpleExpression(*en.simpleExpr), en.simpleExpr->type,
+                 en.restExpr, &CEmitter::simpleExpression);
+}
+
+string CEmitter::simpleExpression(SimpleExprNode& sn) {
+    return chain(sn.restTermOps, sn.opTypes, term(*sn.firstTerm), sn.firstTerm->type,
+                 sn.restTerms, &CEmitter::term);
+}
+
+string CEmitter::term(TermNode& tn) {
+    return chain(tn.restFactorOps, tn.opTypes, factor(*tn.firstFactor), tn.firstFactor->type,
+                 tn.restFactors, &CEmitter::factor);
+}
+
+string CEmitter::factor(FactorNode& fn) {
+    string x;
+    TipsType type;
+    switch (fn.kind) {
+    case ID_NODE: {
+        int slot = ((IdNode&)fn).slot;
+        x = variable(slot);
+        type = (*types)[slot];
+        break;
+    }
+    case INTLIT_NODE:
+        x = "INT64_C(" + to_string(((IntLitNode&)fn).int_literal) + ")";
+        type = TYPE_INTEGER;
+        break;
+    case FLOATLIT_NODE:
+        x = cRealLiteral(((FloatLitNode&)fn).double_literal);
+        type = TYPE_REAL;
+        break;
+    case NESTED_EXPR_NODE:
+        x = expression(*((NestedExprNode&)fn).exprPtr);
+        type = ((NestedExprNode&)fn).exprPtr->type;
+        break;
+    default:
+        throw "factor cannot be translated";
+    }
+
+    // innermost operator first
+    for (size_t i = fn.unaryOps.size(); i-- > 0; ) {
+        if (fn.unaryOps[i] == TOK_NOT) {
+            x = "(" + x + " == 0)";
+            type = TYPE_BOOLEAN;
+        }
+        else if (type == TYPE_REAL)
+            x = "(- " + x + ")";
+        else {
+            x = "tips_neg(" + x + ")";
+            type = TYPE_INTEGER;
+        }
+    }
+    return x;
+}
+
+#endif /* C_EMITTER_H */
@@ -0,0 +1,245 @@
+//*****************************************************************************
+// Binary bytecode format
+//
+// A compiled Chunk saved to a file (--emit-code), so that later runs can
+// map it and start executing (--run-code) without lexing, parsing, type
+// checking or compiling the program again. Loading decodes the sections
+// into a Chunk and checks every operand against the frame, so a damaged or
+// hand-made file is rejected rather than executed.
+//
+// Layout (little endian, sections 8-byte aligned):
+//
+//   CodeHeader                     magic, version, frame, section offsets
+//   CodeInstr ... CodeInstr        { op | a << 8, b, c }
+//   CodeConst ... CodeConst        the constant registers, in order
+//   string table                   WRITE strings, then variable names:
+//                                  { uint32 length; char text[length]; '\0' }
+//   uint32 ... uint32              TipsType of every variable
+//*****************************************************************************
+#ifndef CHUNK_FILE_H
+#define CHUNK_FILE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+
+using namespace std;
+
+const char     CODE_MAGIC[8] = {'T', 'I', 'P', 'S', 'C', 'O', 'D', 'E'};
+const uint32_t CODE_VERSION  = 2;
+const uint32_t CODE_MAX_REGS = 1 << 24;  // what Instr::a can name
+
+struct CodeHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t fileSize;
+    uint32_t numVars;
+    uint32_t numRegs;
+    uint32_t codeCount;
+    uint32_t code;         // offset of the instructions
+    uint32_t constCount;
+    uint32_t constants;    // offset of the constants
+    uint32_t stringCount;  // WRITE strings; numVars names follow them
+    uint32_t strings;      // offset of the string table
+    uint32_t types;        // offset of the variable types
+    uint32_t reserved;
+};
+
+struct CodeInstr {
+    uint32_t opA;  // op in the low 8 bits, a above
+    uint32_t b;
+    uint32_t c;
+};
+
+struct CodeConst {
+    int64_t  bits;  // the INTEGER, or the REAL's bits
+    uint32_t isReal;
+    uint32_t reserved;
+};
+
+//*****************************************************************************
+// Writer: serializes a Chunk into a byte vector
+class ChunkWriter {
+public:
+    vector<char> image;
+
+    vector<char> write(const Chunk& chunk);
+
+    uint32_t section();
+    void append(const void* data, size_t n);
+    void text(const string& s);
+};
+
+uint32_t ChunkWriter::section() {
+    while (image.size() % 8) image.push_back('\0');
+    return image.size();
+}
+
+void ChunkWriter::append(const void* data, size_t n) {
+    image.insert(image.end(), (const char*)data, (const char*)data + n);
+}
+
+void ChunkWriter::text(const string& s) {
+    uint32_t length = s.size();
+    append(&length, sizeof length);
+    append(s.data(), s.size());
+    image.push_back('\0');
+    while (image.size() % 4) image.push_back('\0');
+}
+
+vector<char> ChunkWriter::write(const Chunk& chunk) {
+    CodeHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, CODE_MAGIC, sizeof header.magic);
+    header.version = CODE_VERSION;
+    header.numVars = chunk.numVars;
+    header.numRegs = chunk.numRegs;
+    image.assign(sizeof header, '\0');
+
+    header.code = section();
+    header.codeCount = chunk.code.size();
+    for (const Instr& in : chunk.code) {
+        CodeInstr ci = {in.op | (uint32_t)in.a << 8, in.b, in.c};
+        append(&ci, sizeof ci);
+    }
+
+    header.constants = section();
+    header.constCount = chunk.constants.size();
+    for (const Value& v : chunk.constants) {
+        CodeConst cc;
+        memset(&cc, 0, sizeof cc);
+        cc.isReal = v.isReal;
+        memcpy(&cc.bits, v.isReal ? (const void*)&v.r : (const void*)&v.i, sizeof cc.bits);
+        append(&cc, sizeof cc);
+    }
+
+    header.strings = section();
+    header.stringCount = chunk.strings.size();
+    for (const string& s : chunk.strings)
+        text(s);
+    for (const string& name : chunk.varNames)
+        text(name);
+
+    header.types = section();
+    for (TipsType t : chunk.varTypes) {
+        uint32_t type = t;
+        append(&type, sizeof type);
+    }
+
+    section();
+    header.fileSize = image.size();
+    memcpy(image.data(), &header, sizeof header);
+    return image;
+}
+
+//*****************************************************************************
+// Reader: the Chunk saved in a mapped file, or false if the file is not one
+// this build can run
+class ChunkReader {
+public:
+    const char* base = nullptr;
+    size_t size = 0;
+
+    bool read(const void* data, size_t n, Chunk& chunk);
+
+    bool fits(uint32_t offset, uint64_t bytes) const { return offset <= size && bytes <= size - offset; }
+    bool text(uint32_t& at, string& s) const;
+    bool operand(OperandKind kind, uint32_t value, const Chunk& chunk) const;
+};
+
+// The string at offset at, which moves on to the next one
+bool ChunkReader::text(uint32_t& at, string& s) const {
+    uint32_t length;
+    if (!fits(at, sizeof length)) return false;
+    memcpy(&length, base + at, sizeof length);
+    if (!fits(at + sizeof length, (uint64_t)length + 1) || base[at + sizeof length + length] != '\0')
+        return false;
+    s.assign(base + at + sizeof length, length);
+    at += (sizeof length + length + 1 + 3) & ~3u;
+    return true;
+}
+
+bool ChunkReader::operand(OperandKind kind, uint32_t value, const Chunk& chunk) const {
+    switch (kind) {
+    case OPND_R: return value < chunk.numRegs;
+    case OPND_J: return value < chunk.code.size();
+    case OPND_S: return value < chunk.strings.size();
+    case OPND_I: return value >= 1 && value <= 62;  // shift counts
+    default:     return true;
+    }
+}
+
+bool ChunkReader::read(const void* data, size_t n, Chunk& chunk) {
+    base = (const char*)data;
+    size = n;
+    CodeHeader header;
+    if (size < sizeof header) return false;
+    memcpy(&header, base, sizeof header);
+    if (memcmp(header.magic, CODE_MAGIC, sizeof header.magic) != 0 || header.version != CODE_VERSION ||
+        header.fileSize != size)
+        return false;
+    if (!fits(header.code, (uint64_t)header.codeCount * sizeof(CodeInstr)) ||
+        !fits(header.constants, (uint64_t)header.constCount * sizeof(CodeConst)) ||
+        !fits(header.types, (uint64_t)header.numVars * sizeof(uint32_t)) ||
+        !fits(header.strings, ((uint64_t)header.stringCount + header.numVars) * 8))  // 8 bytes or more each
+        return false;
+    if ((uint64_t)header.numVars + header.constCount > header.numRegs || header.numRegs > CODE_MAX_REGS ||
+        header.codeCount == 0)
+        return false;
+
+    chunk = Chunk();
+    chunk.numVars = header.numVars;
+    chunk.numRegs = header.numRegs;
+
+    uint32_t at = header.strings;
+    chunk.strings.resize(header.stringCount);
+    for (string& s : chunk.strings)
+        if (!text(at, s)) return false;
+    chunk.varNames.resize(header.numVars);
+    for (string& name : chunk.varNames)
+        if (!text(at, name)) return false;
+
+    const char* types = base + header.types;
+    for (uint32_t k = 0; k < header.numVars; ++k) {
+        uint32_t type;
+        memcpy(&type, types + k * sizeof type, sizeof type);
+        if (type < TYPE_INTEGER || type > TYPE_BOOLEAN) return false;
+        chunk.varTypes.push_back((TipsType)type);
+    }
+
+    const char* consts = base + header.constants;
+    for (uint32_t k = 0; k < header.constCount; ++k) {
+        CodeConst cc;
+        memcpy(&cc, consts + k * sizeof cc, sizeof cc);
+        Value v = Value::integer(cc.bits);
+        if (cc.isReal) {
+            v.isReal = true;
+            memcpy(&v.r, &cc.bits, sizeof v.r);
+        }
+        chunk.constants.push_back(v);
+    }
+
+    // every operand stays inside the frame, the code and the strings, and
+    // the code cannot run off its end
+    const char* code = base + header.code;
+    chunk.code.resize(header.codeCount);
+    for (uint32_t pc = 0; pc < header.codeCount; ++pc) {
+        CodeInstr ci;
+        memcpy(&ci, code + pc * sizeof ci, sizeof ci);
+        Instr& in = chunk.code[pc];
+        in.op = ci.opA & 0xFF;
+        in.a = ci.opA >> 8;
+        in.b = ci.b;
+        in.c = ci.c;
+        if (in.op >= OP_COUNT) return false;
+        const OpcodeInfo& info = opcodeInfo[in.op];
+        if (!operand(info.a, in.a, chunk) || !operand(info.b, in.b, chunk) || !operand(info.c, in.c, chunk))
+            return false;
+    }
+    const Instr& last = chunk.code.back();
+    return last.op == OP_HALT || last.op == OP_JMP;
+}
+
+#endif /* CHUNK_FILE_H */
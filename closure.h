@@ -0,0 +1,536 @@
+//*****************************************************************************
+// Closure-compiling evaluator
+//
+// A middle ground between the tree walker and the bytecode VM. One pass over
+// the type checked tree turns every expression into a closure: a function
+// pointer together with its operands, already resolved. An operand is bound
+// as a variable slot, a constant or the closure of a subexpression, and the
+// function is instantiated for that combination and for the operator's
+// type, so evaluating a node is one indirect call that reads its operands
+// in place. Statements become closures the same way and the tree is not
+// looked at again while the program runs.
+//
+// Closures are plain records rather than std::function objects: calling one
+// costs the same in a debug build as in an optimized one.
+//*****************************************************************************
+#ifndef CLOSURE_H
+#define CLOSURE_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bytecode.h"
+#include "parse_tree_nodes.h"
+#include "runtime.h"
+#include "typecheck.h"
+
+using namespace std;
+
+// How a closure gets an operand
+enum OperandMode { FROM_CLOSURE, FROM_SLOT, FROM_CONST };
+
+struct Closure {
+    Slot (*fn)(const Closure* c, Slot* v) = nullptr;
+    const Closure* x = nullptr;  // operand closures
+    const Closure* y = nullptr;
+    int sx = -1, sy = -1;        // operand slots
+    Slot kx = Slot(), ky = Slot();  // operand constants
+};
+
+struct Action {
+    Flow (*fn)(const Action* a, Slot* v) = nullptr;
+    const Closure* e = nullptr;      // the expression assigned or tested, FOR's start
+    const Closure* limit = nullptr;  // FOR's limit
+    bool realCond = false;           // whether e is REAL (IF / WHILE)
+    bool down = false;               // FOR ... DOWNTO
+    int slot = -1;
+    const Action* body = nullptr;       // THEN / loop body
+    const Action* otherwise = nullptr;  // ELSE
+    vector<const Action*> list;         // compound statement
+    Runtime* rt = nullptr;
+    string_view text;                   // WRITE of a string, in the tree
+};
+
+template <int mode>
+TIPS_ALWAYS_INLINE Slot operandX(const Closure* c, Slot* v) {
+    return mode == FROM_SLOT ? v[c->sx] : mode == FROM_CONST ? c->kx : c->x->fn(c->x, v);
+}
+
+template <int mode>
+TIPS_ALWAYS_INLINE Slot operandY(const Closure* c, Slot* v) {
+    return mode == FROM_SLOT ? v[c->sy] : mode == FROM_CONST ? c->ky : c->y->fn(c->y, v);
+}
+
+// Both operands are fetched before the operator applies, in order, like
+// the other engines evaluate them
+template <class Op, int mx, int my>
+Slot binaryClosure(const Closure* c, Slot* v) {
+    Slot a = operandX<mx>(c, v);
+    Slot b = operandY<my>(c, v);
+    Slot r;
+    Op::apply(r, a, b);
+    return r;
+}
+
+template <class Op, int mx>
+Slot unaryClosure(const Closure* c, Slot* v) {
+    Slot a = operandX<mx>(c, v);
+    Slot r;
+    Op::apply(r, a, a);
+    return r;
+}
+
+//*****************************************************************************
+// Operators
+#define TIPS_CLOSURE_OP(name, body) \
+    struct name { static TIPS_ALWAYS_INLINE void apply(Slot& r, Slot a, Slot b) { (void)b; body; } };
+
+TIPS_CLOSURE_OP(AddI, r.i = addI(a.i, b.i))
+TIPS_CLOSURE_OP(SubI, r.i = subI(a.i, b.i))
+TIPS_CLOSURE_OP(MulI, r.i = mulI(a.i, b.i))
+TIPS_CLOSURE_OP(DivI, r.i = divI(a.i, b.i))
+TIPS_CLOSURE_OP(ModI, r.i = modI(a.i, b.i))
+TIPS_CLOSURE_OP(AddF, r.f = a.f + b.f)
+TIPS_CLOSURE_OP(SubF, r.f = a.f - b.f)
+TIPS_CLOSURE_OP(MulF, r.f = a.f * b.f)
+TIPS_CLOSURE_OP(DivF, r.f = a.f / b.f)
+TIPS_CLOSURE_OP(EqI, r.i = a.i == b.i)
+TIPS_CLOSURE_OP(NeI, r.i = a.i != b.i)
+TIPS_CLOSURE_OP(LtI, r.i = a.i < b.i)
+TIPS_CLOSURE_OP(GtI, r.i = a.i > b.i)
+TIPS_CLOSURE_OP(EqF, r.i = a.f == b.f)
+TIPS_CLOSURE_OP(NeF, r.i = a.f != b.f)
+TIPS_CLOSURE_OP(LtF, r.i = a.f < b.f)
+TIPS_CLOSURE_OP(GtF, r.i = a.f > b.f)
+TIPS_CLOSURE_OP(And, r.i = a.i != 0 && b.i != 0)
+TIPS_CLOSURE_OP(Or, r.i = a.i != 0 || b.i != 0)
+TIPS_CLOSURE_OP(NegI, r.i = negI(a.i))
+TIPS_CLOSURE_OP(NegF, r.f = -a.f)
+TIPS_CLOSURE_OP(Not, r.i = a.i == 0)
+TIPS_CLOSURE_OP(TruthF, r.i = a.f != 0)
+TIPS_CLOSURE_OP(IntToReal, r.f = (double)a.i)
+TIPS_CLOSURE_OP(Load, r = a)
+
+#undef TIPS_CLOSURE_OP
+
+typedef Slot (*ClosureFn)(const Closure* c, Slot* v);
+
+template <class Op>
+ClosureFn binaryFn(int mx, int my) {
+    static const ClosureFn table[3][3] = {
+        {binaryClosure<Op, 0, 0>, binaryClosure<Op, 0, 1>, binaryClosure<Op, 0, 2>},
+        {binaryClosure<Op, 1, 0>, binaryClosure<Op, 1, 1>, binaryClosure<Op, 1, 2>},
+        {binaryClosure<Op, 2, 0>, binaryClosure<Op, 2, 1>, binaryClosure<Op, 2, 2>},
+    };
+    return table[mx][my];
+}
+
+template <class Op>
+ClosureFn unaryFn(int mx) {
+    static const ClosureFn table[3] = {unaryClosure<Op, 0>, unaryClosure<Op, 1>, unaryClosure<Op, 2>};
+    return table[mx];
+}
+
+//*****************************************************************************
+// Statements
+// Each returns how the statement ended (Flow); a loop stops at FLOW_BREAK
+// and goes on with its next iteration at FLOW_CONTINUE
+Flow assignAction(const Action* a, Slot* v) {
+    v[a->slot] = a->e->fn(a->e, v);
+    return FLOW_NEXT;
+}
+
+Flow compoundAction(const Action* a, Slot* v) {
+    for (const Action* s : a->list)
+        if (Flow f = s->fn(s, v))
+            return f;
+    return FLOW_NEXT;
+}
+
+TIPS_ALWAYS_INLINE bool holds(const Action* a, Slot* v) {
+    Slot c = a->e->fn(a->e, v);
+    return a->realCond ? c.f != 0 : c.i != 0;
+}
+
+Flow ifAction(const Action* a, Slot* v) {
+    if (holds(a, v)) return a->body->fn(a->body, v);
+    if (a->otherwise) return a->otherwise->fn(a->otherwise, v);
+    return FLOW_NEXT;
+}
+
+Flow whileAction(const Action* a, Slot* v) {
+    if (!holds(a, v)) return FLOW_NEXT;
+    if (a->body->fn(a->body, v) == FLOW_BREAK) return FLOW_NEXT;
+    while (holds(a, v)) {
+        a->rt->backEdge();
+        if (a->body->fn(a->body, v) == FLOW_BREAK) break;
+    }
+    return FLOW_NEXT;
+}
+
+Flow forAction(const Action* a, Slot* v) {
+    int64_t start = a->e->fn(a->e, v).i;
+    int64_t limit = a->limit->fn(a->limit, v).i;
+    v[a->slot].i = start;
+    if (start != limit && !forContinues(start, limit, a->down)) return FLOW_NEXT;
+    for (;;) {
+        if (a->body->fn(a->body, v) == FLOW_BREAK) break;
+        int64_t i = v[a->slot].i;
+        v[a->slot].i = forNext(i, a->down);
+        if (!forContinues(i, limit, a->down)) break;
+        a->rt->backEdge();
+    }
+    return FLOW_NEXT;
+}
+
+Flow breakAction(const Action*, Slot*) { return FLOW_BREAK; }
+Flow continueAction(const Action*, Slot*) { return FLOW_CONTINUE; }
+
+Flow readIntegerAction(const Action* a, Slot* v) {
+    v[a->slot].i = a->rt->readInteger();
+    return FLOW_NEXT;
+}
+
+Flow readRealAction(const Action* a, Slot* v) {
+    v[a->slot].f = a->rt->readReal();
+    return FLOW_NEXT;
+}
+
+Flow writeIntegerAction(const Action* a, Slot* v) {
+    a->rt->writeInteger(v[a->slot].i);
+    return FLOW_NEXT;
+}
+
+Flow writeRealAction(const Action* a, Slot* v) {
+    a->rt->writeReal(v[a->slot].f);
+    return FLOW_NEXT;
+}
+
+Flow writeStringAction(const Action* a, Slot*) {
+    a->rt->writeString(a->text);
+    return FLOW_NEXT;
+}
+
+//*****************************************************************************
+// Compiler from the tree to closures. The closures live as long as the
+// compiler that made them.
+class ClosureCompiler {
+public:
+    // An operand while compiling: a variable or constant is not given a
+    // closure unless something needs one
+    struct Operand {
+        TipsType type = TYPE_NONE;
+        OperandMode mode = FROM_CLOSURE;
+        const Closure* c = nullptr;
+        int slot = -1;
+        Slot k = Slot();
+    };
+
+    Runtime& rt;
+    const vector<TipsType>* types = nullptr;
+    deque<Closure> closures;
+    deque<Action> actions;
+    unordered_map<const void*, Operand> shared;  // per hash-consed node, see hash_cons.h
+
+    ClosureCompiler(Runtime& runtime) : rt(runtime) {}
+
+    const Action* program(ProgramNode& pn);
+    const Action* statement(StatementNode& sn);
+    const Action* statements(const vector<StatementNode*>& list);
+
+    Operand expression(ExprNode& en);
+    Operand simpleExpression(SimpleExprNode& sn);
+    Operand term(TermNode& tn);
+    Operand factor(FactorNode& fn);
+    template <class Node>
+    Operand chain(const vector<int>& ops, const vector<TipsType>& opTypes, Operand x,
+                  const vector<Node*>& rest, Operand (ClosureCompiler::*operand)(Node&));
+
+    template <class Node, class Compile>
+    Operand once(Node& node, Compile compile);
+    Operand binary(int op, TipsType opType, const Operand& x, const Operand& y);
+    Operand make(ClosureFn fn, TipsType type, const Operand& x, const Operand& y);
+    Operand toReal(const Operand& x);
+    Operand truth(const Operand& x);
+    const Closure* closure(const Operand& x);
+    Action* action(Flow (*fn)(const Action*, Slot*));
+};
+
+ClosureCompiler::Operand ClosureCompiler::make(ClosureFn fn, TipsType type, const Operand& x, const Operand& y) {
+    closures.emplace_back();
+    Closure& c = closures.back();
+    c.fn = fn;
+    c.x = x.c;
+    c.y = y.c;
+    c.sx = x.slot;
+    c.sy = y.slot;
+    c.kx = x.k;
+    c.ky = y.k;
+    Operand r;
+    r.type = type;
+    r.c = &c;
+    return r;
+}
+
+const Closure* ClosureCompiler::closure(const Operand& x) {
+    if (x.mode == FROM_CLOSURE)
+        return x.c;
+    return make(unaryFn<Load>(x.mode), x.type, x, x).c;
+}
+
+ClosureCompiler::Operand ClosureCompiler::toReal(const Operand& x) {
+    if (x.type == TYPE_REAL)
+        return x;
+    if (x.mode == FROM_CONST) {
+        Operand r = x;
+        r.type = TYPE_REAL;
+        r.k.f = (double)x.k.i;
+        return r;
+    }
+    return make(unaryFn<IntToReal>(x.mode), TYPE_REAL, x, x);
+}
+
+// A REAL operand of AND, OR or NOT as a BOOLEAN
+ClosureCompiler::Operand ClosureCompiler::truth(const Operand& x) {
+    if (x.type != TYPE_REAL)
+        return x;
+    return make(unaryFn<TruthF>(x.mode), TYPE_BOOLEAN, x, x);
+}
+
+ClosureCompiler::Operand ClosureCompiler::binary(int op, TipsType opType, const Operand& x, const Operand& y) {
+    int mx = x.mode, my = y.mode;
+    if (opType == TYPE_REAL) {
+        switch (op) {
+        case TOK_PLUS:        return make(binaryFn<AddF>(mx, my), TYPE_REAL, x, y);
+        case TOK_MINUS:       return make(binaryFn<SubF>(mx, my), TYPE_REAL, x, y);
+        case TOK_MULTIPLY:    return make(binaryFn<MulF>(mx, my), TYPE_REAL, x, y);
+        case TOK_DIVIDE:      return make(binaryFn<DivF>(mx, my), TYPE_REAL, x, y);
+        case TOK_EQUALTO:     return make(binaryFn<EqF>(mx, my), TYPE_BOOLEAN, x, y);
+        case TOK_NOTEQUALTO:  return make(binaryFn<NeF>(mx, my), TYPE_BOOLEAN, x, y);
+        case TOK_LESSTHAN:    return make(binaryFn<LtF>(mx, my), TYPE_BOOLEAN, x, y);
+        case TOK_GREATERTHAN: return make(binaryFn<GtF>(mx, my), TYPE_BOOLEAN, x, y);
+        default:              break;
+        }
+    }
+    switch (op) {
+    case TOK_PLUS:        return make(binaryFn<AddI>(mx, my), TYPE_INTEGER, x, y);
+    case TOK_MINUS:       return make(binaryFn<SubI>(mx, my), TYPE_INTEGER, x, y);
+    case TOK_MULTIPLY:    return make(binaryFn<MulI>(mx, my), TYPE_INTEGER, x, y);
+    case TOK_DIVIDE:      return make(binaryFn<DivI>(mx, my), TYPE_INTEGER, x, y);
+    case TOK_MOD:         return make(binaryFn<ModI>(mx, my), TYPE_INTEGER, x, y);
+    case TOK_EQUALTO:     return make(binaryFn<EqI>(mx, my), TYPE_BOOLEAN, x, y);
+    case TOK_NOTEQUALTO:  return make(binaryFn<NeI>(mx, my), TYPE_BOOLEAN, x, y);
+    case TOK_LESSTHAN:    return make(binaryFn<LtI>(mx, my), TYPE_BOOLEAN, x, y);
+    case TOK_GREATERTHAN: return make(binaryFn<GtI>(mx, my), TYPE_BOOLEAN, x, y);
+    case TOK_AND: case TOK_OR: {
+        Operand a = truth(x), b = truth(y);
+        ClosureFn fn = op == TOK_AND ? binaryFn<And>(a.mode, b.mode) : binaryFn<Or>(a.mode, b.mode);
+        return make(fn, TYPE_BOOLEAN, a, b);
+    }
+    default:
+        throw "unknown operator";
+    }
+}
+
+template <class Node>
+ClosureCompiler::Operand ClosureCompiler::chain(const vector<int>& ops, const vector<TipsType>& opTypes,
+                                                Operand x, const vector<Node*>& rest,
+                                                Operand (ClosureCompiler::*operand)(Node&)) {
+    for (size_t i = 0; i < ops.size(); ++i) {
+        Operand y = (this->*operand)(*rest[i]);
+        if (opTypes[i] == TYPE_REAL) {
+            x = toReal(x);
+            y = toReal(y);
+        }
+        x = binary(ops[i], opTypes[i], x, y);
+    }
+    return x;
+}
+
+// A subtree shared by several parents compiles to one closure, which they
+// all use: closures read their operands and nothing else
+template <class Node, class Compile>
+ClosureCompiler::Operand ClosureCompiler::once(Node& node, Compile compile) {
+    if (!node.shared)
+        return compile();
+    auto found = shared.find(&node);
+    if (found != shared.end())
+        return found->second;
+    Operand x = compile();
+    shared[&node] = x;
+    return x;
+}
+
+ClosureCompiler::Operand ClosureCompiler::expression(ExprNode& en) {
+    return once(en, [&] {
+        return chain(en.restExpOps, en.opTypes, simpleExpression(*en.simpleExpr), en.restExpr,
+                     &ClosureCompiler::simpleExpression);
+    });
+}
+
+ClosureCompiler::Operand ClosureCompiler::simpleExpression(SimpleExprNode& sn) {
+    return once(sn, [&] {
+        return chain(sn.restTermOps, sn.opTypes, term(*sn.firstTerm), sn.restTerms, &ClosureCompiler::term);
+    });
+}
+
+ClosureCompiler::Operand ClosureCompiler::term(TermNode& tn) {
+    return once(tn, [&] {
+        return chain(tn.restFactorOps, tn.opTypes, factor(*tn.firstFactor), tn.restFactors, &ClosureCompiler::factor);
+    });
+}
+
+ClosureCompiler::Operand ClosureCompiler::factor(FactorNode& fn) {
+    Operand x;
+    switch (fn.kind) {
+    case ID_NODE:
+        x.mode = FROM_SLOT;
+        x.slot = ((IdNode&)fn).slot;
+        x.type = (*types)[x.slot];
+        break;
+    case INTLIT_NODE:
+        x.mode = FROM_CONST;
+        x.type = TYPE_INTEGER;
+        x.k.i = ((IntLitNode&)fn).int_literal;
+        break;
+    case FLOATLIT_NODE:
+        x.mode = FROM_CONST;
+        x.type = TYPE_REAL;
+        x.k.f = ((FloatLitNode&)fn).double_literal;
+        break;
+    case NESTED_EXPR_NODE:
+        x = expression(*((NestedExprNode&)fn).exprPtr);
+        break;
+    default:
+        throw "factor cannot be compiled";
+    }
+
+    // innermost operator first
+    for (size_t i = fn.unaryOps.size(); i-- > 0; ) {
+        if (fn.unaryOps[i] == TOK_NOT) {
+            Operand a = truth(x);
+            x = make(unaryFn<Not>(a.mode), TYPE_BOOLEAN, a, a);
+        }
+        else if (x.type == TYPE_REAL)
+            x = make(unaryFn<NegF>(x.mode), TYPE_REAL, x, x);
+        else
+            x = make(unaryFn<NegI>(x.mode), TYPE_INTEGER, x, x);
+    }
+    return x;
+}
+
+Action* ClosureCompiler::action(Flow (*fn)(const Action*, Slot*)) {
+    actions.emplace_back();
+    actions.back().fn = fn;
+    actions.back().rt = &rt;
+    return &actions.back();
+}
+
+const Action* ClosureCompiler::program(ProgramNode& pn) {
+    types = &pn.block->variableTypes;
+    return statement(*pn.block->firstCompound);
+}
+
+const Action* ClosureCompiler::statements(const vector<StatementNode*>& list) {
+    if (list.size() == 1)
+        return statement(*list[0]);
+    Action* a = action(compoundAction);
+    for (StatementNode* s : list)
+        a->list.push_back(statement(*s));
+    return a;
+}
+
+const Action* ClosureCompiler::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        Operand x = expression(*an.expression);
+        if ((*types)[an.slot] == TYPE_REAL)
+            x = toReal(x);
+        Action* a = action(assignAction);
+        a->slot = an.slot;
+        a->e = closure(x);
+        return a;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        vector<StatementNode*> list(1, cn.firstStatement);
+        list.insert(list.end(), cn.restStatements.begin(), cn.restStatements.end());
+        return statements(list);
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        Operand cond = expression(*in.expression);
+        Action* a = action(ifAction);
+        a->e = closure(cond);
+        a->realCond = cond.type == TYPE_REAL;
+        a->body = statements(in.firstStatement);
+        if (!in.restStatements.empty())
+            a->otherwise = statements(in.restStatements);
+        return a;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        Operand cond = expression(*wn.expression);
+        Action* a = action(whileAction);
+        a->e = closure(cond);
+        a->realCond = cond.type == TYPE_REAL;
+        a->body = statement(*wn.firstStatement);
+        return a;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        Action* a = action(forAction);
+        a->e = closure(expression(*fn.start));
+        a->limit = closure(expression(*fn.limit));
+        a->slot = fn.slot;
+        a->down = fn.down;
+        a->body = statement(*fn.firstStatement);
+        return a;
+    }
+    case BREAK_NODE:
+        return action(breakAction);
+    case CONTINUE_NODE:
+        return action(continueAction);
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        Action* a = action((*types)[slot] == TYPE_REAL ? readRealAction : readIntegerAction);
+        a->slot = slot;
+        return a;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        if (wn.isString()) {
+            Action* a = action(writeStringAction);
+            a->text = wn.text();
+            return a;
+        }
+        Action* a = action((*types)[wn.slot] == TYPE_REAL ? writeRealAction : writeIntegerAction);
+        a->slot = wn.slot;
+        return a;
+    }
+    default:
+        throw "statement cannot be compiled";
+    }
+}
+
+//*****************************************************************************
+// Compiles the program, then runs it on a fresh set of variables
+class ClosureEvaluator {
+public:
+    Runtime& rt;
+    vector<Slot> vars;
+
+    ClosureEvaluator(Runtime& runtime) : rt(runtime) {}
+
+    void run(ProgramNode& pn) {
+        ClosureCompiler compiler(rt);
+        const Action* program = compiler.program(pn);
+        vars.assign(pn.block->variables.size(), Slot());
+        program->fn(program, vars.data());
+    }
+};
+
+#endif /* CLOSURE_H */
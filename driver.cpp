@@ -6,15 +6,45 @@
 #endif
 
 #include <stdio.h>
+#include <unistd.h>
 #include <iostream>
 #include <string>
 #include <set>
+#include <sstream>
+#include <fstream>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include <memory>
 
 using namespace std;
 
 #include "lexer.h"
 #include "productions.h"
+#include "hash_cons.h"
 #include "parse_tree_nodes.h"
+#include "tree_writer.h"
+#include "ast_binary.h"
+#include "parse_cache.h"
+#include "tree_diff.h"
+#include "typecheck.h"
+#include "runtime.h"
+#include "evaluator.h"
+#include "optimize.h"
+#include "bytecode.h"
+#include "vm.h"
+#include "ir.h"
+#include "ir_passes.h"
+#include "ir_codegen.h"
+#include "closure.h"
+#include "jit.h"
+#include "c_emitter.h"
+#include "asm_emitter.h"
+#include "lanes.h"
+#include "shards.h"
+#include "chunk_file.h"
+#include "vm_profile.h"
+#include "watchdog.h"
 
 extern "C" {
     // Instantiate global variables
@@ -36,18 +66,698 @@ extern int nextToken; // token returned from yylex
 set<string> symbolTable; // Symbol Table
 
 
+//*****************************************************************************
+// Prints each top-level statement of a streaming parse as soon as it has been
+// parsed. The output matches the in-order traversal of the full parse tree.
+class StatementPrinter : public ParseListener {
+public:
+    ostream& os;
+    TreeWriter writer;
+
+    StatementPrinter(ostream& out) : os(out) {}
+    void flush() {
+        os.write(writer.out.buf, writer.out.len);
+        writer.out.clear();
+    }
+    void onProgram(const string& name) {
+        writer.out.lit("Program Name ");
+        writer.out.append(name);
+        writer.out.lit("\nBegin Compound Statement\n");
+    }
+    void onStatement(StatementNode& stmt) {
+        writer.statement(stmt);
+        if (writer.out.len > 32 * 1024) flush();
+    }
+    void onEnd() {
+        writer.out.lit("End Compound Statement\n");
+        flush();
+    }
+};
+
+
+//*****************************************************************************
+// --bench: time the in-order dump through the operator<< chain against
+// TreeWriter and check that both produce the same bytes
+void benchTreeDump(ProgramNode& root) {
+    const chrono::duration<double> budget(0.5);  // per method, or 200 runs
+    string reference, fast;
+    int slowRuns = 0, fastRuns = 0;
+
+    auto start = chrono::steady_clock::now();
+    do {
+        ostringstream os;
+        os << root << endl << endl;
+        reference = os.str();
+        ++slowRuns;
+    } while (slowRuns < 200 && chrono::steady_clock::now() - start < budget);
+    auto middle = chrono::steady_clock::now();
+    do {
+        TreeWriter writer;
+        writer.program(root);
+        writer.out.lit("\n\n");
+        fast.assign(writer.out.buf, writer.out.len);
+        ++fastRuns;
+    } while (fastRuns < 200 && chrono::steady_clock::now() - middle < budget);
+    auto stop = chrono::steady_clock::now();
+
+    double slow_us = chrono::duration<double, micro>(middle - start).count() / slowRuns;
+    double fast_us = chrono::duration<double, micro>(stop - middle).count() / fastRuns;
+    fprintf(stderr, "BENCH: tree dump via operator<<  %12.2f us\n", slow_us);
+    fprintf(stderr, "BENCH: tree dump via TreeWriter  %12.2f us (%.1fx, output %s)\n",
+            fast_us, slow_us / fast_us, reference == fast ? "identical" : "DIFFERS");
+}
+
+
+//*****************************************************************************
+// Print diagnostics in the classic ***ERROR format
+void reportDiagnostics(const vector<Diagnostic>& diags) {
+    for (const Diagnostic& d : diags) {
+        cout << endl << "***ERROR:" << endl;
+        cout << "On line number " << d.line << ", near " << d.nearText << ", error type ";
+        cout << d.message << endl;
+    }
+    if (maxErrors != 1)
+        cout << endl << diags.size() << " error(s) found" << endl;
+}
+
+
+//*****************************************************************************
+// --batch: parse many files, printing the diagnostics or the in-order
+// traversal of each. Results come from the parse cache when the same source
+// was parsed before by the same parser version.
+int runBatch(const vector<char*>& files, ParseCache* cache) {
+    int failures = 0;
+    TreeWriter writer;
+
+    for (char* path : files) {
+        MappedFile source;
+        if (!source.open(path)) {
+            cout << "=== " << path << " ===" << endl << "ERROR: input file not found" << endl;
+            ++failures;
+            continue;
+        }
+
+        uint64_t key = 0;
+        MappedFile entry;
+        vector<Diagnostic> diags;
+        AstView ast;
+        vector<char> image;
+        bool hit = false;
+
+        if (cache) {
+            key = cache->key(source.data, source.size, maxErrors);
+            hit = cache->lookup(key, source.size, entry, diags, ast);
+        }
+
+        if (!hit) {
+            FILE* in = fmemopen(source.data, source.size, "r");
+            cout.setstate(ios::badbit);  // no parse trace or node deletion messages
+            ProgramNode* root = parseProgram(in);
+            diags = diagnostics;
+            if (root) {
+                image = AstWriter().write(*root);
+                ast.open(image.data(), image.size());
+                delete root;
+            }
+            if (exprTable) exprTable->clear();
+            cout.clear();
+            fclose(in);
+            if (cache)
+                cache->store(key, source.size, diags, image);
+        }
+
+        cout << "=== " << path << (!cache ? "" : hit ? " (cached)" : " (parsed)") << " ===" << endl;
+        if (!diags.empty()) {
+            reportDiagnostics(diags);
+            ++failures;
+        }
+        else {
+            writer.out.clear();
+            AstTreeWriter(ast, writer).program(ast.root());
+            cout.write(writer.out.buf, writer.out.len);
+        }
+        cout << endl;
+    }
+
+    if (cache)
+        cout << "Parse cache: " << cache->hits << " hits, " << cache->misses << " misses" << endl;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+
+//*****************************************************************************
+// --diff=OLD: parse OLD and the input file and list what changed between
+// them. A change prints the node as it was (-) and as it is (+): the text of
+// an expression, the first line of a statement.
+string changedText(NodeKind kind, const void* node) {
+    ostringstream os;
+    switch (kind) {
+    case EXPR_NODE:        os << *(ExprNode*)node; break;
+    case SIMPLE_EXPR_NODE: os << *(SimpleExprNode*)node; break;
+    case TERM_NODE:        os << *(TermNode*)node; break;
+    case PROGRAM_NODE:     os << *((ProgramNode*)node)->id; break;
+    case BLOCK_NODE: {
+        BlockNode& bn = *(BlockNode*)node;
+        for (size_t i = 0; i < bn.variables.size(); ++i)
+            os << (i ? ", " : "") << bn.variables[i] << ": " << typeNames[bn.variableTypes[i]];
+        break;
+    }
+    case ID_NODE: case INTLIT_NODE: case FLOATLIT_NODE: case NESTED_EXPR_NODE:
+        os << *(FactorNode*)node;
+        break;
+    default: {
+        os << *(StatementNode*)node;
+        return os.str().substr(0, os.str().find('\n'));
+    }
+    }
+    return os.str();
+}
+
+int runDiff(const char* beforeFile, const char* afterFile, bool bench) {
+    ProgramNode* trees[2] = {nullptr, nullptr};
+    const char* files[2] = {beforeFile, afterFile};
+    for (int i = 0; i < 2; ++i) {
+        FILE* in = fopen(files[i], "r");
+        if (!in) {
+            printf("ERROR: input file not found\n");
+            return EXIT_FAILURE;
+        }
+        cout.setstate(ios::badbit);  // no parse trace
+        trees[i] = parseProgram(in);
+        cout.clear();
+        fclose(in);
+        if (!diagnostics.empty()) {
+            cout << "=== " << files[i] << " ===" << endl;
+            reportDiagnostics(diagnostics);
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    TreeDiff diff;
+    diff.diff(*trees[0], *trees[1]);
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+    static const char* const whatNames[] = {"CHANGED", "ADDED", "REMOVED"};
+    for (const TreeChange& c : diff.changes) {
+        cout << whatNames[c.what] << " " << nodeKindNames[c.kind];
+        if (c.what == TreeChange::CHANGED && c.beforeLine)
+            cout << ", line " << c.beforeLine << " -> " << c.afterLine;
+        else if (c.beforeLine || c.afterLine)
+            cout << ", line " << (c.before ? c.beforeLine : c.afterLine);
+        cout << endl;
+        // both nodes are statements, or both are factors, or of one kind
+        if (c.before) cout << "  - " << changedText(c.kind, c.before) << endl;
+        if (c.after) cout << "  + " << changedText(c.kind, c.after) << endl;
+    }
+    cout << "DIFF: " << diff.changes.size() << " changes, " << diff.compared << " node pairs compared" << endl;
+    if (bench)
+        fprintf(stderr, "DIFF: %.1f us\n", us);
+
+    cout.setstate(ios::badbit);  // no node deletion messages
+    delete trees[0];
+    delete trees[1];
+    if (exprTable) exprTable->clear();
+    cout.clear();
+    return EXIT_SUCCESS;
+}
+
+
+//*****************************************************************************
+// Execution engines. The first one is the reference --check compares against.
+const char* const engineNames[] = {"tree", "closure", "vm", "jit"};
+
+// Bytecode for a program: through the SSA optimizer, or straight from the
+// tree when optimize is off
+Chunk compileChunk(ProgramNode& root, bool optimize, bool bench = false, ostream* irDump = nullptr) {
+    if (!optimize)
+        return BytecodeCompiler().compile(root);
+    IrFunction fn = IrBuilder().build(root);
+    PassManager pm;
+    addStandardPasses(pm);
+    pm.run(fn);
+    if (bench)
+        pm.report(stderr);
+    if (irDump)
+        fn.print(*irDump);
+    return IrCodegen(fn).generate();
+}
+
+// The output is flushed before the chunk goes, as it may still point into
+// the chunk's strings.
+void runEngine(const string& engine, ProgramNode& root, Runtime& rt, bool optimize, bool bench = false) {
+    Chunk chunk;
+    try {
+        if (engine == "tree")
+            TreeEvaluator(rt).run(root);
+        else if (engine == "closure")
+            ClosureEvaluator(rt).run(root);
+        else if (engine == "vm") {
+            chunk = compileChunk(root, optimize, bench);
+            VM(rt).run(chunk);
+        }
+        else if (engine == "jit") {
+            chunk = compileChunk(root, optimize, bench);
+            JIT(rt).run(chunk);
+        }
+        else
+            throw "unknown engine";
+    }
+    catch (char const*) {
+        rt.flush();
+        throw;
+    }
+    rt.flush();
+}
+
+
+//*****************************************************************************
+// Simplify the tree before it is executed. Removed nodes announce their
+// deletion on cout, which is muted meanwhile. A hash-consed tree is left as
+// it is: rewriting a shared node in place would rewrite it for every parent.
+void optimizeTree(ProgramNode& root, bool bench) {
+    if (exprTable)
+        return;
+    ExprOptimizer optimizer;
+    bool muted = cout.bad();
+    cout.setstate(ios::badbit);
+    optimizer.program(root);
+    if (!muted) cout.clear();
+    if (bench)
+        fprintf(stderr, "OPT: %d operators folded, %d simplified\n", optimizer.folded, optimizer.simplified);
+}
+
+
+//*****************************************************************************
+// --max-steps, --max-seconds, --max-output: what a run may use. Every run
+// (every record of --records, every engine of --check) gets budget afresh;
+// the time counts from the first one.
+struct RunLimits {
+    Budget budget;
+    double seconds = 0;  // none when 0
+    unique_ptr<Watchdog> watchdog;
+
+    Budget start() {
+        if (seconds > 0 && !watchdog) {
+            watchdog.reset(new Watchdog(seconds));
+            budget.expired = &watchdog->expired;
+        }
+        return budget;
+    }
+};
+RunLimits limits;
+
+
+//*****************************************************************************
+// --run: execute the program, READ from stdin and WRITE to stdout
+template <class Body>
+int runOnStdio(const string& engine, bool writev, bool bench, Body body) {
+    Runtime rt(cin, cout);
+    rt.budget = limits.start();
+    if (writev) {
+        cout.flush();
+        rt.useWritev(STDOUT_FILENO);
+    }
+    auto start = chrono::steady_clock::now();
+    try {
+        body(rt);
+    }
+    catch (char const* errmsg) {
+        rt.writeError(errmsg);
+        rt.flush();
+        cout.flush();
+        return EXIT_FAILURE;
+    }
+    cout.flush();
+    if (bench) {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "BENCH: %s engine %12.2f ms\n", engine.c_str(), ms);
+    }
+    return EXIT_SUCCESS;
+}
+
+int runProgram(ProgramNode& root, const string& engine, bool optimize, bool writev, bool bench) {
+    return runOnStdio(engine, writev, bench, [&](Runtime& rt) {
+        runEngine(engine, root, rt, optimize, bench);
+    });
+}
+
+// --run --profile=FILE: execute the program on the vm, counting the opcode
+// pairs it runs into FILE
+int runProfiled(ProgramNode& root, const char* profileName, bool optimize, bool bench) {
+    PairProfile profile;
+    if (!profile.load(profileName)) {
+        printf("ERROR: %s is not an opcode pair profile\n", profileName);
+        return EXIT_FAILURE;
+    }
+    vector<uint64_t> pairs;
+    int status = runOnStdio("vm", false, bench, [&](Runtime& rt) {
+        Chunk chunk = compileChunk(root, optimize, bench);
+        try {
+            VM(rt).profile(chunk, pairs);
+        }
+        catch (char const*) {
+            rt.flush();
+            throw;
+        }
+        rt.flush();
+    });
+    if (status != EXIT_SUCCESS)
+        return status;  // a run cut short is no profile of the program
+    profile.add(pairs);
+    if (!profile.save(profileName)) {
+        printf("ERROR: could not write %s\n", profileName);
+        return EXIT_FAILURE;
+    }
+    return status;
+}
+
+// --run-code: execute a saved chunk, which the vm and the jit can run
+int runCode(const char* name, const string& engine, bool writev, bool bench) {
+    MappedFile file;
+    Chunk chunk;
+    if (!file.open(name) || !ChunkReader().read(file.data, file.size, chunk)) {
+        printf("ERROR: %s is not a bytecode file\n", name);
+        return EXIT_FAILURE;
+    }
+    if (engine != "vm" && engine != "jit") {
+        printf("ERROR: the %s engine needs the program, not its bytecode\n", engine.c_str());
+        return EXIT_FAILURE;
+    }
+    return runOnStdio(engine, writev, bench, [&](Runtime& rt) {
+        try {
+            if (engine == "jit") JIT(rt).run(chunk);
+            else VM(rt).run(chunk);
+        }
+        catch (char const*) {
+            rt.flush();
+            throw;
+        }
+        rt.flush();
+    });
+}
+
+
+//*****************************************************************************
+// --records: run the program on every record of a file, LANES at a time on
+// each of the threads
+int runRecordsFile(ProgramNode& root, const char* inName, const char* outName, int threads, bool bench) {
+    // A pipe or a FIFO such as /dev/stdin cannot be mapped, so it is read
+    // into a buffer instead
+    MappedFile file;
+    string buffer;
+    const char* data;
+    size_t size;
+    if (file.open(inName)) {
+        data = (const char*)file.data;
+        size = file.size;
+    }
+    else {
+        ifstream in(inName, ios::binary);
+        if (!in) {
+            cout << "ERROR: records file " << inName << " not found" << endl;
+            return EXIT_FAILURE;
+        }
+        buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+        if (in.bad()) {
+            cout << "ERROR: cannot read records file " << inName << endl;
+            return EXIT_FAILURE;
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+    ofstream outFile;
+    if (outName) {
+        outFile.open(outName);
+        if (!outFile) {
+            cout << "ERROR: cannot write " << outName << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    ostream& out = outName ? outFile : cout;
+    auto start = chrono::steady_clock::now();
+    size_t records;
+    try {
+        records = runRecordsThreaded(root, data, size, out, threads, limits.start());
+    }
+    catch (char const* errmsg) {
+        cout << "***ERROR: " << errmsg << endl;
+        return EXIT_FAILURE;
+    }
+    out.flush();
+    if (bench) {
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        fprintf(stderr, "BENCH: %zu records, %d lanes, %d threads %12.2f ms\n", records, LANES, threads, ms);
+    }
+    return EXIT_SUCCESS;
+}
+
+
+//*****************************************************************************
+// --check: run every engine on the same input, print the output of the
+// reference engine and whether all the others produced the same bytes. The
+// reference runs on the tree as parsed, the others on the optimized tree.
+int checkEngines(ProgramNode& root, bool optimize) {
+    string input((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+    string reference;
+    bool agree = true;
+
+    bool optimized = false;
+    for (const char* engine : engineNames) {
+        if (engine != engineNames[0] && optimize && !optimized) {
+            optimizeTree(root, false);
+            optimized = true;
+        }
+        istringstream in(input);
+        ostringstream out;
+        Runtime rt(in, out);
+        rt.budget = limits.start();
+        try {
+            runEngine(engine, root, rt, optimized);
+        }
+        catch (char const* errmsg) {
+            rt.writeError(errmsg);
+            rt.flush();
+        }
+        if (engine == engineNames[0])
+            reference = out.str();
+        else if (out.str() != reference) {
+            agree = false;
+            cout << "CHECK: " << engine << " engine differs from " << engineNames[0] << ":" << endl;
+            cout << out.str();
+        }
+    }
+
+    cout << reference;
+    cout << (agree ? "CHECK: all engines agree" : "CHECK: FAILED") << endl;
+    return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
 //*****************************************************************************
 // The main processing loop
 //
 int main(int argc, char* argv[]) {
 
+    // Options come before the input file name:
+    //   --all-errors      keep parsing after errors and report all of them
+    //   --max-errors=N    stop after N errors (default 1)
+    //   --stream          print statements as they are parsed, without the
+    //                     trace and without keeping the whole tree
+    //   --bench           report timings on stderr
+    //   --emit-ast=FILE   also save the parse tree in the binary format
+    //   --read-ast=FILE   print the traversal of a saved tree, no parsing
+    //   --batch           parse every file named on the command line
+    //   --cache-dir=DIR   where batch mode keeps its parse cache
+    //                     (default .tips_cache)
+    //   --no-cache        batch mode without the parse cache
+    //   --run             execute the program instead of printing its tree;
+    //                     READ takes numbers from stdin
+    //   --engine=NAME     how --run executes: tree, closure, vm (default)
+    //                     or jit
+    //   --writev          --run writes its output with writev, string
+    //                     literals straight from the program
+    //   --profile=FILE    --run on the vm, adding the opcode pairs run to
+    //                     the profile FILE
+    //   --gen-super=FILE  print superinstructions.h for the profile FILE
+    //   --check           run on every engine and compare the output
+    //   --disasm          print the bytecode of the program
+    //   --no-opt          execute the program as written, unoptimized
+    //   --dump-ir         print the optimized SSA form of the program
+    //   --emit-c          print the program translated to C
+    //   --emit-asm        print the program as x86-64 assembly
+    //   --emit-code=FILE  save the program's bytecode to FILE
+    //   --run-code=FILE   execute the bytecode saved in FILE (no program
+    //                     file); --engine=vm or jit
+    //   --records=FILE    run the program once per line of FILE, whose
+    //                     comma separated fields are what it READs; a
+    //                     line of output per record
+    //   --records-out=FILE  where --records writes (default stdout)
+    //   --threads=N       how many threads --records runs on (default one
+    //                     per core)
+    //   --max-steps=N     stop a run after N loop iterations
+    //   --max-seconds=S   stop a run after S seconds
+    //   --max-output=N    stop a run that writes more than N bytes
+    //   --hash-cons       share identical expression subtrees in the tree
+    //   --diff=OLD        list what changed from the program in OLD to the
+    //                     input file
+    // An input file name of "-" reads the program from stdin.
+    char* inputFile = nullptr;
+    vector<char*> inputFiles;
+    bool batchMode = false;
+    bool useCache = true;
+    string cacheDir = ".tips_cache";
+    bool streamMode = false;
+    bool benchMode = false;
+    const char* emitAstFile = nullptr;
+    const char* readAstFile = nullptr;
+    bool runMode = false;
+    bool writevMode = false;
+    bool checkMode = false;
+    bool disasmMode = false;
+    bool dumpIrMode = false;
+    bool emitCMode = false;
+    bool emitAsmMode = false;
+    const char* emitCodeFile = nullptr;
+    const char* profileFile = nullptr;
+    const char* genSuperFile = nullptr;
+    const char* runCodeFile = nullptr;
+    const char* recordsFile = nullptr;
+    const char* recordsOutFile = nullptr;
+    int threads = max(1, (int)thread::hardware_concurrency());
+    string engine = "vm";
+    bool optimize = true;
+    unique_ptr<ExprTable> hashCons;
+    const char* diffFile = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--all-errors")
+            maxErrors = 0;
+        else if (arg.rfind("--max-errors=", 0) == 0)
+            maxErrors = atoi(argv[i] + 13);
+        else if (arg == "--stream")
+            streamMode = true;
+        else if (arg == "--bench")
+            benchMode = true;
+        else if (arg.rfind("--emit-ast=", 0) == 0)
+            emitAstFile = argv[i] + 11;
+        else if (arg.rfind("--read-ast=", 0) == 0)
+            readAstFile = argv[i] + 11;
+        else if (arg == "--batch")
+            batchMode = true;
+        else if (arg.rfind("--cache-dir=", 0) == 0)
+            cacheDir = argv[i] + 12;
+        else if (arg == "--no-cache")
+            useCache = false;
+        else if (arg == "--run")
+            runMode = true;
+        else if (arg.rfind("--engine=", 0) == 0)
+            engine = argv[i] + 9;
+        else if (arg == "--writev")
+            writevMode = true;
+        else if (arg == "--check")
+            checkMode = true;
+        else if (arg == "--disasm")
+            disasmMode = true;
+        else if (arg == "--no-opt")
+            optimize = false;
+        else if (arg == "--dump-ir")
+            dumpIrMode = true;
+        else if (arg == "--emit-c")
+            emitCMode = true;
+        else if (arg == "--emit-asm")
+            emitAsmMode = true;
+        else if (arg.rfind("--profile=", 0) == 0)
+            profileFile = argv[i] + 10;
+        else if (arg.rfind("--gen-super=", 0) == 0)
+            genSuperFile = argv[i] + 12;
+        else if (arg.rfind("--emit-code=", 0) == 0)
+            emitCodeFile = argv[i] + 12;
+        else if (arg.rfind("--run-code=", 0) == 0)
+            runCodeFile = argv[i] + 11;
+        else if (arg.rfind("--records=", 0) == 0)
+            recordsFile = argv[i] + 10;
+        else if (arg.rfind("--records-out=", 0) == 0)
+            recordsOutFile = argv[i] + 14;
+        else if (arg.rfind("--threads=", 0) == 0)
+            threads = max(1, atoi(argv[i] + 10));
+        else if (arg.rfind("--max-steps=", 0) == 0)
+            limits.budget.steps = max(0LL, atoll(argv[i] + 12));
+        else if (arg.rfind("--max-seconds=", 0) == 0)
+            limits.seconds = atof(argv[i] + 14);
+        else if (arg.rfind("--max-output=", 0) == 0)
+            limits.budget.output = max(0LL, atoll(argv[i] + 13));
+        else if (arg.rfind("--diff=", 0) == 0)
+            diffFile = argv[i] + 7;
+        else if (arg == "--hash-cons")
+            exprTable = (hashCons = make_unique<ExprTable>()).get();
+        else if (arg.rfind("--", 0) == 0) {
+            printf("ERROR: unknown option %s\n", argv[i]);
+            return EXIT_FAILURE;
+        }
+        else {
+            inputFile = argv[i];
+            inputFiles.push_back(argv[i]);
+        }
+    }
+
+    if (batchMode) {
+        ParseCache cache(cacheDir);
+        return runBatch(inputFiles, useCache ? &cache : nullptr);
+    }
+
+    if (diffFile)
+        return runDiff(diffFile, inputFile ? inputFile : "sample.pas", benchMode);
+
+    // A saved tree is walked straight from the mapped file
+    if (readAstFile) {
+        MappedFile file;
+        AstView ast;
+        if (!file.open(readAstFile) || !ast.open(file.data, file.size)) {
+            printf("ERROR: %s is not a parse tree file\n", readAstFile);
+            return EXIT_FAILURE;
+        }
+        TreeWriter writer;
+        AstTreeWriter(ast, writer).program(ast.root());
+        cout.write(writer.out.buf, writer.out.len);
+        return EXIT_SUCCESS;
+    }
+
+    // Superinstructions are derived from a profile alone
+    if (genSuperFile) {
+        PairProfile profile;
+        ifstream exists(genSuperFile);
+        if (!exists || !profile.load(genSuperFile)) {
+            printf("ERROR: %s is not an opcode pair profile\n", genSuperFile);
+            return EXIT_FAILURE;
+        }
+        profile.writeHeader(cout);
+        return EXIT_SUCCESS;
+    }
+
+    // When the program is executed, stdout belongs to the program
+    bool execMode = runMode || checkMode || disasmMode || dumpIrMode || emitCMode || emitAsmMode || recordsFile ||
+                    emitCodeFile || runCodeFile;
+    if (execMode && find(begin(engineNames), end(engineNames), engine) == end(engineNames)) {
+        printf("ERROR: unknown engine %s\n", engine.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Saved bytecode runs straight from the mapped file, never parsed
+    if (runCodeFile)
+        return runCode(runCodeFile, engine, writevMode, benchMode);
+
     // Set the input stream
-    if (argc > 1) {
-        printf("INFO: Using the %s file for input\n", argv[1]);
-        yyin = fopen(argv[1], "r"); 
+    if (inputFile && string(inputFile) == "-") {
+        if (!execMode) printf("INFO: Using standard input for input\n");
+        yyin = stdin;
+    }
+    else if (inputFile) {
+        if (!execMode) printf("INFO: Using the %s file for input\n", inputFile);
+        yyin = fopen(inputFile, "r"); 
     }
     else {
-        printf("INFO: Using the sample.pas file for input\n");
+        if (!execMode) printf("INFO: Using the sample.pas file for input\n");
         yyin = fopen("sample.pas", "r");
     }
   
@@ -62,24 +772,104 @@ int main(int argc, char* argv[]) {
     // Set the output stream
     yyout = stdout;
 
-    // Get the first token
-    nextToken = yylex();
+    // In streaming mode the parse trace is silenced by putting cout in a
+    // failed state, which turns every trace write into a cheap no-op, and
+    // statements are printed through a second stream on the same buffer.
+    ostream results(cout.rdbuf());
+    StatementPrinter printer(results);
+    if (streamMode || execMode)
+        cout.setstate(ios::badbit);
 
     // Fire up the parser!
-    try {
-        
-        root = program();  // Process <program> production
+    root = parseProgram(yyin, streamMode ? &printer : nullptr);
+    if (streamMode && exprTable)
+        exprTable->clear();  // the statements using it are gone already
+    cout.clear();
 
-        if (nextToken != TOK_EOF)
-            throw "end of file expected, but there is more here!";
-        
-    } catch (char const *errmsg) {
-        cout << endl << "***ERROR:" << endl;
-        cout << "On line number " << yylineno << ", near " << yytext << ", error type ";
-        cout << errmsg << endl;
+    if (!diagnostics.empty()) {
+        reportDiagnostics(diagnostics);
         return EXIT_FAILURE;
     }
 
+    if (benchMode && exprTable)
+        fprintf(stderr, "HASH-CONS: %d expression nodes, %d duplicates shared\n",
+                exprTable->made, exprTable->shared);
+
+    if (streamMode)
+        return EXIT_SUCCESS;
+
+    if (execMode) {
+        // the engines rely on the type annotations
+        if (!TypeChecker().check(*root)) {
+            reportDiagnostics(diagnostics);
+            return EXIT_FAILURE;
+        }
+
+        if (optimize && !checkMode)
+            optimizeTree(*root, benchMode);
+
+        int status = EXIT_SUCCESS;
+        if (emitCMode) {
+            try {
+                CEmitter(cout).program(*root);
+            }
+            catch (char const* errmsg) {
+                cout << "***ERROR: " << errmsg << endl;
+                status = EXIT_FAILURE;
+            }
+        }
+        else if (recordsFile)
+            status = runRecordsFile(*root, recordsFile, recordsOutFile, threads, benchMode);
+        else if (emitAsmMode) {
+            try {
+                Chunk chunk = compileChunk(*root, optimize, benchMode);
+                AsmEmitter(chunk, cout).emit(*root->id);
+            }
+            catch (char const* errmsg) {
+                cout << "***ERROR: " << errmsg << endl;
+                status = EXIT_FAILURE;
+            }
+        }
+        else if (emitCodeFile) {
+            try {
+                Chunk chunk = compileChunk(*root, optimize, benchMode);
+                vector<char> image = ChunkWriter().write(chunk);
+                FILE* out = fopen(emitCodeFile, "wb");
+                if (!out || fwrite(image.data(), 1, image.size(), out) != image.size()) {
+                    printf("ERROR: could not write %s\n", emitCodeFile);
+                    status = EXIT_FAILURE;
+                }
+                if (out) fclose(out);
+            }
+            catch (char const* errmsg) {
+                cout << "***ERROR: " << errmsg << endl;
+                status = EXIT_FAILURE;
+            }
+        }
+        else if (disasmMode || dumpIrMode) {
+            try {
+                Chunk chunk = compileChunk(*root, optimize || dumpIrMode, benchMode, dumpIrMode ? &cout : nullptr);
+                if (disasmMode)
+                    disassemble(chunk, cout);
+            }
+            catch (char const* errmsg) {
+                cout << "***ERROR: " << errmsg << endl;
+                status = EXIT_FAILURE;
+            }
+        }
+        else if (checkMode)
+            status = checkEngines(*root, optimize);
+        else if (profileFile)
+            status = runProfiled(*root, profileFile, optimize, benchMode);
+        else
+            status = runProgram(*root, engine, optimize, writevMode, benchMode);
+        cout.setstate(ios::badbit);  // no node deletion messages
+        delete root;
+        if (exprTable) exprTable->clear();
+        cout.clear();
+        return status;
+    }
+
     // Tell the world about our success!!
     cout << endl << "=== Parse was successful! ===" << endl;
   
@@ -92,11 +882,28 @@ int main(int argc, char* argv[]) {
     }
 
     cout << endl << endl << "*** In order traversal of parse tree ***" << endl;
-    cout << *root << endl << endl;
+    TreeWriter writer;
+    writer.program(*root);
+    writer.out.lit("\n\n");
+    cout.write(writer.out.buf, writer.out.len);
+
+    if (benchMode)
+        benchTreeDump(*root);
+
+    if (emitAstFile) {
+        vector<char> image = AstWriter().write(*root);
+        FILE* out = fopen(emitAstFile, "wb");
+        if (!out || fwrite(image.data(), 1, image.size(), out) != image.size()) {
+            printf("ERROR: could not write %s\n", emitAstFile);
+            return EXIT_FAILURE;
+        }
+        fclose(out);
+    }
 
     cout << "*** Delete the parse tree ***" << endl;
     delete root;
     root = nullptr;
+    if (exprTable) exprTable->clear();
 
     return EXIT_SUCCESS;
 }
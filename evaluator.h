@@ -0,0 +1,161 @@
+//*****************************************************************************
+// Tree-walking evaluator
+//
+// The straightforward way to run a program: walk the parse tree, keeping
+// variables in an array indexed by their slots. It is the reference the
+// faster engines are tested against (tips_parse --check), so it favors
+// obviousness over speed: values carry their own INTEGER / REAL tag and
+// ignore the type checker's annotations, except that a value stored in a
+// variable takes the variable's declared type.
+//*****************************************************************************
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <string>
+#include <vector>
+#include "parse_tree_nodes.h"
+#include "runtime.h"
+
+using namespace std;
+
+class TreeEvaluator {
+public:
+    Runtime& rt;
+    vector<Value> vars;  // indexed by variable slot
+    const vector<TipsType>* types = nullptr;  // declared type of each slot
+
+    TreeEvaluator(Runtime& runtime) : rt(runtime) {}
+
+    void run(ProgramNode& pn);
+    Flow exec(StatementNode& sn);
+    Value eval(ExprNode& en);
+    Value eval(SimpleExprNode& sn);
+    Value eval(TermNode& tn);
+    Value eval(FactorNode& fn);
+};
+
+void TreeEvaluator::run(ProgramNode& pn) {
+    types = &pn.block->variableTypes;
+    vars.assign(types->size(), Value());
+    for (size_t slot = 0; slot < vars.size(); ++slot)
+        if ((*types)[slot] == TYPE_REAL) vars[slot] = Value::real(0);
+    exec(*pn.block->firstCompound);
+}
+
+Flow TreeEvaluator::exec(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        Value v = eval(*an.expression);
+        vars[an.slot] = (*types)[an.slot] == TYPE_REAL ? Value::real(v.asReal()) : v;
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        if (Flow f = exec(*cn.firstStatement))
+            return f;
+        for (StatementNode* s : cn.restStatements)
+            if (Flow f = exec(*s))
+                return f;
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        for (StatementNode* s : eval(*in.expression).truth() ? in.firstStatement : in.restStatements)
+            if (Flow f = exec(*s))
+                return f;
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        // every iteration after the first is a step (Runtime::backEdge)
+        for (bool again = false; eval(*wn.expression).truth(); again = true) {
+            if (again) rt.backEdge();
+            if (exec(*wn.firstStatement) == FLOW_BREAK) break;
+        }
+        break;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        int64_t start = eval(*fn.start).i;
+        int64_t limit = eval(*fn.limit).i;
+        vars[fn.slot] = Value::integer(start);
+        if (start != limit && !forContinues(start, limit, fn.down))
+            break;
+        for (;;) {
+            if (exec(*fn.firstStatement) == FLOW_BREAK) break;
+            int64_t i = vars[fn.slot].i;
+            vars[fn.slot] = Value::integer(forNext(i, fn.down));
+            if (!forContinues(i, limit, fn.down)) break;
+            rt.backEdge();
+        }
+        break;
+    }
+    case BREAK_NODE:
+        return FLOW_BREAK;
+    case CONTINUE_NODE:
+        return FLOW_CONTINUE;
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        if ((*types)[slot] == TYPE_REAL) vars[slot] = Value::real(rt.readReal());
+        else vars[slot] = Value::integer(rt.readInteger());
+        break;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        if (wn.isString()) rt.writeString(wn.text());
+        else rt.write(vars[wn.slot]);
+        break;
+    }
+    default:
+        throw "statement cannot be executed";
+    }
+    return FLOW_NEXT;
+}
+
+Value TreeEvaluator::eval(ExprNode& en) {
+    Value v = eval(*en.simpleExpr);
+    for (size_t i = 0; i < en.restExpOps.size(); ++i)
+        v = applyBinary(en.restExpOps[i], v, eval(*en.restExpr[i]));
+    return v;
+}
+
+Value TreeEvaluator::eval(SimpleExprNode& sn) {
+    Value v = eval(*sn.firstTerm);
+    for (size_t i = 0; i < sn.restTermOps.size(); ++i)
+        v = applyBinary(sn.restTermOps[i], v, eval(*sn.restTerms[i]));
+    return v;
+}
+
+Value TreeEvaluator::eval(TermNode& tn) {
+    Value v = eval(*tn.firstFactor);
+    for (size_t i = 0; i < tn.restFactorOps.size(); ++i)
+        v = applyBinary(tn.restFactorOps[i], v, eval(*tn.restFactors[i]));
+    return v;
+}
+
+Value TreeEvaluator::eval(FactorNode& fn) {
+    Value v;
+    switch (fn.kind) {
+    case ID_NODE:
+        v = vars[((IdNode&)fn).slot];
+        break;
+    case INTLIT_NODE:
+        v = Value::integer(((IntLitNode&)fn).int_literal);
+        break;
+    case FLOATLIT_NODE:
+        v = Value::real(((FloatLitNode&)fn).double_literal);
+        break;
+    case NESTED_EXPR_NODE:
+        v = eval(*((NestedExprNode&)fn).exprPtr);
+        break;
+    default:
+        throw "factor cannot be evaluated";
+    }
+    // innermost operator first
+    for (size_t i = fn.unaryOps.size(); i-- > 0; )
+        v = applyUnary(fn.unaryOps[i], v);
+    return v;
+}
+
+#endif /* EVALUATOR_H */
@@ -0,0 +1,51 @@
+//*****************************************************************************
+// 64-bit hashing helpers
+//*****************************************************************************
+#ifndef HASH_H
+#define HASH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stddef.h>
+
+const uint64_t HASH_PRIME = 0x9E3779B97F4A7C15ULL;
+
+// Final avalanche step (from MurmurHash3's fmix64)
+inline uint64_t hashMix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Combine a value into a running hash
+inline uint64_t hashCombine(uint64_t h, uint64_t value) {
+    return hashMix(h ^ (value + HASH_PRIME + (h << 6) + (h >> 2)));
+}
+
+// Hash a byte range eight bytes at a time. Not cryptographic, but fast and
+// well distributed, which is all a content-addressed cache needs.
+uint64_t hashBytes(const void* data, size_t n, uint64_t seed = 0) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = seed ^ (n * HASH_PRIME);
+
+    while (n >= 8) {
+        uint64_t k;
+        memcpy(&k, p, 8);
+        k *= HASH_PRIME;
+        k ^= k >> 32;
+        h = (h ^ k) * HASH_PRIME;
+        p += 8;
+        n -= 8;
+    }
+
+    uint64_t tail = 0;
+    memcpy(&tail, p, n);
+    h = (h ^ tail) * HASH_PRIME;
+
+    return hashMix(h);
+}
+
+#endif /* HASH_H */
@@ -0,0 +1,161 @@
+//*****************************************************************************
+// Hash-consing of expression subtrees (tips_parse --hash-cons)
+//
+// Programs repeat the same subexpressions over and over: loop bounds, index
+// arithmetic, conditions tested in several places. With an ExprTable in
+// place the parser looks every expression, simple expression, term and
+// factor up by its structure as soon as it is complete and, when an
+// identical one exists, uses that node instead, so the expressions of a
+// program form a DAG that holds each distinct subtree once.
+//
+// Nodes are looked up by their Merkle hash (tree_hash.h). The children of
+// a node are unique by the time it is looked up, so two nodes are identical
+// when their operators, print texts and literal values match and their
+// children are the very same nodes.
+//
+// The table owns every node it has seen, which are marked shared. A parent
+// does not delete a shared child (see release() in parse_tree_nodes.h);
+// clear() deletes them all. Passes that only read the tree work on the DAG
+// unchanged, and the type checker's annotations come out the same for every
+// parent. A pass that builds something per subtree can keep it per shared
+// node, as AstWriter and ClosureCompiler do. ExprOptimizer rewrites a tree
+// in place, so a shared tree is executed as parsed.
+//*****************************************************************************
+#ifndef HASH_CONS_H
+#define HASH_CONS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+#include "parse_tree_nodes.h"
+
+using namespace std;
+
+class ExprTable {
+public:
+    int made = 0;    // distinct nodes kept
+    int shared = 0;  // nodes parsed that turned out to be duplicates
+
+    // Whatever is left at exit goes without deletion messages
+    ~ExprTable() {
+        cout.setstate(ios::badbit);
+        clear();
+        cout.clear();
+    }
+
+    // The node to use in place of node, which is deleted if an identical
+    // one is already known. Its children must come from this table.
+    // Its hash and those of its children must be set.
+    FactorNode* intern(FactorNode* fn) { return intern(fn, factors, factorOrder); }
+    TermNode* intern(TermNode* tn) { return intern(tn, terms, termOrder); }
+    SimpleExprNode* intern(SimpleExprNode* sn) { return intern(sn, simples, simpleOrder); }
+    ExprNode* intern(ExprNode* en) { return intern(en, exprs, exprOrder); }
+
+    // Delete every node. Shared nodes leave their children to the table, so
+    // the order does not matter.
+    void clear();
+
+    static bool same(const FactorNode& a, const FactorNode& b);
+    static bool same(const TermNode& a, const TermNode& b);
+    static bool same(const SimpleExprNode& a, const SimpleExprNode& b);
+    static bool same(const ExprNode& a, const ExprNode& b);
+
+private:
+    unordered_multimap<uint64_t, FactorNode*> factors;
+    unordered_multimap<uint64_t, TermNode*> terms;
+    unordered_multimap<uint64_t, SimpleExprNode*> simples;
+    unordered_multimap<uint64_t, ExprNode*> exprs;
+    vector<FactorNode*> factorOrder;  // in the order made, for clear()
+    vector<TermNode*> termOrder;
+    vector<SimpleExprNode*> simpleOrder;
+    vector<ExprNode*> exprOrder;
+
+    template <class Node>
+    Node* intern(Node* node, unordered_multimap<uint64_t, Node*>& index, vector<Node*>& order);
+
+    template <class Node>
+    static void deleteAll(vector<Node*>& order, unordered_multimap<uint64_t, Node*>& index);
+};
+
+// Set by --hash-cons; the parser shares subtrees while it is set
+ExprTable* exprTable = nullptr;
+
+template <class Node>
+Node* ExprTable::intern(Node* node, unordered_multimap<uint64_t, Node*>& index, vector<Node*>& order) {
+    auto range = index.equal_range(node->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (!same(*it->second, *node))
+            continue;
+        // the duplicate's children are shared, so only the node itself goes
+        bool muted = cout.bad();
+        cout.setstate(ios::badbit);
+        delete node;
+        if (!muted) cout.clear();
+        ++shared;
+        return it->second;
+    }
+    node->shared = true;
+    index.emplace(node->hash, node);
+    order.push_back(node);
+    ++made;
+    return node;
+}
+
+template <class Node>
+void ExprTable::deleteAll(vector<Node*>& order, unordered_multimap<uint64_t, Node*>& index) {
+    for (Node* node : order)
+        delete node;
+    order.clear();
+    index.clear();
+}
+
+void ExprTable::clear() {
+    deleteAll(exprOrder, exprs);
+    deleteAll(simpleOrder, simples);
+    deleteAll(termOrder, terms);
+    deleteAll(factorOrder, factors);
+}
+
+//*****************************************************************************
+// Identity: children compare by address, they are already unique
+bool ExprTable::same(const FactorNode& a, const FactorNode& b) {
+    if (a.kind != b.kind || a.unaryOps != b.unaryOps)
+        return false;
+    switch (a.kind) {
+    case ID_NODE: {
+        const IdNode& x = (const IdNode&)a;
+        const IdNode& y = (const IdNode&)b;
+        return x.slot == y.slot && x.compoundname == y.compoundname && *x.id == *y.id && x.name == y.name;
+    }
+    case INTLIT_NODE: {
+        const IntLitNode& x = (const IntLitNode&)a;
+        const IntLitNode& y = (const IntLitNode&)b;
+        return x.int_literal == y.int_literal && x.compoudedFactorInt == y.compoudedFactorInt;
+    }
+    case FLOATLIT_NODE:
+        return !memcmp(&((const FloatLitNode&)a).double_literal, &((const FloatLitNode&)b).double_literal,
+                       sizeof(double));
+    case NESTED_EXPR_NODE: {
+        const NestedExprNode& x = (const NestedExprNode&)a;
+        const NestedExprNode& y = (const NestedExprNode&)b;
+        return x.exprPtr == y.exprPtr && x.additional == y.additional && x.end == y.end;
+    }
+    default:
+        return false;
+    }
+}
+
+bool ExprTable::same(const TermNode& a, const TermNode& b) {
+    return a.firstFactor == b.firstFactor && a.restFactorOps == b.restFactorOps && a.restFactors == b.restFactors;
+}
+
+bool ExprTable::same(const SimpleExprNode& a, const SimpleExprNode& b) {
+    return a.firstTerm == b.firstTerm && a.restTermOps == b.restTermOps && a.restTerms == b.restTerms;
+}
+
+bool ExprTable::same(const ExprNode& a, const ExprNode& b) {
+    return a.simpleExpr == b.simpleExpr && a.restExpOps == b.restExpOps && a.restExpr == b.restExpr;
+}
+
+#endif /* HASH_CONS_H */
@@ -0,0 +1,659 @@
+//*****************************************************************************
+// SSA intermediate representation
+//
+// A program becomes a control flow graph of basic blocks whose instructions
+// define each value exactly once. Variables disappear: every assignment
+// makes a new value and the join points of IF and the loops get phi functions
+// choosing between the values arriving on each edge. That makes constant
+// propagation, common subexpression elimination and dead code elimination
+// (ir_passes.h) simple def-use walks. ir_codegen.h turns the result back
+// into bytecode.
+//
+// Instructions reuse the typed bytecode opcodes, so the IR has the same
+// semantics as the VM. SSA form is built directly while lowering the tree,
+// following Braun et al., "Simple and Efficient Construction of Static
+// Single Assignment Form" (CC 2013).
+//*****************************************************************************
+#ifndef IR_H
+#define IR_H
+
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+#include "typecheck.h"
+#include "bytecode.h"
+
+using namespace std;
+
+const int NO_VALUE = -1;
+
+enum IrKind {
+    IR_OP,     // a bytecode operation: arithmetic, READ*, WRITE*
+    IR_PHI,    // one argument per predecessor, in the order of preds
+    IR_COPY    // dest = args[0]; only made when leaving SSA form
+};
+
+struct IrInst {
+    IrKind kind = IR_OP;
+    Opcode op = OP_HALT;
+    int dest = NO_VALUE;
+    vector<int> args;
+    uint32_t imm = 0;      // WRITES: index into strings; SHLI, DIVPI, MODPI: shift
+    bool removed = false;
+};
+
+enum IrTerminator { TERM_JUMP, TERM_BRANCH, TERM_HALT };
+
+struct IrBlock {
+    vector<IrInst> phis;
+    vector<IrInst> insts;
+    vector<int> preds;
+    IrTerminator term = TERM_HALT;
+    int cond = NO_VALUE;                  // TERM_BRANCH: value tested
+    int succ[2] = {-1, -1};               // taken when cond <> 0 / = 0
+    bool sealed = false;                  // all predecessors are known
+    bool dead = false;                    // unreachable, to be ignored
+
+    int succCount() const { return term == TERM_JUMP ? 1 : term == TERM_BRANCH ? 2 : 0; }
+};
+
+struct IrValue {
+    TipsType type = TYPE_INTEGER;         // INTEGER or REAL; BOOLEAN is INTEGER
+    bool isConst = false;
+    Slot constant;
+    int var = -1;                         // variable slot it was assigned to, if any
+    int alias = NO_VALUE;                 // replaced by this value
+};
+
+//*****************************************************************************
+// class IrFunction
+class IrFunction {
+public:
+    vector<IrBlock> blocks;
+    vector<IrValue> values;
+    vector<string> strings;
+    vector<string> varNames;
+    vector<TipsType> varTypes;
+
+    int newBlock() { blocks.emplace_back(); return blocks.size() - 1; }
+    int newValue(TipsType type);
+    int constant(TipsType type, Slot k);
+    int constInt(int64_t i) { Slot k; k.i = i; return constant(TYPE_INTEGER, k); }
+    int constReal(double f) { Slot k; k.f = f; return constant(TYPE_REAL, k); }
+
+    // The value v stands for, after replacements
+    int resolve(int v);
+    void replace(int v, int by) { values[v].alias = by; }
+    void canonicalize();
+
+    void addEdge(int from, int to) { blocks[to].preds.push_back(from); }
+    void removeEdge(int from, int to);
+    vector<int> reversePostorder();
+
+    void print(ostream& os);
+    void printValue(ostream& os, int v);
+};
+
+int IrFunction::newValue(TipsType type) {
+    IrValue v;
+    v.type = type == TYPE_REAL ? TYPE_REAL : TYPE_INTEGER;
+    values.push_back(v);
+    return values.size() - 1;
+}
+
+int IrFunction::constant(TipsType type, Slot k) {
+    int v = newValue(type);
+    values[v].isConst = true;
+    values[v].constant = k;
+    return v;
+}
+
+int IrFunction::resolve(int v) {
+    int root = v;
+    while (root != NO_VALUE && values[root].alias != NO_VALUE)
+        root = values[root].alias;
+    // path compression
+    while (v != NO_VALUE && values[v].alias != NO_VALUE) {
+        int next = values[v].alias;
+        values[v].alias = root;
+        v = next;
+    }
+    return root;
+}
+
+// Rewrite every use to the value it resolves to
+void IrFunction::canonicalize() {
+    for (IrBlock& b : blocks) {
+        for (IrInst& in : b.phis)
+            for (int& a : in.args) a = resolve(a);
+        for (IrInst& in : b.insts)
+            for (int& a : in.args) a = resolve(a);
+        if (b.term == TERM_BRANCH) b.cond = resolve(b.cond);
+    }
+}
+
+// Drop the edge and the matching phi arguments
+void IrFunction::removeEdge(int from, int to) {
+    IrBlock& b = blocks[to];
+    for (size_t i = 0; i < b.preds.size(); ++i) {
+        if (b.preds[i] != from) continue;
+        b.preds.erase(b.preds.begin() + i);
+        for (IrInst& phi : b.phis)
+            if (!phi.removed) phi.args.erase(phi.args.begin() + i);
+        return;
+    }
+}
+
+// Reachable blocks, each before its successors except along back edges.
+// The first successor is placed right after its block where possible, so
+// the layout follows the source order of IF and WHILE.
+vector<int> IrFunction::reversePostorder() {
+    vector<int> order;
+    vector<char> state(blocks.size(), 0);  // 0 new, 1 on stack, 2 done
+    vector<pair<int, int>> stack;          // block, next successor to visit
+    stack.push_back({0, 0});
+    state[0] = 1;
+    while (!stack.empty()) {
+        int b = stack.back().first;
+        int& i = stack.back().second;
+        int n = blocks[b].succCount();
+        if (i < n) {
+            int s = blocks[b].succ[n - 1 - i];  // last successor first
+            ++i;
+            if (state[s] == 0) {
+                state[s] = 1;
+                stack.push_back({s, 0});
+            }
+            continue;
+        }
+        state[b] = 2;
+        order.push_back(b);
+        stack.pop_back();
+    }
+    return vector<int>(order.rbegin(), order.rend());
+}
+
+void IrFunction::printValue(ostream& os, int v) {
+    v = resolve(v);
+    const IrValue& val = values[v];
+    if (!val.isConst)
+        os << "v" << v;
+    else if (val.type == TYPE_REAL) {
+        ostringstream text;
+        text << val.constant.f;
+        os << "#" << text.str();
+        if (text.str().find_first_of(".einf") == string::npos) os << ".0";
+    }
+    else
+        os << "#" << val.constant.i;
+}
+
+void IrFunction::print(ostream& os) {
+    for (int b : reversePostorder()) {
+        IrBlock& block = blocks[b];
+        os << "B" << b << ":";
+        if (!block.preds.empty()) {
+            os << "  ; preds";
+            for (int p : block.preds) os << " B" << p;
+        }
+        os << endl;
+        for (IrInst& phi : block.phis) {
+            if (phi.removed) continue;
+            os << "    v" << phi.dest << " = phi";
+            for (size_t i = 0; i < phi.args.size(); ++i) {
+                os << (i ? ", " : " ");
+                printValue(os, phi.args[i]);
+            }
+            os << endl;
+        }
+        for (IrInst& in : block.insts) {
+            if (in.removed) continue;
+            os << "    ";
+            if (in.dest != NO_VALUE) os << "v" << in.dest << " = ";
+            os << (in.kind == IR_COPY ? "COPY" : opcodeInfo[in.op].name);
+            if (in.op == OP_WRITES && in.kind == IR_OP) os << " '" << strings[in.imm] << "'";
+            for (size_t i = 0; i < in.args.size(); ++i) {
+                os << (i ? ", " : " ");
+                printValue(os, in.args[i]);
+            }
+            if (in.kind == IR_OP && opcodeInfo[in.op].c == OPND_I) os << ", " << in.imm;
+            os << endl;
+        }
+        switch (block.term) {
+        case TERM_JUMP:
+            os << "    jump B" << block.succ[0] << endl;
+            break;
+        case TERM_BRANCH:
+            os << "    branch ";
+            printValue(os, block.cond);
+            os << " ? B" << block.succ[0] << " : B" << block.succ[1] << endl;
+            break;
+        case TERM_HALT:
+            os << "    halt" << endl;
+            break;
+        }
+    }
+}
+
+//*****************************************************************************
+// Lowering the type-annotated parse tree to SSA form
+class IrBuilder {
+public:
+    IrFunction fn;
+    int cur = 0;                               // block being filled
+    vector<vector<int>> currentDef;            // [block][slot] -> value
+    vector<vector<pair<int, int>>> incomplete; // [block] -> (slot, phi value)
+
+    // Where BREAK and CONTINUE go in the innermost loop. The block ending
+    // an iteration is only made once a CONTINUE needs it.
+    struct LoopTargets {
+        int exit;
+        int next = -1;
+    };
+    LoopTargets* loop = nullptr;
+
+    IrFunction build(ProgramNode& pn);
+
+    int block();
+    void jump(int from, int to);
+    void leave(int to);
+    int nextIteration();
+    void branch(int from, int cond, int ifTrue, int ifFalse);
+    void seal(int b);
+
+    void writeVariable(int slot, int b, int value);
+    int readVariable(int slot, int b);
+    int readVariableRecursive(int slot, int b);
+    int addPhiOperands(int slot, int phi);
+    int tryRemoveTrivialPhi(int phi);
+    IrInst& phiOf(int value);
+
+    int emit(Opcode op, TipsType type, int a = NO_VALUE, int b = NO_VALUE);
+    void effect(Opcode op, int a = NO_VALUE, uint32_t imm = 0);
+    int toReal(int v, TipsType type);
+
+    void statement(StatementNode& sn);
+    int expression(ExprNode& en);
+    int simpleExpression(SimpleExprNode& sn);
+    int term(TermNode& tn);
+    int factor(FactorNode& fn);
+    template <class Node>
+    int chain(const vector<int>& ops, const vector<TipsType>& opTypes, int first, TipsType firstType,
+              const vector<Node*>& rest, int (IrBuilder::*operand)(Node&));
+
+    vector<int> phiBlock;  // value -> block of the phi defining it, or -1
+};
+
+IrFunction IrBuilder::build(ProgramNode& pn) {
+    fn.varNames = pn.block->variables;
+    fn.varTypes = pn.block->variableTypes;
+    cur = block();
+    seal(cur);
+    statement(*pn.block->firstCompound);
+    fn.blocks[cur].term = TERM_HALT;
+    return fn;
+}
+
+int IrBuilder::block() {
+    int b = fn.newBlock();
+    currentDef.emplace_back(fn.varNames.size(), NO_VALUE);
+    incomplete.emplace_back();
+    return b;
+}
+
+void IrBuilder::jump(int from, int to) {
+    fn.blocks[from].term = TERM_JUMP;
+    fn.blocks[from].succ[0] = to;
+    fn.addEdge(from, to);
+}
+
+void IrBuilder::branch(int from, int cond, int ifTrue, int ifFalse) {
+    IrBlock& b = fn.blocks[from];
+    b.term = TERM_BRANCH;
+    b.cond = cond;
+    b.succ[0] = ifTrue;
+    b.succ[1] = ifFalse;
+    fn.addEdge(from, ifTrue);
+    fn.addEdge(from, ifFalse);
+}
+
+// BREAK or CONTINUE: jump to the target and go on lowering into a block
+// nothing reaches, which the constant propagation pass removes
+void IrBuilder::leave(int to) {
+    jump(cur, to);
+    cur = block();
+    seal(cur);
+}
+
+// The block a CONTINUE in the innermost loop jumps to, made on first use
+int IrBuilder::nextIteration() {
+    if (loop->next < 0)
+        loop->next = block();
+    return loop->next;
+}
+
+// No more predecessors will be added to b: finish its pending phis
+void IrBuilder::seal(int b) {
+    for (auto& pending : incomplete[b])
+        addPhiOperands(pending.first, pending.second);
+    incomplete[b].clear();
+    fn.blocks[b].sealed = true;
+}
+
+void IrBuilder::writeVariable(int slot, int b, int value) {
+    currentDef[b][slot] = value;
+}
+
+int IrBuilder::readVariable(int slot, int b) {
+    int v = currentDef[b][slot];
+    if (v != NO_VALUE)
+        return fn.resolve(v);
+    return readVariableRecursive(slot, b);
+}
+
+int IrBuilder::readVariableRecursive(int slot, int b) {
+    IrBlock& block = fn.blocks[b];
+    TipsType type = fn.varTypes[slot];
+    int v;
+    if (!block.sealed) {
+        v = fn.newValue(type);
+        IrInst phi;
+        phi.kind = IR_PHI;
+        phi.dest = v;
+        fn.blocks[b].phis.push_back(phi);
+        phiBlock.resize(fn.values.size(), -1);
+        phiBlock[v] = b;
+        incomplete[b].push_back({slot, v});
+    }
+    else if (block.preds.empty()) {
+        // read before any assignment: variables start out as zero
+        v = type == TYPE_REAL ? fn.constReal(0) : fn.constInt(0);
+    }
+    else if (block.preds.size() == 1) {
+        v = readVariable(slot, block.preds[0]);
+    }
+    else {
+        v = fn.newValue(type);
+        IrInst phi;
+        phi.kind = IR_PHI;
+        phi.dest = v;
+        fn.blocks[b].phis.push_back(phi);
+        phiBlock.resize(fn.values.size(), -1);
+        phiBlock[v] = b;
+        writeVariable(slot, b, v);  // breaks cycles through loops
+        v = addPhiOperands(slot, v);
+    }
+    fn.values[v].var = fn.values[v].var < 0 ? slot : fn.values[v].var;
+    writeVariable(slot, b, v);
+    return v;
+}
+
+IrInst& IrBuilder::phiOf(int value) {
+    for (IrInst& phi : fn.blocks[phiBlock[value]].phis)
+        if (phi.dest == value) return phi;
+    throw "phi not found";
+}
+
+int IrBuilder::addPhiOperands(int slot, int phi) {
+    int b = phiBlock[phi];
+    vector<int> preds = fn.blocks[b].preds;
+    vector<int> args;
+    for (int p : preds)
+        args.push_back(readVariable(slot, p));
+    phiOf(phi).args = args;
+    return tryRemoveTrivialPhi(phi);
+}
+
+// A phi whose arguments are all the same value (or itself) is that value
+int IrBuilder::tryRemoveTrivialPhi(int phi) {
+    int same = NO_VALUE;
+    for (int a : phiOf(phi).args) {
+        a = fn.resolve(a);
+        if (a == same || a == phi) continue;
+        if (same != NO_VALUE) return phi;
+        same = a;
+    }
+    if (same == NO_VALUE) {
+        TipsType type = fn.values[phi].type;
+        same = type == TYPE_REAL ? fn.constReal(0) : fn.constInt(0);
+    }
+    phiOf(phi).removed = true;
+    fn.replace(phi, same);
+    // phis that used this one may have become trivial too; the constant
+    // propagation pass catches those
+    return same;
+}
+
+int IrBuilder::emit(Opcode op, TipsType type, int a, int b) {
+    IrInst in;
+    in.op = op;
+    in.dest = fn.newValue(type);
+    if (a != NO_VALUE) in.args.push_back(a);
+    if (b != NO_VALUE) in.args.push_back(b);
+    fn.blocks[cur].insts.push_back(in);
+    return in.dest;
+}
+
+void IrBuilder::effect(Opcode op, int a, uint32_t imm) {
+    IrInst in;
+    in.op = op;
+    in.imm = imm;
+    if (a != NO_VALUE) in.args.push_back(a);
+    fn.blocks[cur].insts.push_back(in);
+}
+
+int IrBuilder::toReal(int v, TipsType type) {
+    if (type == TYPE_REAL)
+        return v;
+    v = fn.resolve(v);
+    if (fn.values[v].isConst)
+        return fn.constReal((double)fn.values[v].constant.i);
+    return emit(OP_I2F, TYPE_REAL, v);
+}
+
+void IrBuilder::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        int v = expression(*an.expression);
+        if (fn.varTypes[an.slot] == TYPE_REAL)
+            v = toReal(v, an.expression->type);
+        if (fn.values[v].var < 0) fn.values[v].var = an.slot;
+        writeVariable(an.slot, cur, v);
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        statement(*cn.firstStatement);
+        for (StatementNode* s : cn.restStatements)
+            statement(*s);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        int cond = expression(*in.expression);
+        int thenBlock = block();
+        int elseBlock = in.restStatements.empty() ? -1 : block();
+        int join = block();
+        branch(cur, cond, thenBlock, elseBlock < 0 ? join : elseBlock);
+        seal(thenBlock);
+        cur = thenBlock;
+        for (StatementNode* s : in.firstStatement)
+            statement(*s);
+        jump(cur, join);
+        if (elseBlock >= 0) {
+            seal(elseBlock);
+            cur = elseBlock;
+            for (StatementNode* s : in.restStatements)
+                statement(*s);
+            jump(cur, join);
+        }
+        seal(join);
+        cur = join;
+        break;
+    }
+    case WHILE_NODE: {
+        // Rotated: the condition is tested before the first iteration and
+        // again at the end of the body, so each iteration takes one branch
+        WhileNode& wn = (WhileNode&)sn;
+        int first = expression(*wn.expression);
+        int body = block();
+        int exit = block();
+        branch(cur, first, body, exit);
+        cur = body;
+        LoopTargets targets{exit}, *outer = loop;
+        loop = &targets;
+        statement(*wn.firstStatement);
+        loop = outer;
+        if (targets.next >= 0) {
+            jump(cur, targets.next);
+            seal(targets.next);
+            cur = targets.next;
+        }
+        int again = expression(*wn.expression);
+        branch(cur, again, body, exit);
+        seal(body);
+        seal(exit);
+        cur = exit;
+        break;
+    }
+    case FOR_NODE: {
+        // Like WHILE, with the test at the end of the body comparing the
+        // value the variable had with the limit computed before the loop.
+        // ir_codegen.h turns the compare, step and branch into FORUP/FORDN.
+        ForNode& fnode = (ForNode&)sn;
+        Opcode past = fnode.down ? OP_LTI : OP_GTI, within = fnode.down ? OP_GTI : OP_LTI;
+        int start = expression(*fnode.start);
+        int limit = expression(*fnode.limit);
+        writeVariable(fnode.slot, cur, start);
+        int enter = emit(OP_NOT, TYPE_BOOLEAN, emit(past, TYPE_BOOLEAN, start, limit));
+        int body = block();
+        int exit = block();
+        branch(cur, enter, body, exit);
+        cur = body;
+        LoopTargets targets{exit}, *outer = loop;
+        loop = &targets;
+        statement(*fnode.firstStatement);
+        loop = outer;
+        if (targets.next >= 0) {
+            jump(cur, targets.next);
+            seal(targets.next);
+            cur = targets.next;
+        }
+        int i = readVariable(fnode.slot, cur);
+        int again = emit(within, TYPE_BOOLEAN, i, limit);
+        int next = emit(fnode.down ? OP_SUBI : OP_ADDI, TYPE_INTEGER, i, fn.constInt(1));
+        fn.values[next].var = fnode.slot;
+        writeVariable(fnode.slot, cur, next);
+        branch(cur, again, body, exit);
+        seal(body);
+        seal(exit);
+        cur = exit;
+        break;
+    }
+    case BREAK_NODE:
+        leave(loop->exit);
+        break;
+    case CONTINUE_NODE:
+        leave(nextIteration());
+        break;
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        bool real = fn.varTypes[slot] == TYPE_REAL;
+        int v = emit(real ? OP_READF : OP_READI, fn.varTypes[slot]);
+        fn.values[v].var = slot;
+        writeVariable(slot, cur, v);
+        break;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        if (wn.isString()) {
+            fn.strings.push_back(wn.operand());
+            effect(OP_WRITES, NO_VALUE, fn.strings.size() - 1);
+        }
+        else {
+            bool real = fn.varTypes[wn.slot] == TYPE_REAL;
+            effect(real ? OP_WRITEF : OP_WRITEI, readVariable(wn.slot, cur));
+        }
+        break;
+    }
+    default:
+        throw "statement cannot be lowered";
+    }
+}
+
+template <class Node>
+int IrBuilder::chain(const vector<int>& ops, const vector<TipsType>& opTypes, int first, TipsType firstType,
+                     const vector<Node*>& rest, int (IrBuilder::*operand)(Node&)) {
+    int v = first;
+    TipsType type = firstType;
+    for (size_t i = 0; i < ops.size(); ++i) {
+        if (opTypes[i] == TYPE_REAL)
+            v = toReal(v, type);
+        int right = (this->*operand)(*rest[i]);
+        if (opTypes[i] == TYPE_REAL)
+            right = toReal(right, rest[i]->type);
+        type = resultType(ops[i], opTypes[i]);
+        v = emit(binaryOpcode(ops[i], opTypes[i]), type, v, right);
+    }
+    return v;
+}
+
+int IrBuilder::expression(ExprNode& en) {
+    return chain(en.restExpOps, en.opTypes, simpleExpression(*en.simpleExpr), en.simpleExpr->type,
+                 en.restExpr, &IrBuilder::simpleExpression);
+}
+
+int IrBuilder::simpleExpression(SimpleExprNode& sn) {
+    return chain(sn.restTermOps, sn.opTypes, term(*sn.firstTerm), sn.firstTerm->type,
+                 sn.restTerms, &IrBuilder::term);
+}
+
+int IrBuilder::term(TermNode& tn) {
+    return chain(tn.restFactorOps, tn.opTypes, factor(*tn.firstFactor), tn.firstFactor->type,
+                 tn.restFactors, &IrBuilder::factor);
+}
+
+int IrBuilder::factor(FactorNode& fnode) {
+    int v;
+    TipsType type;
+    switch (fnode.kind) {
+    case ID_NODE:
+        v = readVariable(((IdNode&)fnode).slot, cur);
+        type = fn.varTypes[((IdNode&)fnode).slot];
+        break;
+    case INTLIT_NODE:
+        v = fn.constInt(((IntLitNode&)fnode).int_literal);
+        type = TYPE_INTEGER;
+        break;
+    case FLOATLIT_NODE:
+        v = fn.constReal(((FloatLitNode&)fnode).double_literal);
+        type = TYPE_REAL;
+        break;
+    case NESTED_EXPR_NODE:
+        v = expression(*((NestedExprNode&)fnode).exprPtr);
+        type = ((NestedExprNode&)fnode).exprPtr->type;
+        break;
+    default:
+        throw "factor cannot be lowered";
+    }
+
+    // innermost operator first
+    for (size_t i = fnode.unaryOps.size(); i-- > 0; ) {
+        if (fnode.unaryOps[i] == TOK_NOT) {
+            v = emit(OP_NOT, TYPE_INTEGER, v);
+            type = TYPE_BOOLEAN;
+        }
+        else {
+            v = emit(type == TYPE_REAL ? OP_NEGF : OP_NEGI, type, v);
+            if (type == TYPE_BOOLEAN) type = TYPE_INTEGER;
+        }
+    }
+    return v;
+}
+
+#endif /* IR_H */
@@ -0,0 +1,492 @@
+//*****************************************************************************
+// From the SSA form of ir.h back to bytecode
+//
+// Phis are replaced by copies at the end of each predecessor; edges from a
+// block with two successors into a block with phis get a block of their own
+// first, so a copy only runs on its edge. Values are then given registers:
+//
+//   - liveness is computed over the blocks and every value interferes with
+//     the values live where it is defined
+//   - each copy whose two sides do not interfere is coalesced, so the loop
+//     variable of `I := I + 1` stays in one register and needs no MOVE
+//   - the coalesced classes are coloured greedily in program order
+//
+// Registers are unlimited, so nothing is ever spilled. Constants are not
+// values with registers of their own but the usual preloaded constant
+// registers. Blocks left empty after coalescing are jumped over. A branch
+// on NOT x branches on x instead, and the compare, step and branch closing
+// a FOR loop become one FORUP or FORDN.
+//*****************************************************************************
+#ifndef IR_CODEGEN_H
+#define IR_CODEGEN_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "bytecode.h"
+#include "ir.h"
+
+using namespace std;
+
+class IrCodegen {
+public:
+    IrFunction& fn;
+    Chunk chunk;
+    vector<vector<pair<int, int>>> copies;  // [block] -> parallel (dest, source)
+    vector<int> parent;                     // union-find over values
+    vector<unordered_set<int>> adj;         // interference, per class
+    vector<int> color;                      // register of each class
+    map<pair<bool, int64_t>, uint32_t> constIndex;
+    vector<int> layout;
+    bool scratchUsed = false;
+
+    IrCodegen(IrFunction& function) : fn(function) {}
+
+    Chunk generate();
+
+    void splitCriticalEdges();
+    void eliminatePhis();
+    void buildInterference();
+    void coalesce();
+    void assignRegisters();
+    void emitCode();
+    int lastInst(int b, int before);
+    bool onlyBranchReads(int b);
+    int countedLoop(int b);
+
+    int find(int v);
+    bool isValue(int v) { return !fn.values[v].isConst; }
+    void interfere(int a, int b);
+    uint32_t reg(int v);
+    void sequentialize(const vector<pair<uint32_t, uint32_t>>& moves);
+};
+
+Chunk IrCodegen::generate() {
+    fn.canonicalize();
+    splitCriticalEdges();
+    eliminatePhis();
+    layout = fn.reversePostorder();
+    buildInterference();
+    coalesce();
+    assignRegisters();
+    emitCode();
+    return chunk;
+}
+
+void IrCodegen::splitCriticalEdges() {
+    size_t count = fn.blocks.size();
+    for (size_t s = 0; s < count; ++s) {
+        bool hasPhis = false;
+        for (IrInst& phi : fn.blocks[s].phis)
+            hasPhis = hasPhis || !phi.removed;
+        if (!hasPhis || fn.blocks[s].dead) continue;
+        for (size_t i = 0; i < fn.blocks[s].preds.size(); ++i) {
+            int p = fn.blocks[s].preds[i];
+            if (fn.blocks[p].succCount() < 2) continue;
+            int n = fn.newBlock();
+            IrBlock& edge = fn.blocks[n];
+            edge.term = TERM_JUMP;
+            edge.succ[0] = s;
+            edge.preds.push_back(p);
+            edge.sealed = true;
+            for (int& succ : fn.blocks[p].succ)
+                if (succ == (int)s) { succ = n; break; }
+            fn.blocks[s].preds[i] = n;
+        }
+    }
+}
+
+void IrCodegen::eliminatePhis() {
+    copies.assign(fn.blocks.size(), vector<pair<int, int>>());
+    for (IrBlock& block : fn.blocks) {
+        if (block.dead) continue;
+        for (IrInst& phi : block.phis) {
+            if (phi.removed) continue;
+            for (size_t i = 0; i < block.preds.size(); ++i)
+                if (phi.args[i] != phi.dest)
+                    copies[block.preds[i]].push_back({phi.dest, phi.args[i]});
+            phi.removed = true;
+        }
+    }
+}
+
+int IrCodegen::find(int v) {
+    while (parent[v] != v)
+        v = parent[v] = parent[parent[v]];
+    return v;
+}
+
+void IrCodegen::interfere(int a, int b) {
+    if (a == b) return;
+    adj[a].insert(b);
+    adj[b].insert(a);
+}
+
+// Liveness by backward dataflow, then one more backward walk over every
+// block recording which values are live where each one is defined
+void IrCodegen::buildInterference() {
+    size_t n = fn.values.size();
+    parent.resize(n);
+    for (size_t v = 0; v < n; ++v) parent[v] = v;
+    adj.assign(n, unordered_set<int>());
+
+    vector<vector<int>> liveIn(fn.blocks.size());
+    vector<char> inSet(n, 0);
+    vector<int> live;
+
+    auto add = [&](int v) {
+        if (isValue(v) && !inSet[v]) { inSet[v] = 1; live.push_back(v); }
+    };
+    auto remove = [&](int v) {
+        if (!inSet[v]) return;
+        inSet[v] = 0;
+        live.erase(find_if(live.begin(), live.end(), [v](int x) { return x == v; }));
+    };
+
+    // walk block b backwards from its live-out set; with record set, add
+    // the interference edges as well
+    auto scan = [&](int b, bool record) {
+        IrBlock& block = fn.blocks[b];
+        for (int v : live) inSet[v] = 0;
+        live.clear();
+        for (int i = 0; i < block.succCount(); ++i)
+            for (int v : liveIn[block.succ[i]]) add(v);
+        if (block.term == TERM_BRANCH) add(block.cond);
+
+        // parallel copies: a destination does not interfere with its source
+        for (auto& c : copies[b])
+            if (record)
+                for (int v : live)
+                    if (v != c.first && v != c.second) interfere(c.first, v);
+        for (auto& c : copies[b]) remove(c.first);
+        for (auto& c : copies[b]) add(c.second);
+
+        for (size_t i = block.insts.size(); i-- > 0; ) {
+            IrInst& in = block.insts[i];
+            if (in.removed) continue;
+            if (in.dest != NO_VALUE) {
+                if (record)
+                    for (int v : live) interfere(in.dest, v);
+                remove(in.dest);
+            }
+            for (int a : in.args) add(a);
+        }
+    };
+
+    vector<int> postorder(layout.rbegin(), layout.rend());
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int b : postorder) {
+            scan(b, false);
+            sort(live.begin(), live.end());
+            if (live != liveIn[b]) {
+                liveIn[b] = live;
+                changed = true;
+            }
+        }
+    }
+    for (int b : postorder)
+        scan(b, true);
+}
+
+// Merge the two sides of every copy that do not interfere
+void IrCodegen::coalesce() {
+    for (int b : layout) {
+        for (auto& c : copies[b]) {
+            if (!isValue(c.second)) continue;
+            int x = find(c.first), y = find(c.second);
+            if (x == y) continue;
+            if (adj[x].size() > adj[y].size()) swap(x, y);
+            bool conflict = false;
+            for (int v : adj[x])
+                if (find(v) == y) { conflict = true; break; }
+            if (conflict) continue;
+            parent[x] = y;
+            for (int v : adj[x]) {
+                adj[y].insert(v);
+                adj[v].insert(y);
+            }
+            adj[x].clear();
+        }
+    }
+}
+
+void IrCodegen::assignRegisters() {
+    color.assign(fn.values.size(), -1);
+    vector<int> classes;  // in order of first definition
+    auto define = [&](int v) {
+        int c = find(v);
+        if (color[c] == -2) return;
+        color[c] = -2;
+        classes.push_back(c);
+    };
+    for (int b : layout) {
+        for (IrInst& in : fn.blocks[b].insts)
+            if (!in.removed && in.dest != NO_VALUE) define(in.dest);
+        for (auto& c : copies[b]) define(c.first);
+    }
+
+    // the variable each register holds, if there is just one
+    vector<int> var(fn.values.size(), -1);
+    for (size_t v = 0; v < fn.values.size(); ++v) {
+        if (!isValue(v) || fn.values[v].var < 0) continue;
+        int c = find(v);
+        var[c] = var[c] == -1 || var[c] == fn.values[v].var ? fn.values[v].var : -2;
+    }
+
+    int numRegs = 0;
+    vector<int> taken;
+    for (int c : classes) {
+        taken.assign(numRegs + 1, 0);
+        for (int v : adj[c]) {
+            int r = color[find(v)];
+            if (r >= 0) taken[r] = 1;
+        }
+        int r = 0;
+        while (taken[r]) ++r;
+        color[c] = r;
+        numRegs = max(numRegs, r + 1);
+    }
+
+    // name each register after the variable it holds, if there is just one
+    vector<int> regVar(numRegs, -1);
+    chunk.varTypes.assign(numRegs, TYPE_INTEGER);
+    for (int c : classes) {
+        int& v = regVar[color[c]];
+        chunk.varTypes[color[c]] = fn.values[c].type;
+        if (var[c] != -1) v = v == -1 || v == var[c] ? var[c] : -2;
+    }
+    map<int, int> uses;
+    chunk.varNames.clear();
+    for (int r = 0; r < numRegs; ++r) {
+        if (regVar[r] < 0) {
+            chunk.varNames.push_back("r" + to_string(r));
+            continue;
+        }
+        int n = uses[regVar[r]]++;
+        string name = fn.varNames[regVar[r]];
+        chunk.varNames.push_back(n ? name + "." + to_string(n) : name);
+    }
+    chunk.numVars = numRegs;
+}
+
+uint32_t IrCodegen::reg(int v) {
+    const IrValue& val = fn.values[v];
+    if (!val.isConst)
+        return color[find(v)];
+    Value k = val.type == TYPE_REAL ? Value::real(val.constant.f) : Value::integer(val.constant.i);
+    auto key = make_pair(k.isReal, val.constant.i);
+    auto found = constIndex.find(key);
+    if (found != constIndex.end())
+        return BytecodeCompiler::REG_CONST | found->second;
+    uint32_t index = chunk.constants.size();
+    chunk.constants.push_back(k);
+    constIndex[key] = index;
+    return BytecodeCompiler::REG_CONST | index;
+}
+
+// Emit a parallel copy as MOVEs, breaking cycles through the scratch
+// register
+void IrCodegen::sequentialize(const vector<pair<uint32_t, uint32_t>>& moves) {
+    const uint32_t SCRATCH = BytecodeCompiler::REG_TEMP;
+    vector<pair<uint32_t, uint32_t>> pending;
+    for (auto& m : moves)
+        if (m.first != m.second) pending.push_back(m);
+    while (!pending.empty()) {
+        bool progress = false;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            uint32_t dest = pending[i].first;
+            bool needed = false;
+            for (auto& other : pending)
+                needed = needed || other.second == dest;
+            if (needed) continue;
+            Instr in = {OP_MOVE, dest, pending[i].second, 0};
+            chunk.code.push_back(in);
+            pending.erase(pending.begin() + i);
+            progress = true;
+            break;
+        }
+        if (progress) continue;
+        // only cycles are left: save one destination and read it from there
+        uint32_t saved = pending[0].first;
+        Instr in = {OP_MOVE, SCRATCH, saved, 0};
+        chunk.code.push_back(in);
+        scratchUsed = true;
+        for (auto& m : pending)
+            if (m.second == saved) m.second = SCRATCH;
+    }
+}
+
+// The index of the last instruction of block b before the one at before
+// that has not been removed, or -1
+int IrCodegen::lastInst(int b, int before) {
+    const IrBlock& block = fn.blocks[b];
+    while (before-- > 0)
+        if (!block.insts[before].removed) return before;
+    return -1;
+}
+
+// Whether the condition of block b is read by its branch alone
+bool IrCodegen::onlyBranchReads(int b) {
+    int cond = fn.blocks[b].cond;
+    for (size_t other = 0; other < fn.blocks.size(); ++other) {
+        const IrBlock& block = fn.blocks[other];
+        if (block.dead) continue;
+        for (const IrInst& in : block.insts)
+            if (!in.removed && std::find(in.args.begin(), in.args.end(), cond) != in.args.end()) return false;
+        if ((int)other != b && block.term == TERM_BRANCH && block.cond == cond) return false;
+        for (const auto& copy : copies[other])
+            if (copy.second == cond) return false;
+    }
+    return true;
+}
+
+// The end of a FOR iteration as IrBuilder lowers it, if it can be one FORUP
+// or FORDN: block b ends in c = LTI i, limit (GTI going down) and then
+// i' = ADDI i, #1 (SUBI) in i's own register, and branches on c. Returns
+// the index of the compare, or -1.
+int IrCodegen::countedLoop(int b) {
+    const IrBlock& block = fn.blocks[b];
+    int last = lastInst(b, block.insts.size());
+    int compare = last >= 0 ? lastInst(b, last) : -1;
+    if (compare < 0)
+        return -1;
+    const IrInst& test = block.insts[compare];
+    const IrInst& step = block.insts[last];
+    bool up = test.op == OP_LTI && step.op == OP_ADDI, down = test.op == OP_GTI && step.op == OP_SUBI;
+    if (test.kind != IR_OP || step.kind != IR_OP || (!up && !down) || test.dest != block.cond)
+        return -1;
+    int i = test.args[0], one = step.args[1];
+    if (step.args[0] != i || !fn.values[one].isConst || fn.values[one].constant.i != 1 ||
+        !isValue(i) || reg(step.dest) != reg(i) || reg(test.args[1]) == reg(i))
+        return -1;
+    return compare;
+}
+
+void IrCodegen::emitCode() {
+    // the MOVEs each block ends with; a block with none and nothing else to
+    // do is jumped over
+    vector<vector<pair<uint32_t, uint32_t>>> moves(fn.blocks.size());
+    vector<char> empty(fn.blocks.size(), 0);
+    for (int b : layout) {
+        for (auto& c : copies[b]) {
+            uint32_t dest = reg(c.first), source = reg(c.second);
+            if (dest != source) moves[b].push_back({dest, source});
+        }
+        bool none = moves[b].empty() && fn.blocks[b].term == TERM_JUMP && b != layout[0];
+        for (IrInst& in : fn.blocks[b].insts)
+            none = none && in.removed;
+        empty[b] = none;
+    }
+    auto target = [&](int b) {
+        for (size_t steps = 0; empty[b] && steps < fn.blocks.size(); ++steps)
+            b = fn.blocks[b].succ[0];
+        return b;
+    };
+    // a cycle of empty blocks is a loop doing nothing, forever: one of them
+    // stays to jump to itself
+    for (int b : layout)
+        if (empty[b] && empty[target(b)]) empty[target(b)] = 0;
+
+    vector<uint32_t> start(fn.blocks.size(), 0);
+    vector<pair<uint32_t, int>> fixups;  // jump instruction, block
+    auto jump = [&](Opcode op, uint32_t cond, int b) {
+        Instr in = {op, cond, 0, 0};
+        fixups.push_back({(uint32_t)chunk.code.size(), b});
+        chunk.code.push_back(in);
+    };
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        int b = layout[i];
+        if (empty[b]) continue;
+        IrBlock& block = fn.blocks[b];
+        start[b] = chunk.code.size();
+
+        for (IrInst& in : block.insts) {
+            if (in.removed) continue;
+            Instr code = {in.op, 0, 0, 0};
+            if (in.op == OP_WRITES)
+                code.b = in.imm;
+            else if (in.dest == NO_VALUE)
+                code.a = reg(in.args[0]);
+            else {
+                code.a = reg(in.dest);
+                if (in.args.size() > 0) code.b = reg(in.args[0]);
+                if (in.args.size() > 1) code.c = reg(in.args[1]);
+                if (opcodeInfo[in.op].c == OPND_I) code.c = in.imm;
+            }
+            chunk.code.push_back(code);
+        }
+        sequentialize(moves[b]);
+
+        size_t next = i + 1;
+        while (next < layout.size() && empty[layout[next]]) ++next;
+        int fallthrough = next < layout.size() ? layout[next] : -1;
+        switch (block.term) {
+        case TERM_JUMP:
+            if (target(block.succ[0]) != fallthrough)
+                jump(OP_JMP, 0, target(block.succ[0]));
+            break;
+        case TERM_BRANCH: {
+            int ifTrue = target(block.succ[0]), ifFalse = target(block.succ[1]);
+            uint32_t cond = reg(block.cond);
+            // the instructions just emitted that only compute the condition
+            // can become part of the jump
+            bool fold = moves[b].empty() && onlyBranchReads(b);
+            int last = fold ? lastInst(b, block.insts.size()) : -1;
+            int compare = fold ? countedLoop(b) : -1;
+            if (compare >= 0) {
+                const IrInst& test = block.insts[compare];
+                chunk.code.resize(chunk.code.size() - 2);
+                jump(test.op == OP_LTI ? OP_FORUP : OP_FORDN, reg(test.args[0]), ifTrue);
+                chunk.code.back().c = reg(test.args[1]);
+                if (ifFalse != fallthrough)
+                    jump(OP_JMP, 0, ifFalse);
+                break;
+            }
+            if (last >= 0 && block.insts[last].op == OP_NOT && block.insts[last].dest == block.cond) {
+                // branch on the operand of NOT the other way
+                chunk.code.pop_back();
+                cond = reg(block.insts[last].args[0]);
+                swap(ifTrue, ifFalse);
+            }
+            if (ifFalse == fallthrough)
+                jump(OP_JMPT, cond, ifTrue);
+            else if (ifTrue == fallthrough)
+                jump(OP_JMPF, cond, ifFalse);
+            else {
+                jump(OP_JMPT, cond, ifTrue);
+                jump(OP_JMP, 0, ifFalse);
+            }
+            break;
+        }
+        case TERM_HALT: {
+            Instr in = {OP_HALT, 0, 0, 0};
+            chunk.code.push_back(in);
+            break;
+        }
+        }
+    }
+    for (auto& f : fixups)
+        chunk.code[f.first].b = start[f.second];
+
+    // constant and scratch registers go after the value registers
+    chunk.strings = fn.strings;
+    chunk.numRegs = chunk.firstTemp() + (scratchUsed ? 1 : 0);
+    auto relocate = [&](uint32_t r) -> uint32_t {
+        if (r & BytecodeCompiler::REG_TEMP) return chunk.firstTemp() + (r & ~BytecodeCompiler::REG_TEMP);
+        if (r & BytecodeCompiler::REG_CONST) return chunk.firstConst() + (r & ~BytecodeCompiler::REG_CONST);
+        return r;
+    };
+    for (Instr& in : chunk.code) {
+        const OpcodeInfo& info = opcodeInfo[in.op];
+        if (info.a == OPND_R) in.a = relocate(in.a);
+        if (info.b == OPND_R) in.b = relocate(in.b);
+        if (info.c == OPND_R) in.c = relocate(in.c);
+    }
+}
+
+#endif /* IR_CODEGEN_H */
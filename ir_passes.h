@@ -0,0 +1,618 @@
+//*****************************************************************************
+// Optimization passes over the SSA form of ir.h
+//
+//   constprop  operations on constants are evaluated, phis whose arguments
+//              all agree are replaced by that value, branches on a constant
+//              become jumps and the blocks no longer reached are dropped
+//   cse        an operation computed again with the same operands, in a
+//              block dominated by the first one, reuses its result
+//   dce        values nothing depends on are removed; this is where stores
+//              to variables that are never read again disappear
+//   licm       operations of a WHILE body whose operands are not computed
+//              in the loop move to a preheader block run once before it
+//   strength   INTEGER *, / and MOD by a power of two become shifts and
+//              masks (SHLI, DIVPI, MODPI)
+//
+// The pass manager runs them in turn until none of them changes anything.
+// Operations that can trap (DIVI and MODI by a divisor not known to be
+// nonzero) are never folded or removed, so a program fails at run time
+// exactly as it did before optimization.
+//*****************************************************************************
+#ifndef IR_PASSES_H
+#define IR_PASSES_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+#include "ir.h"
+
+using namespace std;
+
+// Evaluate a pure opcode as the VM would; false when it would trap
+bool foldOpcode(Opcode op, Slot b, Slot c, Slot& a) {
+    switch (op) {
+    case OP_ADDI: a.i = addI(b.i, c.i); return true;
+    case OP_SUBI: a.i = subI(b.i, c.i); return true;
+    case OP_MULI: a.i = mulI(b.i, c.i); return true;
+    case OP_SHLI: a.i = (int64_t)((uint64_t)b.i << c.i); return true;
+    case OP_DIVPI: a.i = divPow2(b.i, c.i); return true;
+    case OP_MODPI: a.i = modPow2(b.i, c.i); return true;
+    case OP_DIVI:
+    case OP_MODI:
+        if (c.i == 0) return false;
+        a.i = op == OP_DIVI ? divI(b.i, c.i) : modI(b.i, c.i);
+        return true;
+    case OP_ADDF: a.f = b.f + c.f; return true;
+    case OP_SUBF: a.f = b.f - c.f; return true;
+    case OP_MULF: a.f = b.f * c.f; return true;
+    case OP_DIVF: a.f = b.f / c.f; return true;
+    case OP_EQI:  a.i = b.i == c.i; return true;
+    case OP_NEI:  a.i = b.i != c.i; return true;
+    case OP_LTI:  a.i = b.i < c.i; return true;
+    case OP_GTI:  a.i = b.i > c.i; return true;
+    case OP_EQF:  a.i = b.f == c.f; return true;
+    case OP_NEF:  a.i = b.f != c.f; return true;
+    case OP_LTF:  a.i = b.f < c.f; return true;
+    case OP_GTF:  a.i = b.f > c.f; return true;
+    case OP_AND:  a.i = b.i != 0 && c.i != 0; return true;
+    case OP_OR:   a.i = b.i != 0 || c.i != 0; return true;
+    case OP_NEGI: a.i = negI(b.i); return true;
+    case OP_NEGF: a.f = -b.f; return true;
+    case OP_NOT:  a.i = b.i == 0; return true;
+    case OP_I2F:  a.f = (double)b.i; return true;
+    default:      return false;
+    }
+}
+
+// No effect besides its result: may be folded, shared or removed
+bool isPure(const IrInst& in) {
+    if (in.kind != IR_OP) return true;
+    switch (in.op) {
+    case OP_READI: case OP_READF: case OP_WRITEI: case OP_WRITEF: case OP_WRITES:
+        return false;
+    default:
+        return true;
+    }
+}
+
+bool isCommutative(Opcode op) {
+    switch (op) {
+    case OP_ADDI: case OP_MULI: case OP_ADDF: case OP_MULF:
+    case OP_EQI: case OP_NEI: case OP_EQF: case OP_NEF: case OP_AND: case OP_OR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+//*****************************************************************************
+// Passes and the pass manager
+class IrPass {
+public:
+    virtual ~IrPass() {}
+    virtual const char* name() const = 0;
+    virtual int run(IrFunction& fn) = 0;  // number of changes made
+};
+
+class PassManager {
+public:
+    vector<unique_ptr<IrPass>> passes;
+    vector<int> changes;  // per pass, over all rounds
+    int rounds = 0;
+
+    void add(IrPass* pass) { passes.emplace_back(pass); changes.push_back(0); }
+    void run(IrFunction& fn, int maxRounds = 10);
+    void report(FILE* out) const;
+};
+
+void PassManager::run(IrFunction& fn, int maxRounds) {
+    for (rounds = 1; rounds <= maxRounds; ++rounds) {
+        int changed = 0;
+        for (size_t i = 0; i < passes.size(); ++i) {
+            int n = passes[i]->run(fn);
+            changes[i] += n;
+            changed += n;
+        }
+        if (!changed) break;
+    }
+    fn.canonicalize();
+}
+
+void PassManager::report(FILE* out) const {
+    fprintf(out, "IR:");
+    for (size_t i = 0; i < passes.size(); ++i)
+        fprintf(out, " %s %d,", passes[i]->name(), changes[i]);
+    fprintf(out, " %d rounds\n", rounds);
+}
+
+//*****************************************************************************
+// Constant propagation and unreachable code removal
+class ConstantPropagation : public IrPass {
+public:
+    const char* name() const { return "constprop"; }
+    int run(IrFunction& fn);
+    int removeUnreachable(IrFunction& fn);
+};
+
+int ConstantPropagation::run(IrFunction& fn) {
+    int changes = 0;
+    for (size_t b = 0; b < fn.blocks.size(); ++b) {
+        IrBlock& block = fn.blocks[b];
+        if (block.dead) continue;
+
+        for (IrInst& phi : block.phis) {
+            if (phi.removed) continue;
+            int same = NO_VALUE;
+            bool unique = true;
+            for (int& a : phi.args) {
+                a = fn.resolve(a);
+                if (a == phi.dest || a == same) continue;
+                if (same == NO_VALUE) { same = a; continue; }
+                const IrValue& x = fn.values[same];
+                const IrValue& y = fn.values[a];
+                if (!(x.isConst && y.isConst && x.constant.i == y.constant.i)) unique = false;
+            }
+            if (!unique || same == NO_VALUE) continue;
+            phi.removed = true;
+            fn.replace(phi.dest, same);
+            ++changes;
+        }
+
+        for (IrInst& in : block.insts) {
+            if (in.removed || in.kind != IR_OP || !isPure(in)) continue;
+            Slot x[2] = {};
+            bool constant = true;
+            for (size_t i = 0; i < in.args.size(); ++i) {
+                in.args[i] = fn.resolve(in.args[i]);
+                if (!fn.values[in.args[i]].isConst) { constant = false; break; }
+                x[i] = fn.values[in.args[i]].constant;
+            }
+            if (opcodeInfo[in.op].c == OPND_I) x[1].i = in.imm;
+            Slot result;
+            if (!constant || !foldOpcode(in.op, x[0], x[1], result)) continue;
+            in.removed = true;
+            fn.replace(in.dest, fn.constant(fn.values[in.dest].type, result));
+            ++changes;
+        }
+
+        if (block.term == TERM_BRANCH) {
+            block.cond = fn.resolve(block.cond);
+            if (fn.values[block.cond].isConst) {
+                bool taken = fn.values[block.cond].constant.i != 0;
+                int keep = block.succ[taken ? 0 : 1];
+                int drop = block.succ[taken ? 1 : 0];
+                block.term = TERM_JUMP;
+                block.succ[0] = keep;
+                block.succ[1] = -1;
+                block.cond = NO_VALUE;
+                fn.removeEdge(b, drop);
+                ++changes;
+            }
+        }
+    }
+    return changes + removeUnreachable(fn);
+}
+
+int ConstantPropagation::removeUnreachable(IrFunction& fn) {
+    vector<char> reached(fn.blocks.size(), 0);
+    for (int b : fn.reversePostorder())
+        reached[b] = 1;
+    int changes = 0;
+    for (size_t b = 0; b < fn.blocks.size(); ++b) {
+        IrBlock& block = fn.blocks[b];
+        if (reached[b] || block.dead) continue;
+        for (int i = 0; i < block.succCount(); ++i)
+            fn.removeEdge(b, block.succ[i]);
+        block.dead = true;
+        block.term = TERM_HALT;
+        ++changes;
+    }
+    return changes;
+}
+
+//*****************************************************************************
+// Dominator tree, by the iterative algorithm of Cooper, Harvey and Kennedy,
+// "A Simple, Fast Dominance Algorithm" (2001)
+class Dominators {
+public:
+    vector<int> order;     // reverse postorder
+    vector<int> rpoIndex;  // block -> position in order, -1 if unreachable
+    vector<int> idom;      // immediate dominator, -1 for the entry
+    vector<vector<int>> children;
+
+    Dominators(IrFunction& fn);
+    bool dominates(int a, int b) const;
+};
+
+Dominators::Dominators(IrFunction& fn) {
+    order = fn.reversePostorder();
+    rpoIndex.assign(fn.blocks.size(), -1);
+    for (size_t i = 0; i < order.size(); ++i)
+        rpoIndex[order[i]] = i;
+    idom.assign(fn.blocks.size(), -1);
+    idom[0] = 0;
+
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (rpoIndex[a] > rpoIndex[b]) a = idom[a];
+            while (rpoIndex[b] > rpoIndex[a]) b = idom[b];
+        }
+        return a;
+    };
+
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t i = 1; i < order.size(); ++i) {
+            int b = order[i];
+            int dom = -1;
+            for (int p : fn.blocks[b].preds) {
+                if (rpoIndex[p] < 0 || idom[p] < 0) continue;
+                dom = dom < 0 ? p : intersect(p, dom);
+            }
+            if (dom != idom[b]) {
+                idom[b] = dom;
+                changed = true;
+            }
+        }
+    }
+
+    idom[0] = -1;
+    children.assign(fn.blocks.size(), vector<int>());
+    for (size_t i = 1; i < order.size(); ++i)
+        children[idom[order[i]]].push_back(order[i]);
+}
+
+bool Dominators::dominates(int a, int b) const {
+    while (b >= 0 && b != a)
+        b = idom[b];
+    return b == a;
+}
+
+//*****************************************************************************
+// Common subexpression elimination: a walk down the dominator tree with a
+// scoped table from (opcode, operands) to the value first computing them.
+// Equal constants are merged first, so they compare equal as operands.
+class CommonSubexpressions : public IrPass {
+public:
+    const char* name() const { return "cse"; }
+    int run(IrFunction& fn);
+};
+
+int CommonSubexpressions::run(IrFunction& fn) {
+    int changes = 0;
+    fn.canonicalize();
+
+    map<pair<int, int64_t>, int> constants;  // (type, bits) -> value
+    for (size_t v = 0; v < fn.values.size(); ++v) {
+        IrValue& val = fn.values[v];
+        if (!val.isConst || val.alias != NO_VALUE) continue;
+        auto key = make_pair((int)val.type, val.constant.i);
+        auto found = constants.find(key);
+        if (found == constants.end())
+            constants[key] = v;
+        else
+            fn.replace(v, found->second);
+    }
+
+    Dominators dom(fn);
+    map<vector<int64_t>, int> available;
+    vector<vector<int64_t>> added;  // keys in the order they were made available
+    vector<pair<int, size_t>> stack{{0, 0}};  // block, size of added on entry
+
+    auto lookup = [&](vector<int64_t>& key, int dest) {
+        auto found = available.find(key);
+        if (found != available.end()) {
+            fn.replace(dest, found->second);
+            ++changes;
+            return true;
+        }
+        available[key] = dest;
+        added.push_back(key);
+        return false;
+    };
+
+    // depth-first over the dominator tree; a block is visited when pushed
+    // and its entries are withdrawn when it is popped
+    vector<size_t> nextChild(fn.blocks.size(), 0);
+    for (bool enter = true; !stack.empty(); ) {
+        int b = stack.back().first;
+        IrBlock& block = fn.blocks[b];
+        if (enter) {
+            for (IrInst& phi : block.phis) {
+                if (phi.removed) continue;
+                vector<int64_t> key{-1 - b};
+                for (int a : phi.args) key.push_back(fn.resolve(a));
+                if (lookup(key, phi.dest)) phi.removed = true;
+            }
+            for (IrInst& in : block.insts) {
+                if (in.removed || !isPure(in)) continue;
+                vector<int> args;
+                for (int a : in.args) args.push_back(fn.resolve(a));
+                if (isCommutative(in.op) && args.size() == 2 && args[0] > args[1])
+                    swap(args[0], args[1]);
+                vector<int64_t> key{in.op, in.imm};
+                key.insert(key.end(), args.begin(), args.end());
+                if (lookup(key, in.dest)) in.removed = true;
+            }
+        }
+        if (nextChild[b] < dom.children[b].size()) {
+            stack.push_back({dom.children[b][nextChild[b]++], added.size()});
+            enter = true;
+            continue;
+        }
+        for (size_t i = stack.back().second; i < added.size(); ++i)
+            available.erase(added[i]);
+        added.resize(stack.back().second);
+        stack.pop_back();
+        enter = false;
+    }
+    fn.canonicalize();
+    return changes;
+}
+
+//*****************************************************************************
+// Dead code elimination: mark what the program's effects depend on (output,
+// input, branches and operations that may trap), remove the rest
+class DeadCodeElimination : public IrPass {
+public:
+    const char* name() const { return "dce"; }
+    int run(IrFunction& fn);
+};
+
+bool mayTrap(IrFunction& fn, const IrInst& in) {
+    if (in.kind != IR_OP || (in.op != OP_DIVI && in.op != OP_MODI)) return false;
+    const IrValue& divisor = fn.values[fn.resolve(in.args[1])];
+    return !divisor.isConst || divisor.constant.i == 0 || divisor.constant.i == -1;
+}
+
+int DeadCodeElimination::run(IrFunction& fn) {
+    fn.canonicalize();
+    vector<IrInst*> def(fn.values.size(), nullptr);
+    vector<char> live(fn.values.size(), 0);
+    vector<int> work;
+
+    auto use = [&](int v) {
+        if (!live[v]) { live[v] = 1; work.push_back(v); }
+    };
+    auto critical = [&](IrInst& in) {
+        if (in.dest != NO_VALUE) use(in.dest);
+        for (int a : in.args) use(a);
+    };
+
+    for (IrBlock& block : fn.blocks) {
+        if (block.dead) continue;
+        for (IrInst& phi : block.phis)
+            if (!phi.removed) def[phi.dest] = &phi;
+        for (IrInst& in : block.insts) {
+            if (in.removed) continue;
+            if (in.dest != NO_VALUE) def[in.dest] = &in;
+            if (!isPure(in) || mayTrap(fn, in)) critical(in);
+        }
+        if (block.term == TERM_BRANCH) use(block.cond);
+    }
+
+    while (!work.empty()) {
+        int v = work.back();
+        work.pop_back();
+        if (def[v])
+            for (int a : def[v]->args) use(a);
+    }
+
+    int changes = 0;
+    for (IrBlock& block : fn.blocks) {
+        if (block.dead) continue;
+        for (IrInst& phi : block.phis)
+            if (!phi.removed && !live[phi.dest]) { phi.removed = true; ++changes; }
+        for (IrInst& in : block.insts)
+            if (!in.removed && in.dest != NO_VALUE && !live[in.dest]) { in.removed = true; ++changes; }
+    }
+    return changes;
+}
+
+//*****************************************************************************
+// Strength reduction of INTEGER arithmetic by powers of two. In the VM one
+// shift replaces one multiply or divide, so only the fused forms are used,
+// never a longer sequence.
+class StrengthReduction : public IrPass {
+public:
+    const char* name() const { return "strength"; }
+    int run(IrFunction& fn);
+};
+
+// k when v = 2^k, else -1
+int log2Exact(IrFunction& fn, int v) {
+    const IrValue& val = fn.values[fn.resolve(v)];
+    if (!val.isConst || val.type != TYPE_INTEGER || val.constant.i <= 0) return -1;
+    int64_t x = val.constant.i;
+    if (x & (x - 1)) return -1;
+    int k = 0;
+    while (x > 1) { x >>= 1; ++k; }
+    return k;
+}
+
+int StrengthReduction::run(IrFunction& fn) {
+    int changes = 0;
+    for (IrBlock& block : fn.blocks) {
+        if (block.dead) continue;
+        for (IrInst& in : block.insts) {
+            if (in.removed || in.kind != IR_OP) continue;
+            int k, x;
+            if (in.op == OP_MULI && (k = log2Exact(fn, in.args[1])) >= 0)
+                x = in.args[0];
+            else if (in.op == OP_MULI && (k = log2Exact(fn, in.args[0])) >= 0)
+                x = in.args[1];
+            else if ((in.op == OP_DIVI || in.op == OP_MODI) && (k = log2Exact(fn, in.args[1])) >= 0)
+                x = in.args[0];
+            else
+                continue;
+
+            if (k == 0) {  // X * 1, X / 1, X MOD 1
+                in.removed = true;
+                fn.replace(in.dest, in.op == OP_MODI ? fn.constInt(0) : x);
+            }
+            else {
+                in.op = in.op == OP_MULI ? OP_SHLI : in.op == OP_DIVI ? OP_DIVPI : OP_MODPI;
+                in.args.assign(1, x);
+                in.imm = k;
+            }
+            ++changes;
+        }
+    }
+    return changes;
+}
+
+//*****************************************************************************
+// Loops. A back edge goes from a block to one dominating it; the natural
+// loop of its target (the header) is every block that reaches the edge
+// without passing through the header.
+struct IrLoop {
+    int header;
+    vector<int> blocks;  // including the header
+};
+
+vector<IrLoop> findLoops(IrFunction& fn, const Dominators& dom) {
+    map<int, vector<int>> latches;  // header -> sources of its back edges
+    for (int b : dom.order) {
+        IrBlock& block = fn.blocks[b];
+        for (int i = 0; i < block.succCount(); ++i)
+            if (dom.dominates(block.succ[i], b))
+                latches[block.succ[i]].push_back(b);
+    }
+
+    vector<IrLoop> loops;
+    vector<char> seen(fn.blocks.size(), 0);
+    for (auto& entry : latches) {
+        IrLoop loop;
+        loop.header = entry.first;
+        seen[loop.header] = 1;
+        loop.blocks.push_back(loop.header);
+        vector<int> work = entry.second;
+        while (!work.empty()) {
+            int b = work.back();
+            work.pop_back();
+            if (seen[b] || dom.rpoIndex[b] < 0) continue;
+            seen[b] = 1;
+            loop.blocks.push_back(b);
+            for (int p : fn.blocks[b].preds) work.push_back(p);
+        }
+        for (int b : loop.blocks) seen[b] = 0;
+        loops.push_back(loop);
+    }
+    return loops;
+}
+
+//*****************************************************************************
+// Loop-invariant code motion. Each loop gets a preheader: a block whose only
+// successor is the header and which runs once each time the loop is
+// entered. Loops are rotated (see IrBuilder), so the header then runs at
+// least once, and an operation of the header that may trap can be hoisted
+// as long as no input, output or other trap comes before it. Anywhere else
+// only operations that cannot trap are hoisted; they may then run when the
+// loop would not have, which changes nothing but time.
+class LoopInvariantCodeMotion : public IrPass {
+public:
+    const char* name() const { return "licm"; }
+    int run(IrFunction& fn);
+    int preheader(IrFunction& fn, const IrLoop& loop, bool create);
+};
+
+int LoopInvariantCodeMotion::preheader(IrFunction& fn, const IrLoop& loop, bool create) {
+    int h = loop.header;
+    int outside = -1;
+    for (int p : fn.blocks[h].preds) {
+        if (find(loop.blocks.begin(), loop.blocks.end(), p) != loop.blocks.end()) continue;
+        if (outside >= 0) return -1;
+        outside = p;
+    }
+    if (outside < 0)
+        return -1;
+    if (fn.blocks[outside].succCount() == 1)
+        return outside;
+    if (!create)
+        return -1;
+
+    int n = fn.newBlock();
+    IrBlock& pre = fn.blocks[n];
+    pre.term = TERM_JUMP;
+    pre.succ[0] = h;
+    pre.preds.push_back(outside);
+    pre.sealed = true;
+    for (int& succ : fn.blocks[outside].succ)
+        if (succ == h) { succ = n; break; }
+    for (int& p : fn.blocks[h].preds)
+        if (p == outside) { p = n; break; }
+    return n;
+}
+
+int LoopInvariantCodeMotion::run(IrFunction& fn) {
+    fn.canonicalize();
+
+    // make the preheaders first: they belong to the loops around them
+    {
+        Dominators dom(fn);
+        for (const IrLoop& loop : findLoops(fn, dom))
+            preheader(fn, loop, true);
+    }
+    Dominators dom(fn);
+    vector<IrLoop> loops = findLoops(fn, dom);
+    sort(loops.begin(), loops.end(), [](const IrLoop& a, const IrLoop& b) {
+        return a.blocks.size() < b.blocks.size();  // inner loops first
+    });
+
+    vector<int> defBlock(fn.values.size(), -1);
+    for (size_t b = 0; b < fn.blocks.size(); ++b) {
+        if (fn.blocks[b].dead) continue;
+        for (IrInst& phi : fn.blocks[b].phis)
+            if (!phi.removed) defBlock[phi.dest] = b;
+        for (IrInst& in : fn.blocks[b].insts)
+            if (!in.removed && in.dest != NO_VALUE) defBlock[in.dest] = b;
+    }
+
+    int changes = 0;
+    vector<char> inLoop(fn.blocks.size(), 0);
+    for (const IrLoop& loop : loops) {
+        int pre = preheader(fn, loop, false);
+        if (pre < 0) continue;
+        for (int b : loop.blocks) inLoop[b] = 1;
+
+        for (int b : dom.order) {
+            if (!inLoop[b]) continue;
+            bool barrier = b != loop.header;  // a trap must not move ahead
+            for (size_t i = 0; i < fn.blocks[b].insts.size(); ++i) {
+                IrInst& in = fn.blocks[b].insts[i];
+                if (in.removed) continue;
+                bool traps = mayTrap(fn, in);
+                bool invariant = isPure(in) && !(traps && barrier);
+                for (int a : in.args)
+                    invariant = invariant && (defBlock[a] < 0 || !inLoop[defBlock[a]]);
+                if (!invariant) {
+                    barrier = barrier || traps || !isPure(in);
+                    continue;
+                }
+                IrInst moved = in;
+                in.removed = true;
+                defBlock[moved.dest] = pre;
+                fn.blocks[pre].insts.push_back(moved);
+                ++changes;
+            }
+        }
+        for (int b : loop.blocks) inLoop[b] = 0;
+    }
+    return changes;
+}
+
+// The standard pipeline
+void addStandardPasses(PassManager& pm) {
+    pm.add(new ConstantPropagation);
+    pm.add(new CommonSubexpressions);
+    pm.add(new DeadCodeElimination);
+    pm.add(new LoopInvariantCodeMotion);
+    pm.add(new StrengthReduction);
+}
+
+#endif /* IR_PASSES_H */
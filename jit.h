@@ -0,0 +1,468 @@
+//*****************************************************************************
+// x86-64 JIT for the bytecode of bytecode.h
+//
+// Each bytecode instruction is translated to a fixed sequence of machine
+// code, so the dispatch of the VM disappears and the program runs as one
+// straight native function. The bytecode registers stay in their frame:
+// variables, constants and temporaries are memory operands addressed from
+// rbx, which modern CPUs forward from store to load quickly enough that the
+// loop counter of a typical TIPS program costs a few cycles.
+//
+// The code lives in an anonymous mmap that is made executable only after
+// it has been written. READ and WRITE call the helpers below with the
+// JitContext in rdi. A helper never lets a C++ exception through the
+// generated code, which has no unwind information: it records the message
+// in the context and the code checks it after the call. Division by zero
+// records its message and leaves the same way.
+//
+// A backward jump counts down the Budget (runtime.h) inline and only calls
+// a helper when the countdown runs out.
+//
+// On anything but x86-64 Linux, or when the mapping is refused, JIT::run
+// falls back to the VM.
+//*****************************************************************************
+#ifndef JIT_H
+#define JIT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <initializer_list>
+#include <vector>
+#include "bytecode.h"
+#include "runtime.h"
+#include "vm.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+#define TIPS_JIT 1
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+struct JitContext {
+    Runtime* rt;
+    const Chunk* chunk;
+    const char* error;   // set by a helper or a trap, ends the run
+    Budget* budget;      // counted down by backward jumps
+};
+
+//*****************************************************************************
+// Runtime helpers called from the generated code
+int64_t jitReadInteger(JitContext* cx) {
+    try {
+        return cx->rt->readInteger();
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+        return 0;
+    }
+}
+
+double jitReadReal(JitContext* cx) {
+    try {
+        return cx->rt->readReal();
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+        return 0;
+    }
+}
+
+void jitWriteInteger(JitContext* cx, int64_t i) {
+    try {
+        cx->rt->writeInteger(i);
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+    }
+}
+
+void jitWriteReal(JitContext* cx, double r) {
+    try {
+        cx->rt->writeReal(r);
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+    }
+}
+
+void jitWriteString(JitContext* cx, uint32_t s) {
+    try {
+        cx->rt->writeString(cx->chunk->strings[s]);
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+    }
+}
+
+void jitPoll(JitContext* cx) {
+    try {
+        cx->rt->poll();
+    } catch (char const* errmsg) {
+        cx->error = errmsg;
+    }
+}
+
+//*****************************************************************************
+// Just enough of an x86-64 assembler. Memory operands are always
+// [base + disp32] with base rbx (the register frame), rbp (the context) or
+// rax (the budget), none of which needs a SIB byte.
+class X64Assembler {
+public:
+    enum Reg { RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7 };
+    enum { XMM0 = 0 };
+    static const uint8_t REX_W = 0x48;
+
+    vector<uint8_t> code;
+
+    void byte(uint8_t b) { code.push_back(b); }
+    void bytes(initializer_list<uint8_t> bs) { code.insert(code.end(), bs); }
+    void dword(uint32_t d) { for (int i = 0; i < 4; ++i) byte(d >> 8 * i); }
+    void qword(uint64_t q) { for (int i = 0; i < 8; ++i) byte(q >> 8 * i); }
+    size_t here() const { return code.size(); }
+
+    // prefix rex opcode modrm(reg, [base + disp32])
+    void mem(uint8_t prefix, uint8_t rex, initializer_list<uint8_t> opcode, int reg, int base, int32_t disp) {
+        if (prefix) byte(prefix);
+        if (rex) byte(rex);
+        bytes(opcode);
+        byte(0x80 | (reg & 7) << 3 | (base & 7));
+        dword(disp);
+    }
+
+    // Accesses to bytecode register r of the frame
+    static int32_t slot(uint32_t r) { return r * sizeof(Slot); }
+    void load(int reg, uint32_t r)      { mem(0, REX_W, {0x8B}, reg, RBX, slot(r)); }
+    void store(uint32_t r, int reg)     { mem(0, REX_W, {0x89}, reg, RBX, slot(r)); }
+    void loadF(uint32_t r)              { mem(0xF2, 0, {0x0F, 0x10}, XMM0, RBX, slot(r)); }
+    void storeF(uint32_t r)             { mem(0xF2, 0, {0x0F, 0x11}, XMM0, RBX, slot(r)); }
+    void aluRax(uint8_t op, uint32_t r) { mem(0, REX_W, {op}, RAX, RBX, slot(r)); }
+
+    // setcc al; movzx eax, al; store
+    void setStore(uint8_t cc, uint32_t r) {
+        bytes({0x0F, (uint8_t)(0x90 | cc), 0xC0, 0x0F, 0xB6, 0xC0});
+        store(r, RAX);
+    }
+
+    void callHelper(const void* fn) {
+        bytes({REX_W, 0x89, 0xEF});  // mov rdi, rbp
+        byte(REX_W);                  // mov rax, imm64
+        byte(0xB8);
+        qword((uint64_t)(uintptr_t)fn);
+        bytes({0xFF, 0xD0});          // call rax
+    }
+
+    // jmp / jcc rel32 to be patched; returns where the rel32 is
+    size_t jump() { byte(0xE9); dword(0); return here() - 4; }
+    size_t jumpIf(uint8_t cc) { bytes({0x0F, (uint8_t)(0x80 | cc)}); dword(0); return here() - 4; }
+    void patch(size_t at, size_t target) {
+        int32_t rel = (int32_t)(target - (at + 4));
+        memcpy(&code[at], &rel, 4);
+    }
+};
+
+// x86 condition codes
+enum { CC_B = 2, CC_E = 4, CC_NE = 5, CC_A = 7, CC_P = 0xA, CC_NP = 0xB, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF };
+
+//*****************************************************************************
+// Compiled code for one chunk
+class JitCode {
+public:
+    typedef void (*Entry)(Slot* regs, JitContext* cx);
+
+    Entry entry = nullptr;
+    void* memory = nullptr;
+    size_t size = 0;
+
+    JitCode() {}
+    JitCode(const JitCode&) = delete;
+    JitCode& operator=(const JitCode&) = delete;
+    ~JitCode();
+
+    bool compile(const Chunk& chunk);  // false: run the VM instead
+};
+
+JitCode::~JitCode() {
+#ifdef TIPS_JIT
+    if (memory) munmap(memory, size);
+#endif
+}
+
+bool JitCode::compile(const Chunk& chunk) {
+#ifndef TIPS_JIT
+    (void)chunk;
+    return false;
+#else
+    typedef X64Assembler A;
+    A as;
+    vector<size_t> native(chunk.code.size() + 1);
+    vector<pair<size_t, uint32_t>> jumps;  // rel32 position, bytecode target
+    vector<size_t> toDivZero, toError, toExit;
+    static const char* const divisionByZero = "division by zero";
+    const int32_t errorField = offsetof(JitContext, error);
+
+    // leaves when the helper just called recorded an error
+    auto checkError = [&]() {
+        as.mem(0, A::REX_W, {0x83}, 7, A::RBP, errorField);  // cmp qword [cx.error], 0
+        as.byte(0);
+        toError.push_back(as.jumpIf(CC_NE));
+    };
+
+    // a step of the budget, see Runtime::backEdge
+    auto backEdge = [&]() {
+        as.mem(0, A::REX_W, {0x8B}, A::RAX, A::RBP, offsetof(JitContext, budget));  // mov rax, [cx.budget]
+        as.mem(0, A::REX_W, {0x83}, 5, A::RAX, offsetof(Budget, countdown));      // sub qword [countdown], 1
+        as.byte(1);
+        size_t counted = as.jumpIf(CC_GE);
+        as.callHelper((const void*)jitPoll);
+        checkError();
+        as.patch(counted, as.here());
+    };
+
+    // push rbp; push rbx; sub rsp, 8 (keeps rsp 16-byte aligned for calls);
+    // rbx = register frame, rbp = context
+    as.bytes({0x55, 0x53, A::REX_W, 0x83, 0xEC, 0x08});
+    as.bytes({A::REX_W, 0x89, 0xFB, A::REX_W, 0x89, 0xF5});
+
+    for (size_t pc = 0; pc < chunk.code.size(); ++pc) {
+        native[pc] = as.here();
+        const Instr& in = chunk.code[pc];
+        uint32_t a = in.a, b = in.b, c = in.c;
+        switch (in.op) {
+        case OP_MOVE:
+            as.load(A::RAX, b);
+            as.store(a, A::RAX);
+            break;
+        case OP_ADDI: as.load(A::RAX, b); as.aluRax(0x03, c); as.store(a, A::RAX); break;
+        case OP_SUBI: as.load(A::RAX, b); as.aluRax(0x2B, c); as.store(a, A::RAX); break;
+        case OP_MULI:
+            as.load(A::RAX, b);
+            as.mem(0, A::REX_W, {0x0F, 0xAF}, A::RAX, A::RBX, A::slot(c));  // imul rax, [c]
+            as.store(a, A::RAX);
+            break;
+        case OP_DIVI:
+        case OP_MODI:
+            as.load(A::RCX, c);
+            as.bytes({A::REX_W, 0x85, 0xC9});                // test rcx, rcx
+            toDivZero.push_back(as.jumpIf(CC_E));
+            as.load(A::RAX, b);
+            {
+                // x / -1 is -x and x MOD -1 is 0 (see divI): idiv would
+                // trap on INT64_MIN / -1
+                as.bytes({A::REX_W, 0x83, 0xF9, 0xFF});          // cmp rcx, -1
+                size_t divide = as.jumpIf(CC_NE);
+                if (in.op == OP_DIVI)
+                    as.bytes({A::REX_W, 0xF7, 0xD8});            // neg rax
+                else
+                    as.bytes({0x31, 0xD2});                      // xor edx, edx
+                size_t done = as.jump();
+                as.patch(divide, as.here());
+                as.bytes({A::REX_W, 0x99, A::REX_W, 0xF7, 0xF9});  // cqo; idiv rcx
+                as.patch(done, as.here());
+            }
+            as.store(a, in.op == OP_DIVI ? A::RAX : A::RDX);
+            break;
+        case OP_SHLI:
+            as.load(A::RAX, b);
+            as.bytes({A::REX_W, 0xC1, 0xE0, (uint8_t)c});    // shl rax, c
+            as.store(a, A::RAX);
+            break;
+        case OP_DIVPI:
+        case OP_MODPI:
+            // bias = negative ? 2^c - 1 : 0, see divPow2
+            as.load(A::RAX, b);
+            as.bytes({A::REX_W, 0x89, 0xC2});                // mov rdx, rax
+            as.bytes({A::REX_W, 0xC1, 0xFA, 63});            // sar rdx, 63
+            as.bytes({A::REX_W, 0xC1, 0xEA, (uint8_t)(64 - c)});  // shr rdx, 64 - c
+            as.bytes({A::REX_W, 0x01, 0xD0});                // add rax, rdx
+            as.bytes({A::REX_W, 0xC1, 0xF8, (uint8_t)c});    // sar rax, c
+            if (in.op == OP_MODPI) {
+                as.bytes({A::REX_W, 0xC1, 0xE0, (uint8_t)c});  // shl rax, c
+                as.load(A::RCX, b);
+                as.bytes({A::REX_W, 0x29, 0xC1});              // sub rcx, rax
+                as.store(a, A::RCX);
+            }
+            else
+                as.store(a, A::RAX);
+            break;
+        case OP_ADDF: case OP_SUBF: case OP_MULF: case OP_DIVF: {
+            uint8_t op = in.op == OP_ADDF ? 0x58 : in.op == OP_SUBF ? 0x5C : in.op == OP_MULF ? 0x59 : 0x5E;
+            as.loadF(b);
+            as.mem(0xF2, 0, {0x0F, op}, A::XMM0, A::RBX, A::slot(c));
+            as.storeF(a);
+            break;
+        }
+        case OP_EQI: case OP_NEI: case OP_LTI: case OP_GTI: {
+            uint8_t cc = in.op == OP_EQI ? CC_E : in.op == OP_NEI ? CC_NE : in.op == OP_LTI ? CC_L : CC_G;
+            as.load(A::RAX, b);
+            as.aluRax(0x3B, c);  // cmp rax, [c]
+            as.setStore(cc, a);
+            break;
+        }
+        case OP_EQF:
+        case OP_NEF:
+            // unordered (NaN) sets PF: = is false and <> true
+            as.loadF(b);
+            as.mem(0x66, 0, {0x0F, 0x2E}, A::XMM0, A::RBX, A::slot(c));  // ucomisd
+            if (in.op == OP_EQF)
+                as.bytes({0x0F, 0x94, 0xC0, 0x0F, 0x9B, 0xC1, 0x20, 0xC8});  // sete al; setnp cl; and al, cl
+            else
+                as.bytes({0x0F, 0x95, 0xC0, 0x0F, 0x9A, 0xC1, 0x08, 0xC8});  // setne al; setp cl; or al, cl
+            as.bytes({0x0F, 0xB6, 0xC0});
+            as.store(a, A::RAX);
+            break;
+        case OP_LTF:
+        case OP_GTF:
+            // x < y is y above x, which is false when unordered
+            as.loadF(in.op == OP_LTF ? c : b);
+            as.mem(0x66, 0, {0x0F, 0x2E}, A::XMM0, A::RBX, A::slot(in.op == OP_LTF ? b : c));
+            as.setStore(CC_A, a);
+            break;
+        case OP_AND:
+        case OP_OR:
+            as.load(A::RAX, b);
+            as.load(A::RCX, c);
+            as.bytes({A::REX_W, 0x85, 0xC0, 0x0F, 0x95, 0xC0});  // test rax, rax; setne al
+            as.bytes({A::REX_W, 0x85, 0xC9, 0x0F, 0x95, 0xC1});  // test rcx, rcx; setne cl
+            as.bytes({(uint8_t)(in.op == OP_AND ? 0x20 : 0x08), 0xC8, 0x0F, 0xB6, 0xC0});
+            as.store(a, A::RAX);
+            break;
+        case OP_NEGI:
+            as.load(A::RAX, b);
+            as.bytes({A::REX_W, 0xF7, 0xD8});  // neg rax
+            as.store(a, A::RAX);
+            break;
+        case OP_NEGF:
+            as.load(A::RAX, b);
+            as.bytes({A::REX_W, 0x0F, 0xBA, 0xF8, 63});  // btc rax, 63
+            as.store(a, A::RAX);
+            break;
+        case OP_NOT:
+            as.load(A::RAX, b);
+            as.bytes({A::REX_W, 0x85, 0xC0});
+            as.setStore(CC_E, a);
+            break;
+        case OP_I2F:
+            as.mem(0xF2, A::REX_W, {0x0F, 0x2A}, A::XMM0, A::RBX, A::slot(b));  // cvtsi2sd
+            as.storeF(a);
+            break;
+        case OP_JMP:
+            if (b <= pc) backEdge();
+            jumps.push_back({as.jump(), b});
+            break;
+        case OP_JMPF:
+        case OP_JMPT:
+            as.mem(0, A::REX_W, {0x83}, 7, A::RBX, A::slot(a));  // cmp qword [a], 0
+            as.byte(0);
+            if (b > pc)
+                jumps.push_back({as.jumpIf(in.op == OP_JMPF ? CC_E : CC_NE), b});
+            else {
+                // a loop: skip the step when the jump is not taken
+                size_t skip = as.jumpIf(in.op == OP_JMPF ? CC_NE : CC_E);
+                backEdge();
+                jumps.push_back({as.jump(), b});
+                as.patch(skip, as.here());
+            }
+            break;
+        case OP_FORUP:
+        case OP_FORDN: {
+            // step the variable, then compare its old value with the limit
+            bool up = in.op == OP_FORUP;
+            as.load(A::RAX, a);
+            as.mem(0, A::REX_W, {0x83}, up ? 0 : 5, A::RBX, A::slot(a));  // add / sub qword [a], 1
+            as.byte(1);
+            as.aluRax(0x3B, c);                                          // cmp rax, [c]
+            if (b > pc)
+                jumps.push_back({as.jumpIf(up ? CC_L : CC_G), b});
+            else {
+                size_t skip = as.jumpIf(up ? CC_GE : CC_LE);
+                backEdge();
+                jumps.push_back({as.jump(), b});
+                as.patch(skip, as.here());
+            }
+            break;
+        }
+        case OP_READI:
+        case OP_READF:
+            as.callHelper(in.op == OP_READI ? (const void*)jitReadInteger : (const void*)jitReadReal);
+            checkError();
+            if (in.op == OP_READI) as.store(a, A::RAX);
+            else as.storeF(a);
+            break;
+        case OP_WRITEI:
+            as.mem(0, A::REX_W, {0x8B}, A::RSI, A::RBX, A::slot(a));  // mov rsi, [a]
+            as.callHelper((const void*)jitWriteInteger);
+            checkError();
+            break;
+        case OP_WRITEF:
+            as.loadF(a);
+            as.callHelper((const void*)jitWriteReal);
+            checkError();
+            break;
+        case OP_WRITES:
+            as.byte(0xBE);  // mov esi, imm32
+            as.dword(b);
+            as.callHelper((const void*)jitWriteString);
+            checkError();
+            break;
+        case OP_HALT:
+            toExit.push_back(as.jump());
+            break;
+        default:
+            return false;
+        }
+    }
+    native[chunk.code.size()] = as.here();
+
+    // division by zero: record the message, then leave like HALT
+    size_t divZero = as.here();
+    as.byte(A::REX_W);
+    as.byte(0xB8);
+    as.qword((uint64_t)(uintptr_t)divisionByZero);
+    as.mem(0, A::REX_W, {0x89}, A::RAX, A::RBP, errorField);
+    size_t exit = as.here();
+    as.bytes({A::REX_W, 0x83, 0xC4, 0x08, 0x5B, 0x5D, 0xC3});  // add rsp, 8; pop rbx; pop rbp; ret
+
+    for (auto& j : jumps) as.patch(j.first, native[j.second]);
+    for (size_t at : toDivZero) as.patch(at, divZero);
+    for (size_t at : toError) as.patch(at, exit);
+    for (size_t at : toExit) as.patch(at, exit);
+
+    size = as.code.size();
+    memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        memory = nullptr;
+        return false;
+    }
+    memcpy(memory, as.code.data(), size);
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+        return false;
+    entry = (Entry)memory;
+    return true;
+#endif
+}
+
+//*****************************************************************************
+// Runs a chunk as native code when it can be compiled, on the VM otherwise
+class JIT {
+public:
+    Runtime& rt;
+    vector<Slot> regs;
+    bool native = false;  // whether the last run was compiled
+
+    JIT(Runtime& runtime) : rt(runtime) {}
+
+    void run(const Chunk& chunk);
+};
+
+void JIT::run(const Chunk& chunk) {
+    JitCode code;
+    native = code.compile(chunk);
+    if (!native) {
+        VM(rt).run(chunk);
+        return;
+    }
+    initRegisters(chunk, regs);
+    JitContext cx = {&rt, &chunk, nullptr, &rt.budget};
+    code.entry(regs.data(), &cx);
+    if (cx.error)
+        throw cx.error;
+}
+
+#endif /* JIT_H */
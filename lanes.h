@@ -0,0 +1,420 @@
+//*****************************************************************************
+// Data-parallel execution of one program over many input records
+// (tips_parse --records=FILE)
+//
+// Every line of the input file is a record: its comma separated fields are
+// what the program READs, and what it WRITEs becomes one line of the
+// output, the values separated by commas. Each record runs as if the
+// program had been started on it alone, including a runtime error, which
+// ends that record's line with the usual message.
+//
+// Records are run LANES at a time. Each variable holds one value per lane
+// in a GCC vector, so an operator is applied to all the lanes with one
+// vector operation. Control flow works on masks: IF runs its THEN part
+// under the lanes whose condition holds and its ELSE part under the others,
+// and WHILE and FOR keep iterating as long as any lane is still in the
+// loop. A lane that reaches BREAK or CONTINUE sits out the rest of the
+// loop body; one that reached BREAK also leaves the loop. A statement only
+// changes the lanes of its mask, and a lane that fails leaves every mask.
+// READ and WRITE go through one Runtime per lane.
+//*****************************************************************************
+#ifndef LANES_H
+#define LANES_H
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "parse_tree_nodes.h"
+#include "runtime.h"
+#include "typecheck.h"
+
+using namespace std;
+
+const int LANES = 8;
+
+// GCC warns that vectors wider than the target's registers are passed
+// differently when AVX is enabled. These functions are not an interface,
+// and the warning comes at the end of the file for the templates, so it
+// stays off from here on.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+typedef int64_t IntLanes __attribute__((vector_size(8 * LANES)));
+typedef uint64_t UIntLanes __attribute__((vector_size(8 * LANES)));
+typedef double RealLanes __attribute__((vector_size(8 * LANES)));
+
+// A mask lane is -1 (all ones) when set, like vector comparisons produce
+union LaneSlot {
+    IntLanes i;
+    RealLanes f;
+};
+
+struct LaneValue {
+    TipsType type;
+    LaneSlot v;
+};
+
+inline bool anyLane(IntLanes m) {
+    for (int l = 0; l < LANES; ++l)
+        if (m[l]) return true;
+    return false;
+}
+
+class LaneEvaluator {
+public:
+    vector<LaneSlot> vars;
+    const vector<TipsType>* types = nullptr;
+    Runtime* lanes[LANES];  // null where the group has no record
+    IntLanes alive;         // lanes with a record that has not failed
+    IntLanes skipped = {};  // lanes past a BREAK or CONTINUE in the innermost loop body
+    IntLanes broken = {};   // lanes past a BREAK, leaving the innermost loop
+
+    void run(ProgramNode& pn, Runtime* const runtimes[LANES]);
+    void fail(int lane, const char* errmsg);
+
+    void exec(StatementNode& sn, IntLanes m);
+    LaneValue eval(ExprNode& en, IntLanes m);
+    LaneValue eval(SimpleExprNode& sn, IntLanes m);
+    LaneValue eval(TermNode& tn, IntLanes m);
+    LaneValue eval(FactorNode& fn, IntLanes m);
+    template <class Node>
+    LaneValue chain(const vector<int>& ops, const vector<TipsType>& opTypes, LaneValue x,
+                    const vector<Node*>& rest, const IntLanes& m);
+    LaneValue binary(int op, TipsType opType, const LaneValue& x, const LaneValue& y, IntLanes m);
+    IntLanes truth(const LaneValue& x);
+};
+
+LaneValue toReal(const LaneValue& x) {
+    if (x.type == TYPE_REAL)
+        return x;
+    LaneValue r;
+    r.type = TYPE_REAL;
+    r.v.f = __builtin_convertvector(x.v.i, RealLanes);
+    return r;
+}
+
+// A mask of the lanes where x is not zero
+IntLanes LaneEvaluator::truth(const LaneValue& x) {
+    return x.type == TYPE_REAL ? (IntLanes)(x.v.f != 0) : (IntLanes)(x.v.i != 0);
+}
+
+void LaneEvaluator::run(ProgramNode& pn, Runtime* const runtimes[LANES]) {
+    types = &pn.block->variableTypes;
+    LaneSlot zero;
+    zero.i = IntLanes{};
+    vars.assign(types->size(), zero);
+    for (int l = 0; l < LANES; ++l) {
+        lanes[l] = runtimes[l];
+        alive[l] = runtimes[l] ? -1 : 0;
+    }
+    exec(*pn.block->firstCompound, alive);
+}
+
+void LaneEvaluator::fail(int lane, const char* errmsg) {
+    if (!alive[lane]) return;
+    lanes[lane]->writeError(errmsg);
+    alive[lane] = 0;
+}
+
+void LaneEvaluator::exec(StatementNode& sn, IntLanes m) {
+    m &= alive & ~skipped;
+    if (!anyLane(m)) return;
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        LaneValue x = eval(*an.expression, m);
+        if ((*types)[an.slot] == TYPE_REAL) x = toReal(x);
+        m &= alive;
+        LaneSlot& var = vars[an.slot];
+        var.i = (x.v.i & m) | (var.i & ~m);
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        exec(*cn.firstStatement, m);
+        for (StatementNode* s : cn.restStatements)
+            exec(*s, m);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        IntLanes c = truth(eval(*in.expression, m));
+        for (StatementNode* s : in.firstStatement)
+            exec(*s, m & c);
+        for (StatementNode* s : in.restStatements)
+            exec(*s, m & ~c);
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        IntLanes outerSkipped = skipped, outerBroken = broken;
+        skipped = broken = IntLanes{};
+        for (bool again = false;; again = true) {
+            m &= truth(eval(*wn.expression, m)) & alive;
+            if (!anyLane(m)) break;
+            for (int l = 0; again && l < LANES; ++l) {
+                if (!m[l]) continue;
+                try {
+                    lanes[l]->backEdge();
+                }
+                catch (char const* errmsg) {
+                    fail(l, errmsg);
+                    m[l] = 0;
+                }
+            }
+            exec(*wn.firstStatement, m);
+            m &= alive & ~broken;
+            skipped = broken = IntLanes{};
+        }
+        skipped = outerSkipped;
+        broken = outerBroken;
+        break;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        IntLanes start = eval(*fn.start, m).v.i;
+        IntLanes limit = eval(*fn.limit, m).v.i;
+        m &= alive;
+        LaneSlot& var = vars[fn.slot];
+        var.i = (start & m) | (var.i & ~m);
+        m &= fn.down ? start >= limit : start <= limit;
+        IntLanes outerSkipped = skipped, outerBroken = broken;
+        skipped = broken = IntLanes{};
+        for (bool again = false; anyLane(m); again = true) {
+            for (int l = 0; again && l < LANES; ++l) {
+                if (!m[l]) continue;
+                try {
+                    lanes[l]->backEdge();
+                }
+                catch (char const* errmsg) {
+                    fail(l, errmsg);
+                    m[l] = 0;
+                }
+            }
+            exec(*fn.firstStatement, m);
+            m &= alive & ~broken;
+            skipped = broken = IntLanes{};
+            IntLanes i = var.i;
+            IntLanes next = (IntLanes)((UIntLanes)i + (uint64_t)(fn.down ? -1 : 1));
+            var.i = (next & m) | (i & ~m);
+            m &= fn.down ? i > limit : i < limit;
+        }
+        skipped = outerSkipped;
+        broken = outerBroken;
+        break;
+    }
+    case BREAK_NODE:
+        broken |= m;
+        skipped |= m;
+        break;
+    case CONTINUE_NODE:
+        skipped |= m;
+        break;
+    case READ_NODE: {
+        int slot = ((ReadNode&)sn).slot;
+        for (int l = 0; l < LANES; ++l) {
+            if (!m[l]) continue;
+            try {
+                if ((*types)[slot] == TYPE_REAL) vars[slot].f[l] = lanes[l]->readReal();
+                else vars[slot].i[l] = lanes[l]->readInteger();
+            }
+            catch (char const* errmsg) {
+                fail(l, errmsg);
+            }
+        }
+        break;
+    }
+    case WRITE_NODE: {
+        WriteNode& wn = (WriteNode&)sn;
+        for (int l = 0; l < LANES; ++l) {
+            if (!m[l]) continue;
+            try {
+                if (wn.isString()) lanes[l]->writeString(wn.text());
+                else if ((*types)[wn.slot] == TYPE_REAL) lanes[l]->writeReal(vars[wn.slot].f[l]);
+                else lanes[l]->writeInteger(vars[wn.slot].i[l]);
+            }
+            catch (char const* errmsg) {
+                fail(l, errmsg);
+            }
+        }
+        break;
+    }
+    default:
+        throw "statement cannot be executed";
+    }
+}
+
+// Operators are applied to every lane; only division can fail, and only
+// the lanes of m do. The other lanes divide by 1 so that whatever they
+// hold cannot trap.
+LaneValue LaneEvaluator::binary(int op, TipsType opType, const LaneValue& x, const LaneValue& y, IntLanes m) {
+    LaneValue r;
+    r.type = resultType(op, opType);
+    if (opType == TYPE_REAL) {
+        RealLanes a = toReal(x).v.f, b = toReal(y).v.f;
+        switch (op) {
+        case TOK_PLUS:        r.v.f = a + b; return r;
+        case TOK_MINUS:       r.v.f = a - b; return r;
+        case TOK_MULTIPLY:    r.v.f = a * b; return r;
+        case TOK_DIVIDE:      r.v.f = a / b; return r;
+        case TOK_EQUALTO:     r.v.i = -(IntLanes)(a == b); return r;
+        case TOK_NOTEQUALTO:  r.v.i = -(IntLanes)(a != b); return r;
+        case TOK_LESSTHAN:    r.v.i = -(IntLanes)(a < b); return r;
+        case TOK_GREATERTHAN: r.v.i = -(IntLanes)(a > b); return r;
+        default:              break;
+        }
+    }
+    IntLanes a = x.v.i, b = y.v.i;
+    switch (op) {
+    case TOK_PLUS:        r.v.i = (IntLanes)((UIntLanes)a + (UIntLanes)b); break;
+    case TOK_MINUS:       r.v.i = (IntLanes)((UIntLanes)a - (UIntLanes)b); break;
+    case TOK_MULTIPLY:    r.v.i = (IntLanes)((UIntLanes)a * (UIntLanes)b); break;
+    case TOK_DIVIDE:
+    case TOK_MOD: {
+        IntLanes active = m & alive;
+        IntLanes zero = active & (b == 0);
+        for (int l = 0; l < LANES; ++l)
+            if (zero[l]) fail(l, "division by zero");
+        // x / -1 is computed as a negation, which cannot overflow
+        IntLanes minusOne = b == -1;
+        IntLanes safe = (b & active & ~zero & ~minusOne) | (1 & ~(active & ~zero & ~minusOne));
+        if (op == TOK_DIVIDE)
+            r.v.i = (a / safe & ~minusOne) | ((IntLanes)(-(UIntLanes)a) & minusOne);
+        else
+            r.v.i = a % safe & ~minusOne;
+        break;
+    }
+    case TOK_EQUALTO:     r.v.i = -(IntLanes)(a == b); break;
+    case TOK_NOTEQUALTO:  r.v.i = -(IntLanes)(a != b); break;
+    case TOK_LESSTHAN:    r.v.i = -(IntLanes)(a < b); break;
+    case TOK_GREATERTHAN: r.v.i = -(IntLanes)(a > b); break;
+    case TOK_AND:         r.v.i = -(truth(x) & truth(y)); break;
+    case TOK_OR:          r.v.i = -(truth(x) | truth(y)); break;
+    default:              throw "unknown operator";
+    }
+    return r;
+}
+
+template <class Node>
+LaneValue LaneEvaluator::chain(const vector<int>& ops, const vector<TipsType>& opTypes, LaneValue x,
+                               const vector<Node*>& rest, const IntLanes& m) {
+    for (size_t i = 0; i < ops.size(); ++i)
+        x = binary(ops[i], opTypes[i], x, eval(*rest[i], m), m);
+    return x;
+}
+
+LaneValue LaneEvaluator::eval(ExprNode& en, IntLanes m) {
+    return chain(en.restExpOps, en.opTypes, eval(*en.simpleExpr, m), en.restExpr, m);
+}
+
+LaneValue LaneEvaluator::eval(SimpleExprNode& sn, IntLanes m) {
+    return chain(sn.restTermOps, sn.opTypes, eval(*sn.firstTerm, m), sn.restTerms, m);
+}
+
+LaneValue LaneEvaluator::eval(TermNode& tn, IntLanes m) {
+    return chain(tn.restFactorOps, tn.opTypes, eval(*tn.firstFactor, m), tn.restFactors, m);
+}
+
+LaneValue LaneEvaluator::eval(FactorNode& fn, IntLanes m) {
+    LaneValue x;
+    switch (fn.kind) {
+    case ID_NODE: {
+        int slot = ((IdNode&)fn).slot;
+        x.type = (*types)[slot];
+        x.v = vars[slot];
+        break;
+    }
+    case INTLIT_NODE:
+        x.type = TYPE_INTEGER;
+        x.v.i = IntLanes{} + (int64_t)((IntLitNode&)fn).int_literal;
+        break;
+    case FLOATLIT_NODE:
+        x.type = TYPE_REAL;
+        x.v.f = RealLanes{} + ((FloatLitNode&)fn).double_literal;
+        break;
+    case NESTED_EXPR_NODE:
+        x = eval(*((NestedExprNode&)fn).exprPtr, m);
+        break;
+    default:
+        throw "factor cannot be evaluated";
+    }
+
+    // innermost operator first
+    for (size_t i = fn.unaryOps.size(); i-- > 0; ) {
+        if (fn.unaryOps[i] == TOK_NOT) {
+            x.v.i = truth(x) + 1;  // -1 becomes 0, 0 becomes 1
+            x.type = TYPE_BOOLEAN;
+        }
+        else if (x.type == TYPE_REAL)
+            x.v.f = -x.v.f;
+        else {
+            x.v.i = (IntLanes)(-(UIntLanes)x.v.i);
+            x.type = TYPE_INTEGER;
+        }
+    }
+    return x;
+}
+
+//*****************************************************************************
+// The record file and the output file
+
+// The lines a record wrote, as one CSV line
+void writeRecord(ostream& out, const string& written) {
+    istringstream lines(written);
+    string value;
+    bool first = true;
+    while (getline(lines, value)) {
+        if (!first) out << ',';
+        first = false;
+        if (value.find_first_of(",\"") == string::npos)
+            out << value;
+        else {
+            out << '"';
+            for (char c : value) {
+                if (c == '"') out << '"';
+                out << c;
+            }
+            out << '"';
+        }
+    }
+    out << '\n';
+}
+
+// Runs the program on every record (line) of the text from begin to end,
+// writing a line per record to out. Every record gets the whole budget.
+// Returns the number of records.
+size_t runRecords(ProgramNode& pn, const char* begin, const char* end, ostream& out,
+                  const Budget& budget = Budget()) {
+    vector<string> records;
+    for (const char* p = begin; p < end; ) {
+        const char* nl = (const char*)memchr(p, '\n', end - p);
+        const char* stop = nl ? nl : end;
+        records.emplace_back(p, stop > p && stop[-1] == '\r' ? stop - 1 : stop);
+        p = nl ? nl + 1 : end;
+    }
+
+    LaneEvaluator evaluator;
+    for (size_t base = 0; base < records.size(); base += LANES) {
+        // a record's fields are its READ tokens, whatever else separates them
+        string inputs[LANES];
+        vector<Runtime> runtimes;
+        runtimes.reserve(LANES);
+        Runtime* group[LANES] = {};
+        for (int l = 0; l < LANES && base + l < records.size(); ++l) {
+            inputs[l] = records[base + l];
+            replace(inputs[l].begin(), inputs[l].end(), ',', ' ');
+            runtimes.emplace_back(inputs[l]);
+            runtimes.back().budget = budget;
+            group[l] = &runtimes.back();
+        }
+        evaluator.run(pn, group);
+        for (Runtime& rt : runtimes)
+            writeRecord(out, rt.written());
+    }
+    return records.size();
+}
+
+#endif /* LANES_H */
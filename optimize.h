@@ -0,0 +1,332 @@
+//*****************************************************************************
+// Expression simplification
+//
+// Runs after the type checker, before a program is executed, and rewrites
+// expression trees in place:
+//
+//   - operators whose operands are all literals are evaluated, as are unary
+//     operators on literals and parenthesized constants, e.g. (1 + 2) * X
+//     becomes 3 * X
+//   - identities are dropped: X + 0, X - 0, 0 + X on INTEGER; X * 1, 1 * X
+//     and X / 1 on either type; - - X; NOT NOT X when X is BOOLEAN
+//   - a parenthesized expression that is a single factor is unwrapped
+//
+// Only rewrites that give bit-identical results are made: REAL chains are
+// never reassociated and X + 0.0 is kept (it turns -0 into 0). INTEGER
+// division or MOD by a zero literal is left for the runtime to report, and
+// results that do not fit an IntLitNode are not folded.
+//
+// The rewritten nodes keep their type annotations. Their print text is not
+// updated, so an optimized tree is for execution only.
+//*****************************************************************************
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+
+#include <limits.h>
+#include <vector>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+#include "runtime.h"
+#include "typecheck.h"
+
+using namespace std;
+
+class ExprOptimizer {
+public:
+    int folded = 0;      // operators evaluated at compile time
+    int simplified = 0;  // identities and redundant parentheses removed
+    const vector<TipsType>* vars = nullptr;  // declared type of each slot
+
+    void program(ProgramNode& pn) {
+        vars = &pn.block->variableTypes;
+        statement(*pn.block->firstCompound);
+    }
+
+    void statement(StatementNode& sn);
+    void expression(ExprNode& en);
+    void simpleExpression(SimpleExprNode& sn);
+    void term(TermNode& tn);
+    FactorNode* factor(FactorNode* fn);
+
+    // Generic work on an operator chain: first op[0] rest[0] op[1] rest[1] ...
+    template <class Node>
+    void chain(Node*& first, vector<int>& ops, vector<TipsType>& opTypes, vector<Node*>& rest);
+
+    static bool constantOf(FactorNode* fn, Value& v);
+    static bool constantOf(TermNode* tn, Value& v);
+    static bool constantOf(SimpleExprNode* sn, Value& v);
+    static FactorNode* literal(const Value& v, TipsType type);
+    static void wrap(const Value& v, TipsType type, TermNode*& node);
+    static void wrap(const Value& v, TipsType type, SimpleExprNode*& node);
+    static void wrap(const Value& v, TipsType type, FactorNode*& node);
+};
+
+//*****************************************************************************
+// Constants
+
+bool ExprOptimizer::constantOf(FactorNode* fn, Value& v) {
+    if (!fn->unaryOps.empty()) return false;
+    if (fn->kind == INTLIT_NODE) { v = Value::integer(((IntLitNode*)fn)->int_literal); return true; }
+    if (fn->kind == FLOATLIT_NODE) { v = Value::real(((FloatLitNode*)fn)->double_literal); return true; }
+    return false;
+}
+
+bool ExprOptimizer::constantOf(TermNode* tn, Value& v) {
+    return tn->restFactorOps.empty() && constantOf(tn->firstFactor, v);
+}
+
+bool ExprOptimizer::constantOf(SimpleExprNode* sn, Value& v) {
+    return sn->restTermOps.empty() && constantOf(sn->firstTerm, v);
+}
+
+// A literal factor holding v, or nullptr when v does not fit one
+FactorNode* ExprOptimizer::literal(const Value& v, TipsType type) {
+    FactorNode* fn;
+    if (v.isReal)
+        fn = new FloatLitNode(v.r);
+    else if (v.i >= INT_MIN && v.i <= INT_MAX)
+        fn = new IntLitNode((int)v.i);
+    else
+        return nullptr;
+    fn->type = type;
+    return fn;
+}
+
+// Replace node, which has just been found to be constant, with the
+// smallest node of its level holding v
+void ExprOptimizer::wrap(const Value& v, TipsType type, FactorNode*& node) {
+    FactorNode* lit = literal(v, type);
+    if (!lit) return;
+    delete node;
+    node = lit;
+}
+
+void ExprOptimizer::wrap(const Value& v, TipsType type, TermNode*& node) {
+    FactorNode* lit = literal(v, type);
+    if (!lit) return;
+    TermNode* tn = new TermNode;
+    tn->firstFactor = lit;
+    tn->type = type;
+    delete node;
+    node = tn;
+}
+
+void ExprOptimizer::wrap(const Value& v, TipsType type, SimpleExprNode*& node) {
+    TermNode* tn = nullptr;
+    wrap(v, type, tn);
+    if (!tn) return;
+    SimpleExprNode* sn = new SimpleExprNode;
+    sn->firstTerm = tn;
+    sn->type = type;
+    delete node;
+    node = sn;
+}
+
+TipsType typeOf(FactorNode* fn) { return fn->type; }
+TipsType typeOf(TermNode* tn) { return tn->type; }
+TipsType typeOf(SimpleExprNode* sn) { return sn->type; }
+
+// Is c the right identity of op at opType (X op c = X)?
+bool rightIdentity(int op, TipsType opType, const Value& c) {
+    double x = c.asReal();
+    switch (op) {
+    case TOK_PLUS:
+    case TOK_MINUS:    return opType == TYPE_INTEGER && x == 0;
+    case TOK_MULTIPLY:
+    case TOK_DIVIDE:   return opType != TYPE_BOOLEAN && x == 1;
+    default:           return false;
+    }
+}
+
+// Is c the left identity of op at opType (c op X = X)?
+bool leftIdentity(int op, TipsType opType, const Value& c) {
+    double x = c.asReal();
+    if (op == TOK_PLUS) return opType == TYPE_INTEGER && x == 0;
+    if (op == TOK_MULTIPLY) return opType != TYPE_BOOLEAN && x == 1;
+    return false;
+}
+
+//*****************************************************************************
+// Chains
+
+template <class Node>
+void ExprOptimizer::chain(Node*& first, vector<int>& ops, vector<TipsType>& opTypes, vector<Node*>& rest) {
+    // fold the leading constants: 2 * 3 * X becomes 6 * X
+    Value a, b;
+    while (!ops.empty() && constantOf(first, a) && constantOf(rest[0], b)) {
+        Value v;
+        try {
+            v = applyBinary(ops[0], a, b);
+        } catch (char const*) {
+            break;  // e.g. division by zero, reported when the program runs
+        }
+        Node* before = first;
+        wrap(v, resultType(ops[0], opTypes[0]), first);
+        if (first == before) break;
+        delete rest[0];
+        ops.erase(ops.begin());
+        opTypes.erase(opTypes.begin());
+        rest.erase(rest.begin());
+        ++folded;
+    }
+
+    // c op X where c is the identity and X needs no conversion
+    if (!ops.empty() && constantOf(first, a) && leftIdentity(ops[0], opTypes[0], a)
+        && typeOf(rest[0]) == opTypes[0]) {
+        delete first;
+        first = rest[0];
+        ops.erase(ops.begin());
+        opTypes.erase(opTypes.begin());
+        rest.erase(rest.begin());
+        ++simplified;
+    }
+
+    // X op c where c is the identity; the type of the running value must
+    // already be the operator's type, or dropping the operator would also
+    // drop a conversion
+    TipsType running = typeOf(first);
+    for (size_t i = 0; i < ops.size(); ) {
+        if (running == opTypes[i] && constantOf(rest[i], b) && rightIdentity(ops[i], opTypes[i], b)) {
+            delete rest[i];
+            ops.erase(ops.begin() + i);
+            opTypes.erase(opTypes.begin() + i);
+            rest.erase(rest.begin() + i);
+            ++simplified;
+            continue;
+        }
+        running = resultType(ops[i], opTypes[i]);
+        ++i;
+    }
+}
+
+void ExprOptimizer::expression(ExprNode& en) {
+    simpleExpression(*en.simpleExpr);
+    for (SimpleExprNode* sn : en.restExpr)
+        simpleExpression(*sn);
+    chain(en.simpleExpr, en.restExpOps, en.opTypes, en.restExpr);
+}
+
+void ExprOptimizer::simpleExpression(SimpleExprNode& sn) {
+    term(*sn.firstTerm);
+    for (TermNode* tn : sn.restTerms)
+        term(*tn);
+    chain(sn.firstTerm, sn.restTermOps, sn.opTypes, sn.restTerms);
+}
+
+void ExprOptimizer::term(TermNode& tn) {
+    tn.firstFactor = factor(tn.firstFactor);
+    for (FactorNode*& fn : tn.restFactors)
+        fn = factor(fn);
+    chain(tn.firstFactor, tn.restFactorOps, tn.opTypes, tn.restFactors);
+}
+
+//*****************************************************************************
+// Factors. Returns the factor to use in place of fn, which it may delete.
+FactorNode* ExprOptimizer::factor(FactorNode* fn) {
+    vector<int> ops = fn->unaryOps;
+
+    // unwrap ( expression ) when it has become a single factor
+    if (fn->kind == NESTED_EXPR_NODE) {
+        ExprNode* en = ((NestedExprNode*)fn)->exprPtr;
+        expression(*en);
+        if (en->restExpOps.empty() && en->simpleExpr->restTermOps.empty()
+            && en->simpleExpr->firstTerm->restFactorOps.empty()) {
+            FactorNode* inner = en->simpleExpr->firstTerm->firstFactor;
+            en->simpleExpr->firstTerm->firstFactor = nullptr;
+            delete fn;
+            inner->unaryOps.insert(inner->unaryOps.begin(), ops.begin(), ops.end());
+            fn = inner;
+            ops = fn->unaryOps;
+            ++simplified;
+        }
+    }
+    if (ops.empty())
+        return fn;
+
+    // type of the operand, before any unary operator
+    TipsType type;
+    switch (fn->kind) {
+    case ID_NODE:       type = (*vars)[((IdNode*)fn)->slot]; break;
+    case INTLIT_NODE:   type = TYPE_INTEGER; break;
+    case FLOATLIT_NODE: type = TYPE_REAL; break;
+    default:            type = ((NestedExprNode*)fn)->exprPtr->type; break;
+    }
+
+    // drop - - X, and NOT NOT X when X is BOOLEAN; innermost pair first
+    vector<int> kept;            // innermost first
+    vector<TipsType> operandOf;  // type each kept operator is applied to
+    for (size_t i = ops.size(); i-- > 0; ) {
+        int op = ops[i];
+        if (!kept.empty() && kept.back() == op && (op == TOK_MINUS || operandOf.back() == TYPE_BOOLEAN)) {
+            type = operandOf.back();
+            kept.pop_back();
+            operandOf.pop_back();
+            ++simplified;
+            continue;
+        }
+        kept.push_back(op);
+        operandOf.push_back(type);
+        type = op == TOK_NOT ? TYPE_BOOLEAN : type == TYPE_BOOLEAN ? TYPE_INTEGER : type;
+    }
+    fn->unaryOps.assign(kept.rbegin(), kept.rend());
+    fn->type = type;
+
+    // evaluate unary operators on a literal
+    Value v;
+    if (fn->kind == INTLIT_NODE || fn->kind == FLOATLIT_NODE) {
+        v = fn->kind == INTLIT_NODE ? Value::integer(((IntLitNode*)fn)->int_literal)
+                                    : Value::real(((FloatLitNode*)fn)->double_literal);
+        for (size_t i = fn->unaryOps.size(); i-- > 0; )
+            v = applyUnary(fn->unaryOps[i], v);
+        FactorNode* lit = literal(v, fn->type);
+        if (lit) {
+            folded += fn->unaryOps.size();
+            delete fn;
+            return lit;
+        }
+    }
+    return fn;
+}
+
+//*****************************************************************************
+// Statements
+void ExprOptimizer::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE:
+        expression(*((AssignmentNode&)sn).expression);
+        break;
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        statement(*cn.firstStatement);
+        for (StatementNode* s : cn.restStatements)
+            statement(*s);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        expression(*in.expression);
+        for (StatementNode* s : in.firstStatement)
+            statement(*s);
+        for (StatementNode* s : in.restStatements)
+            statement(*s);
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        expression(*wn.expression);
+        statement(*wn.firstStatement);
+        break;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        expression(*fn.start);
+        expression(*fn.limit);
+        statement(*fn.firstStatement);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+#endif /* OPTIMIZE_H */
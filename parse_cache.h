@@ -0,0 +1,175 @@
+//*****************************************************************************
+// On-disk parse cache for batch mode
+//
+// Entries are keyed by a hash of the source bytes, the parser version and
+// the error limit. An entry holds the diagnostics of the parse and, when it
+// succeeded, the tree in the binary format of ast_binary.h, so a hit is
+// answered by mapping one file: no lexing, no parsing, no tree building.
+//
+// Entry layout: CacheHeader, diagnostics, padding to 8 bytes, tree image.
+// Each diagnostic is { int32 code; int32 line; uint32 nearLength;
+// uint32 messageLength; near text; message text }.
+//*****************************************************************************
+#ifndef PARSE_CACHE_H
+#define PARSE_CACHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "hash.h"
+#include "ast_binary.h"
+
+using namespace std;
+
+// Bump whenever the productions, the diagnostics they report or the tree
+// format change, so entries written by an older parser are never used
+const uint32_t PARSER_VERSION = 4;
+
+const char PARSE_CACHE_MAGIC[8] = {'T', 'I', 'P', 'S', 'P', 'C', 0, 0};
+
+struct CacheHeader {
+    char     magic[8];
+    uint32_t parserVersion;
+    uint32_t astVersion;
+    uint64_t key;
+    uint64_t sourceSize;
+    uint32_t diagCount;
+    uint32_t diagBytes;   // including the padding after the diagnostics
+    uint32_t astBytes;    // 0 when the parse failed
+    uint32_t unused;
+};
+
+//*****************************************************************************
+// class ParseCache
+class ParseCache {
+public:
+    string dir;
+    int hits = 0;
+    int misses = 0;
+
+    ParseCache(const string& directory) : dir(directory) {}
+
+    uint64_t key(const void* source, size_t size, int errorLimit) const;
+    string entryPath(uint64_t key) const;
+    bool lookup(uint64_t key, size_t sourceSize, MappedFile& entry,
+                vector<Diagnostic>& diags, AstView& ast);
+    bool store(uint64_t key, size_t sourceSize, const vector<Diagnostic>& diags,
+               const vector<char>& ast);
+};
+
+uint64_t ParseCache::key(const void* source, size_t size, int errorLimit) const {
+    uint64_t h = hashBytes(source, size);
+    h = hashCombine(h, PARSER_VERSION);
+    h = hashCombine(h, AST_VERSION);
+    return hashCombine(h, (uint64_t)errorLimit);
+}
+
+string ParseCache::entryPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof name, "/%016llx.tpc", (unsigned long long)key);
+    return dir + name;
+}
+
+// On a hit, fills diags, points ast at the mapped tree (if the parse had
+// succeeded) and keeps the mapping alive in entry
+bool ParseCache::lookup(uint64_t key, size_t sourceSize, MappedFile& entry,
+                        vector<Diagnostic>& diags, AstView& ast) {
+    if (!entry.open(entryPath(key).c_str()) || entry.size < sizeof(CacheHeader)) {
+        ++misses;
+        return false;
+    }
+
+    const char* base = (const char*)entry.data;
+    CacheHeader header;
+    memcpy(&header, base, sizeof header);
+    if (memcmp(header.magic, PARSE_CACHE_MAGIC, sizeof header.magic) != 0
+        || header.parserVersion != PARSER_VERSION || header.astVersion != AST_VERSION
+        || header.key != key || header.sourceSize != sourceSize
+        || sizeof header + (uint64_t)header.diagBytes + header.astBytes > entry.size) {
+        ++misses;
+        return false;
+    }
+
+    // Every read stays inside the diagnostics; an entry that says otherwise
+    // is damaged and counts as a miss
+    const char* p = base + sizeof header;
+    const char* end = p + header.diagBytes;
+    diags.clear();
+    for (uint32_t i = 0; i < header.diagCount; ++i) {
+        int32_t fields[4];
+        if ((size_t)(end - p) < sizeof fields) {
+            diags.clear();
+            ++misses;
+            return false;
+        }
+        memcpy(fields, p, sizeof fields);
+        p += sizeof fields;
+        if (fields[2] < 0 || fields[3] < 0 || (uint64_t)fields[2] + (uint64_t)fields[3] > (size_t)(end - p)) {
+            diags.clear();
+            ++misses;
+            return false;
+        }
+        Diagnostic d;
+        d.code = fields[0];
+        d.line = fields[1];
+        d.nearText.assign(p, fields[2]);
+        p += fields[2];
+        d.message.assign(p, fields[3]);
+        p += fields[3];
+        diags.push_back(d);
+    }
+
+    if (header.astBytes && !ast.open(base + sizeof header + header.diagBytes, header.astBytes)) {
+        ++misses;
+        return false;
+    }
+
+    ++hits;
+    return true;
+}
+
+// Write the entry under a temporary name and rename it into place, so
+// concurrent batch runs never see a half-written entry
+bool ParseCache::store(uint64_t key, size_t sourceSize, const vector<Diagnostic>& diags,
+                       const vector<char>& ast) {
+    vector<char> diagBytes;
+    for (const Diagnostic& d : diags) {
+        int32_t fields[4] = {d.code, d.line, (int32_t)d.nearText.size(), (int32_t)d.message.size()};
+        diagBytes.insert(diagBytes.end(), (char*)fields, (char*)fields + sizeof fields);
+        diagBytes.insert(diagBytes.end(), d.nearText.begin(), d.nearText.end());
+        diagBytes.insert(diagBytes.end(), d.message.begin(), d.message.end());
+    }
+    while (diagBytes.size() % 8) diagBytes.push_back('\0');
+
+    CacheHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, PARSE_CACHE_MAGIC, sizeof header.magic);
+    header.parserVersion = PARSER_VERSION;
+    header.astVersion = AST_VERSION;
+    header.key = key;
+    header.sourceSize = sourceSize;
+    header.diagCount = diags.size();
+    header.diagBytes = diagBytes.size();
+    header.astBytes = ast.size();
+
+    mkdir(dir.c_str(), 0777);
+    string path = entryPath(key);
+    string temp = path + "." + to_string(getpid());
+    FILE* out = fopen(temp.c_str(), "wb");
+    if (!out) return false;
+    bool ok = fwrite(&header, sizeof header, 1, out) == 1
+        && (diagBytes.empty() || fwrite(diagBytes.data(), 1, diagBytes.size(), out) == diagBytes.size())
+        && (ast.empty() || fwrite(ast.data(), 1, ast.size(), out) == ast.size());
+    ok = fclose(out) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+#endif /* PARSE_CACHE_H */
@@ -1,14 +1,18 @@
 #ifndef PARSE_TREE_NODES_H
 #define PARSE_TREE_NODES_H
 
+#include <stdint.h>
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include "lexer.h"
 #include <unordered_map>
 
 using namespace std;
 
+extern "C" int yylineno;  // line number for current lexeme
+
 // Forward declaration of <expr> node
 class ExprNode; 
 
@@ -32,10 +36,43 @@ unordered_map<int, string> gops = {
 	{TOK_AND, "AND"}
 };
 
+//*****************************************************************************
+// Concrete node kinds, so passes over the tree can switch on the node type
+// instead of making a virtual call per node. The values are stored in binary
+// tree files, so new kinds go at the end.
+enum NodeKind {
+	ID_NODE, INTLIT_NODE, FLOATLIT_NODE, NESTED_EXPR_NODE,
+	ASSIGNMENT_NODE, COMPOUND_NODE, IF_NODE, WHILE_NODE, READ_NODE, WRITE_NODE,
+	EXPR_NODE, SIMPLE_EXPR_NODE, TERM_NODE, BLOCK_NODE, PROGRAM_NODE,
+	FOR_NODE, BREAK_NODE, CONTINUE_NODE
+};
+
+const char* const nodeKindNames[] = {
+	"identifier", "integer", "real", "nested expression",
+	"assignment", "compound statement", "IF", "WHILE", "READ", "WRITE",
+	"expression", "simple expression", "term", "block", "program",
+	"FOR", "BREAK", "CONTINUE"
+};
+
+//*****************************************************************************
+// Static types. Declarations give variables INTEGER or REAL; relational and
+// logical operators yield BOOLEAN. Expression nodes are annotated by the type
+// checker (typecheck.h) and stay TYPE_NONE until it has run.
+enum TipsType { TYPE_NONE, TYPE_INTEGER, TYPE_REAL, TYPE_BOOLEAN };
+
+const char* const typeNames[] = {"?", "INTEGER", "REAL", "BOOLEAN"};
+
 //*****************************************************************************
 // Abstract class. Base class for IdNode, IntLitNode, NestedExprNode.
 class FactorNode {
 public:
+    const NodeKind kind;
+    vector<int> unaryOps; // TOK_MINUS / TOK_NOT applied to the factor, outermost first
+    TipsType type = TYPE_NONE;  // after the unary operators
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
+    bool shared = false;  // belongs to an ExprTable, see hash_cons.h
+
+    FactorNode(NodeKind k) : kind(k) {}
     virtual void printTo(ostream &os) = 0; // pure virtual method, makes the class Abstract
     virtual ~FactorNode(); // labeling the destructor as virtual allows 
 	                       // the subclass destructors to be called
@@ -43,6 +80,15 @@ public:
 
 FactorNode::~FactorNode() {}
 
+// A hash-consed node (hash_cons.h) and everything below it belong to the
+// ExprTable that made it. A parent deletes a child that is not shared; a
+// shared parent leaves its children alone.
+template <class Node>
+void release(Node*& node) {
+	if (node && !node->shared) delete node;
+	node = nullptr;
+}
+
 // Uses double dispatch to call the overloaded method printTo in the 
 // FactorNodes: IdNode, IntLitNode, and NestedExprNode
 ostream& operator<<(ostream& os, FactorNode& fn) {
@@ -55,21 +101,25 @@ ostream& operator<<(ostream& os, FactorNode& fn) {
 class IdNode : public FactorNode {
 public:
     string* id = nullptr;
+    string name;  // the identifier alone, even when id holds compounded text
+    int slot = -1;  // variable slot, see BlockNode::variables
     bool compoundname = false;
 
     IdNode(string name);
-    IdNode(string compoundedname, bool compound);
+    IdNode(string compoundedname, bool compound, string identifier);
     ~IdNode();
     void printTo(ostream & os);
 };
 
-IdNode::IdNode(string name) {
+IdNode::IdNode(string name) : FactorNode(ID_NODE) {
 	id = new string(name);
+	this->name = name;
 }
 
 //overloaded constructor for case where minus or not tokens need to be added
-IdNode::IdNode(string compoundedname, bool compound) {
+IdNode::IdNode(string compoundedname, bool compound, string identifier) : FactorNode(ID_NODE) {
 	id = new string(compoundedname);
+	name = identifier;
 	compoundname = true;
 }
 
@@ -92,14 +142,16 @@ void IdNode::printTo(ostream& os) {
 class FloatLitNode : public FactorNode {
 public:
     float float_literal = 0;
+    double double_literal = 0; // full precision value for evaluation
 
-    FloatLitNode(float value);
+    FloatLitNode(double value);
     ~FloatLitNode();
     void printTo(ostream & os);
 };
 
-FloatLitNode::FloatLitNode(float value) {
+FloatLitNode::FloatLitNode(double value) : FactorNode(FLOATLIT_NODE) {
 	float_literal = value;
+	double_literal = value;
 }
 
 FloatLitNode::~FloatLitNode() {
@@ -120,18 +172,19 @@ public:
     string compoudedFactorInt = "";
 
     IntLitNode(int value);
-    IntLitNode(string value);
+    IntLitNode(string value, int literal);
     ~IntLitNode();
     void printTo(ostream & os);
 };
 
-IntLitNode::IntLitNode(int value) {
+IntLitNode::IntLitNode(int value) : FactorNode(INTLIT_NODE) {
 	int_literal = value;
 }
 
 //overloaded constructor for case where minus or not tokens need to be added
-IntLitNode::IntLitNode(string value) {
+IntLitNode::IntLitNode(string value, int literal) : FactorNode(INTLIT_NODE) {
 	compoudedFactorInt = value;
+	int_literal = literal;
 }
 
 IntLitNode::~IntLitNode() {
@@ -163,7 +216,7 @@ public:
 
 //optional parameter in constructor for case where minus or not tokens need to be added
 //wanted to test different methods of 'compounding' factorNodes
-NestedExprNode::NestedExprNode(ExprNode* en, string add = "") {
+NestedExprNode::NestedExprNode(ExprNode* en, string add = "") : FactorNode(NESTED_EXPR_NODE) {
 	exprPtr = en;
 	additional = add;
 	if (additional.compare("")){
@@ -184,6 +237,10 @@ public:
     FactorNode* firstFactor = nullptr;
     vector<int> restFactorOps; // TOK_MULTIPLY or TOK_DIV_OP
     vector<FactorNode*> restFactors;
+    TipsType type = TYPE_NONE;
+    vector<TipsType> opTypes;  // type each operator works on, operands are converted to it
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
+    bool shared = false;  // belongs to an ExprTable, see hash_cons.h
 
     ~TermNode();
 };
@@ -198,6 +255,8 @@ ostream& operator<<(ostream& os, TermNode& tn) {
 		int op = tn.restFactorOps[i];
 		if (op == TOK_MULTIPLY)
 			os << "* ";
+		else if (op == TOK_MOD)
+			os << "MOD ";
 		else
 			os << "/ ";
 		os << *(tn.restFactors[i]);
@@ -209,14 +268,12 @@ ostream& operator<<(ostream& os, TermNode& tn) {
 //delete everything within term node including first factor
 TermNode::~TermNode() {
 	cout << "Deleting a termNode" << endl;
-	delete firstFactor;
-	firstFactor = nullptr;
+	if (shared) return;
+	release(firstFactor);
 
 	int length = restFactorOps.size();
-	for (int i = 0; i < length; ++i) {
-		delete restFactors[i];
-		restFactors[i] = nullptr;
-	}
+	for (int i = 0; i < length; ++i)
+		release(restFactors[i]);
 }
 
 //*****************************************************************************
@@ -226,6 +283,10 @@ public:
     TermNode* firstTerm = nullptr;
     vector<int> restTermOps; // TOK_PLUS or TOK_SUB_OP
     vector<TermNode*> restTerms;
+    TipsType type = TYPE_NONE;
+    vector<TipsType> opTypes;  // type each operator works on, operands are converted to it
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
+    bool shared = false;  // belongs to an ExprTable, see hash_cons.h
 
     ~SimpleExprNode();
 };
@@ -253,14 +314,12 @@ ostream& operator<<(ostream& os, SimpleExprNode& en) {
 //delete simple expression node and everything within it
 SimpleExprNode::~SimpleExprNode() {
 	cout << "Deleting a simpleExpressionNode" << endl;
-	delete firstTerm;
-	firstTerm = nullptr;
+	if (shared) return;
+	release(firstTerm);
 
 	int length = restTermOps.size();
-	for (int i = 0; i < length; ++i) {
-		delete restTerms[i];
-		restTerms[i] = nullptr;
-	}
+	for (int i = 0; i < length; ++i)
+		release(restTerms[i]);
 }
 
 //*****************************************************************************
@@ -270,6 +329,10 @@ public:
     SimpleExprNode* simpleExpr = nullptr;
     vector<int> restExpOps; // TOK_PLUS or TOK_SUB_OP
     vector<SimpleExprNode*> restExpr;
+    TipsType type = TYPE_NONE;
+    vector<TipsType> opTypes;  // type each operator works on, operands are converted to it
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
+    bool shared = false;  // belongs to an ExprTable, see hash_cons.h
 
     ~ExprNode();
 };
@@ -294,28 +357,30 @@ ostream& operator<<(ostream& os, ExprNode& en) { //FIX
 //delete expression node and every node within it
 ExprNode::~ExprNode() {
 	cout << "Deleting an expressionNode" << endl;
-	delete simpleExpr;
-	simpleExpr = nullptr;
+	if (shared) return;
+	release(simpleExpr);
 
 	int length = restExpOps.size();
-	for (int i = 0; i < length; ++i) {
-		delete restExpr[i];
-		restExpr[i] = nullptr;
-	}
+	for (int i = 0; i < length; ++i)
+		release(restExpr[i]);
 }
 
 //delete nested expression node and every node within it
 NestedExprNode::~NestedExprNode() {
 	if (additional != "") cout << "Deleting a factorNode" << endl;
 	cout << "Deleting a factorNode" << endl;
-	delete exprPtr;
-	exprPtr = nullptr;
+	if (!shared) release(exprPtr);
 }
 
 //*****************************************************************************
 // Abstract class. Base class for IdNode, IntLitNode, NestedExprNode.
 class StatementNode {
 public:
+    const NodeKind kind;
+    int line;  // where the statement starts
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
+
+    StatementNode(NodeKind k) : kind(k), line(yylineno) {}
     virtual void printTo(ostream &os) = 0; // pure virtual method, makes the class Abstract
     virtual ~StatementNode(); // labeling the destructor as virtual allows 
 	                       // the subclass destructors to be called
@@ -336,7 +401,9 @@ class AssignmentNode : public StatementNode {
 public:
     ExprNode* expression = nullptr;
     string* id = nullptr;
+    int slot = -1;  // slot of the assigned variable
     vector<int> restFactorOps; // TOK_MULTIPLY or TOK_DIV_OP
+    AssignmentNode() : StatementNode(ASSIGNMENT_NODE) {}
     ~AssignmentNode();
     void printTo(ostream & os);
 };
@@ -344,8 +411,7 @@ public:
 //delete assignment node
 AssignmentNode::~AssignmentNode() {
 	cout << "Deleting an assignmentNode" << endl;
-	delete expression;
-	expression = nullptr;
+	release(expression);
 }
 
 //print assignment node
@@ -361,6 +427,7 @@ public:
     StatementNode* firstStatement = nullptr;
     vector<StatementNode*> restStatements;
 
+    CompoundNode() : StatementNode(COMPOUND_NODE) {}
     ~CompoundNode();
     void printTo(ostream & os);
 };
@@ -402,6 +469,7 @@ public:
     vector<StatementNode*> restStatements;
 
     //IfNode(string name);
+    IfNode() : StatementNode(IF_NODE) {}
     ~IfNode();
     void printTo(ostream & os);
 };
@@ -409,8 +477,7 @@ public:
 //delete If Node and the rest of expressions after it
 IfNode::~IfNode() {
 	cout << "Deleting an ifNode" << endl;
-	delete expression;
-	expression = nullptr;
+	release(expression);
 
 	int length = firstStatement.size();
 	for (int i = 0; i < length; ++i) {
@@ -452,6 +519,7 @@ public:
     vector<StatementNode*> restStatements;
 
     //WhileNode(string name);
+    WhileNode() : StatementNode(WHILE_NODE) {}
     ~WhileNode();
     void printTo(ostream & os);
 };
@@ -459,8 +527,7 @@ public:
 //delete while node and everything within it
 WhileNode::~WhileNode() {
 	cout << "Deleting a whileNode" << endl;
-	delete expression;
-	expression = nullptr;
+	release(expression);
 	delete firstStatement;
 	firstStatement = nullptr;
 
@@ -476,13 +543,90 @@ void WhileNode::printTo(ostream& os) {
 	os << "While " << *expression << endl << "%%%%%%%% Loop Body %%%%%%%%" << endl << *firstStatement << endl << "%%%%%%%%%%%%%%%%%%%%%%%%%%%" << endl;
 }
 
+//*****************************************************************************
+// class ForNode: FOR id := start TO limit <statement>, or DOWNTO. Start and
+// limit are evaluated once, in that order, before id is assigned. The body
+// runs while id has not passed the limit; after each run id steps by one,
+// and the loop ends unless id was still short of the limit. So a loop that
+// ran leaves id one step past the limit.
+class ForNode : public StatementNode {
+public:
+    string* id = nullptr;
+    int slot = -1;  // slot of the control variable
+    ExprNode* start = nullptr;
+    ExprNode* limit = nullptr;
+    bool down = false;  // DOWNTO
+    StatementNode* firstStatement = nullptr;
+
+    ForNode() : StatementNode(FOR_NODE) {}
+    ~ForNode();
+    void printTo(ostream & os);
+};
+
+//delete for node and everything within it
+ForNode::~ForNode() {
+	cout << "Deleting a forNode" << endl;
+	delete id;
+	id = nullptr;
+	release(start);
+	release(limit);
+	delete firstStatement;
+	firstStatement = nullptr;
+}
+
+//print for node and everything within it
+void ForNode::printTo(ostream& os) {
+	os << "For " << *id << " := " << *start << (down ? " DownTo " : " To ") << *limit << endl << "%%%%%%%% Loop Body %%%%%%%%" << endl << *firstStatement << endl << "%%%%%%%%%%%%%%%%%%%%%%%%%%%" << endl;
+}
+
+//*****************************************************************************
+// class BreakNode: leaves the innermost WHILE or FOR
+class BreakNode : public StatementNode {
+public:
+    BreakNode() : StatementNode(BREAK_NODE) {}
+    ~BreakNode();
+    void printTo(ostream & os);
+};
+
+//delete break node
+BreakNode::~BreakNode() {
+	cout << "Deleting a breakNode" << endl;
+}
+
+//print break
+void BreakNode::printTo(ostream& os) {
+	os << "Break" << endl;
+}
+
+//*****************************************************************************
+// class ContinueNode: ends the current iteration of the innermost WHILE or
+// FOR; WHILE tests its condition next, FOR steps its variable
+class ContinueNode : public StatementNode {
+public:
+    ContinueNode() : StatementNode(CONTINUE_NODE) {}
+    ~ContinueNode();
+    void printTo(ostream & os);
+};
+
+//delete continue node
+ContinueNode::~ContinueNode() {
+	cout << "Deleting a continueNode" << endl;
+}
+
+//print continue
+void ContinueNode::printTo(ostream& os) {
+	os << "Continue" << endl;
+}
+
 //*****************************************************************************
 // class ReadNode
 class ReadNode : public StatementNode {
 public:
     string* id = nullptr;
+    int slot = -1;  // slot of the variable read into
     vector<StatementNode*> restStatements;
 
+    ReadNode() : StatementNode(READ_NODE) {}
     ~ReadNode();
     void printTo(ostream & os);
 };
@@ -509,9 +653,17 @@ void ReadNode::printTo(ostream& os) {
 // class WriteNode
 class WriteNode : public StatementNode {
 public:
-    string* id = nullptr;
+    string* id = nullptr; // "Value <identifier>" or "String '<text>'"
+    int slot = -1;  // slot of the variable written, -1 for a string
     vector<StatementNode*> restStatements;
 
+    bool isString() const { return id->compare(0, 7, "String ") == 0; }
+    // The identifier, or the string literal without its quotes
+    string operand() const { return isString() ? id->substr(8, id->size() - 9) : id->substr(6); }
+    // The string literal, without copying it out of id
+    string_view text() const { return string_view(*id).substr(8, id->size() - 9); }
+
+    WriteNode() : StatementNode(WRITE_NODE) {}
     ~WriteNode();
     void printTo(ostream & os);
 };
@@ -539,8 +691,11 @@ void WriteNode::printTo(ostream& os) {
 class BlockNode {
 public:
     CompoundNode* firstCompound = nullptr;
+    vector<string> variables;  // declared variables, indexed by slot
+    vector<TipsType> variableTypes;  // declared type of each slot
     //vector<int> restFactorOps; // TOK_MULTIPLY or TOK_DIV_OP
     vector<CompoundNode*> restCompounds;
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
 
     ~BlockNode();
 };
@@ -573,6 +728,7 @@ public:
 	BlockNode* block = nullptr;
     string* id = nullptr;
     vector<BlockNode*> restBlocks;
+    uint64_t hash = 0;  // Merkle hash, see tree_hash.h
 
     ~ProgramNode();
 };
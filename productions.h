@@ -2,32 +2,113 @@
 #define PRODUCTIONS_H
 
 #include <iostream>
+#include <unordered_map>
 #include "parse_tree_nodes.h"
+#include "hash_cons.h"
+#include "tree_hash.h"
 
 extern set<string> symbolTable;
 int nextToken = 0;  // token returned from yylex
 int level = 0;  // used to indent output to approximate parse tree
+int loopDepth = 0;  // WHILE and FOR loops around the statement being parsed
 
 
 extern "C"
 {
     // Instantiate global variables used by flex
     extern char* yytext;       // text of current lexeme
+    extern int   yylineno;     // line number for current lexeme
     extern int   yylex();      // the generated lexical analyzer
+    extern void  yyrestart(FILE* input_file);  // point the lexer at a new file
 }
 
+
+//*****************************************************************************
+// Diagnostics
+//
+// Productions still report problems with `throw "NNN: message"`. Recovery
+// points in compound(), ifstat(), whilestat() and forstat() catch the message, record it
+// here and skip ahead to a synchronizing token (panic mode) so one pass can
+// report every error. Semantic errors (undeclared / redeclared identifiers)
+// are recorded without unwinding at all, as is a BREAK or CONTINUE that is
+// not inside a loop.
+struct Diagnostic {
+    int code;           // numeric error code from the message, 0 if none
+    int line;           // line number where the error was detected
+    string nearText;    // lexeme at the point of the error
+    string message;     // full message, e.g. "104: identifier not declared"
+};
+
+vector<Diagnostic> diagnostics;
+
+// Stop parsing once this many errors have been recorded, 0 means no limit.
+// The default of 1 keeps the classic stop-at-first-error behavior.
+int maxErrors = 1;
+
+// Thrown when maxErrors has been reached; caught in main()
+struct ParseAborted {};
+
+
+//*****************************************************************************
+// Variable slots
+//
+// Each variable declared in the VAR section gets a dense slot index, in order
+// of declaration, and every node that uses a variable carries its slot. The
+// execution engines then keep variables in a plain array instead of looking
+// them up by name. BlockNode::variables maps a slot back to its name.
+unordered_map<string, int> variableSlots;
+
+// Slot of a declared variable, -1 if it is not declared
+int slotOf(const char* name) {
+    auto found = variableSlots.find(name);
+    return found == variableSlots.end() ? -1 : found->second;
+}
+
+
+//*****************************************************************************
+// Finished nodes get their Merkle hash (tree_hash.h). With --hash-cons an
+// expression, simple expression, term or factor is then swapped for the
+// identical node the table already has, if any.
+template <class Node>
+Node* share(Node* node) {
+    node->hash = treeHash(*node);
+    return exprTable ? exprTable->intern(node) : node;
+}
+
+
+//*****************************************************************************
+// Streaming parse
+//
+// A ParseListener is handed the program one top-level statement at a time,
+// SAX style. Each statement is deleted as soon as onStatement() returns, so
+// memory stays bounded by the largest single statement instead of the whole
+// program. Nested statements are still delivered as part of their parent.
+class ParseListener {
+public:
+    virtual void onProgram(const string&) {}
+    virtual void onDeclaration(const string&) {}
+    virtual void onStatement(StatementNode& stmt) = 0;
+    virtual void onEnd() {}
+    virtual ~ParseListener() {}
+};
+
+ParseListener* streamListener = nullptr;  // set only while parseStreaming() runs
+
 // Forward declarations of production parsing functions
 ProgramNode* program();
 BlockNode* block();
 StatementNode* statement();
 AssignmentNode* assignment();
-CompoundNode* compound();
+CompoundNode* compound(ParseListener* listener = nullptr);
 ExprNode* expression();
 SimpleExprNode* simple_expression();
 TermNode* term();
 FactorNode* factor();
 IfNode* ifstat();
 WhileNode* whilestat();
+ForNode* forstat();
+BreakNode* breakstat();
+ContinueNode* continuestat();
 ReadNode* read();
 WriteNode* write();
 
@@ -45,6 +126,9 @@ bool first_of_term();
 bool first_of_factor();
 bool first_of_ifstat();
 bool first_of_whilestat();
+bool first_of_forstat();
+bool first_of_breakstat();
+bool first_of_continuestat();
 bool first_of_read();
 bool first_of_write();
 
@@ -67,6 +151,48 @@ void output(){
 }
 
 
+//*****************************************************************************
+// Record an error at the current token without unwinding
+void addDiagnostic(char const *errmsg) {
+    Diagnostic d;
+    d.code = atoi(errmsg);
+    d.line = yylineno;
+    d.nearText = yytext;
+    d.message = errmsg;
+    diagnostics.push_back(d);
+}
+
+// Record an error, giving up on the parse when the error limit is reached
+void recordError(char const *errmsg) {
+    addDiagnostic(errmsg);
+    if (maxErrors > 0 && (int)diagnostics.size() >= maxErrors)
+        throw ParseAborted();
+}
+
+// Skip tokens until one of syncSet is found at the current nesting depth.
+// BEGIN ... END pairs are skipped as a unit so a nested END does not end
+// the recovery early.
+void skipTo(initializer_list<int> syncSet) {
+    int depth = 0;
+    while (nextToken != TOK_EOF) {
+        if (depth == 0)
+            for (int tok : syncSet)
+                if (nextToken == tok) return;
+        if (nextToken == TOK_BEGIN) ++depth;
+        else if (nextToken == TOK_END && depth > 0) --depth;
+        nextToken = yylex();
+    }
+}
+
+// Record a caught syntax error and resynchronize. savedLevel restores the
+// trace indentation unwound by the throw.
+void recover(char const *errmsg, int savedLevel, initializer_list<int> syncSet) {
+    recordError(errmsg);
+    level = savedLevel;
+    skipTo(syncSet);
+}
+
+
 //********************************************************** PROGRAM **************************************************************
 ProgramNode* program() {
 
@@ -92,12 +218,17 @@ ProgramNode* program() {
         if (nextToken == TOK_IDENT) newProgramNode->id = new string(yytext);
     } 
 
+    if (streamListener && newProgramNode->id)
+        streamListener->onProgram(*newProgramNode->id);
+
     // Expects block and parses it
     if(first_of_block())
         newProgramNode->block = block();
     else
         throw Perr;
 
+    newProgramNode->hash = treeHash(*newProgramNode);
+
     --level;
     indent();
     cout << "exit <program>" << endl;
@@ -107,6 +238,71 @@ ProgramNode* program() {
 }
 
 
+//****************************************************** STREAMING PROGRAM *********************************************************
+// Parse a whole <program>, delivering its top-level statements to listener
+// as they complete. Works on any yyin, including stdin. Errors propagate the
+// same way they do from program().
+void parseStreaming(ParseListener& listener) {
+
+    streamListener = &listener;
+    ProgramNode* shell = nullptr;
+    try {
+        shell = program();  // the returned tree has no statements left in it
+    } catch (...) {
+        streamListener = nullptr;
+        throw;
+    }
+    streamListener = nullptr;
+
+    listener.onEnd();
+    delete shell;
+}
+
+
+//****************************************************** PARSE A FILE *********************************************************
+// Reset the parser and parse one whole program from in. With a listener the
+// program is streamed to it and nullptr is returned. Errors end up in
+// diagnostics; the (possibly partial) tree is then not returned.
+ProgramNode* parseProgram(FILE* in, ParseListener* listener = nullptr) {
+
+    yyrestart(in);
+    yylineno = 1;
+    symbolTable.clear();
+    variableSlots.clear();
+    diagnostics.clear();
+    level = 0;
+    loopDepth = 0;
+
+    ProgramNode* root = nullptr;
+    try {
+        nextToken = yylex();  // Get the first token
+
+        if (listener)
+            parseStreaming(*listener);
+        else
+            root = program();  // Process <program> production
+
+        if (nextToken != TOK_EOF)
+            throw "end of file expected, but there is more here!";
+
+    } catch (char const *errmsg) {
+        addDiagnostic(errmsg);
+    } catch (ParseAborted&) {
+        // error limit reached, the diagnostics are already recorded
+    }
+
+    if (!diagnostics.empty() && root) {
+        // the partial tree goes without deletion messages
+        bool muted = cout.bad();
+        cout.setstate(ios::badbit);
+        delete root;
+        if (!muted) cout.clear();
+        root = nullptr;
+    }
+    return root;
+}
+
+
 //*********************************************************** BLOCK *****************************************************************
 BlockNode* block(){
 
@@ -128,10 +324,24 @@ BlockNode* block(){
         nextToken = yylex();
         while(nextToken != TOK_BEGIN)
         {
+            if(nextToken == TOK_EOF)
+                throw "17: 'BEGIN' expected";
             if(nextToken == TOK_IDENT){
                 //checking if variable is added into symbolTable (repeated declaration error)
-                if (symbolTable.count(yytext)) throw "101: identifier declared twice";
+                if (symbolTable.count(yytext)) recordError("101: identifier declared twice");
+                else {
+                    variableSlots[yytext] = newBlockNode->variables.size();
+                    newBlockNode->variables.push_back(yytext);
+                    newBlockNode->variableTypes.push_back(TYPE_NONE);
+                }
                 symbolTable.insert(yytext);
+                if (streamListener) streamListener->onDeclaration(yytext);
+            }
+            if(nextToken == TOK_INTEGER || nextToken == TOK_REAL){
+                // the type applies to every name since the last one
+                TipsType declared = nextToken == TOK_INTEGER ? TYPE_INTEGER : TYPE_REAL;
+                for(auto t = newBlockNode->variableTypes.rbegin(); t != newBlockNode->variableTypes.rend() && *t == TYPE_NONE; ++t)
+                    *t = declared;
             }
             indent();
             cout << "-->found " << yytext << endl;
@@ -141,11 +351,14 @@ BlockNode* block(){
     }
     //checks for BEGIN_TOK
     if(nextToken == TOK_BEGIN){
-        newBlockNode->firstCompound = compound();
+        newBlockNode->firstCompound = compound(streamListener);
+        newBlockNode->firstCompound->hash = treeHash(*newBlockNode->firstCompound);
 
     } else throw "17: 'BEGIN' expected";
 
 
+    newBlockNode->hash = treeHash(*newBlockNode);
+
     --level;
     indent();
     cout << "exit <block>" << endl; 
@@ -200,6 +413,27 @@ StatementNode* statement(){
         statementnode = whilestat();
         break; 
 
+    case TOK_FOR:
+
+        if(!first_of_forstat())
+            throw "999: an error has occured";
+        statementnode = forstat();
+        break;
+
+    case TOK_BREAK:
+
+        if(!first_of_breakstat())
+            throw "999: an error has occured";
+        statementnode = breakstat();
+        break;
+
+    case TOK_CONTINUE:
+
+        if(!first_of_continuestat())
+            throw "999: an error has occured";
+        statementnode = continuestat();
+        break;
+
     case TOK_READ:
         if(!first_of_read())
             throw "999: an error has occured";
@@ -217,6 +451,8 @@ StatementNode* statement(){
         throw "SYNTAX ERROR";
     }
 
+    statementnode->hash = treeHash(*statementnode);
+
     --level;
     indent();
     cout << "exit <statement>" << endl; 
@@ -241,10 +477,11 @@ AssignmentNode* assignment(){
 
     // continues to parse assignment if next token IDENT or ASSIGN and outputs whats found
     if (nextToken == TOK_IDENT){
-        if(!symbolTable.count(yytext)) throw "104: identifier not declared"; //Check if identifier is declared
+        if(!symbolTable.count(yytext)) recordError("104: identifier not declared"); //Check if identifier is declared
         indent();
         cout << "-->found " << yytext << endl;
         assignNode->id = new string(yytext);
+        assignNode->slot = slotOf(yytext);
         nextToken = yylex();
         if(nextToken == TOK_ASSIGN)
         {
@@ -252,6 +489,8 @@ AssignmentNode* assignment(){
             cout << "-->found " << yytext << endl;
             nextToken = yylex();
         }
+        else
+            throw "51: ':=' expected";
     }
 
     //check if first of expression
@@ -272,7 +511,9 @@ AssignmentNode* assignment(){
 
 
 //************************************************************* COMPOUND *****************************************************
-CompoundNode* compound(){
+// When a listener is given (the top-level compound of a streaming parse)
+// statements are passed to it and released instead of being kept in the node.
+CompoundNode* compound(ParseListener* listener){
 
     // Checks for <compound>
     if(!first_of_compound())
@@ -284,44 +525,73 @@ CompoundNode* compound(){
     cout << "enter <compound_statement>" << endl;
     ++level;
 
-    // if next token is BEGIN, SEMICOLON, END, it outputs and parses based on whats found 
-    while(nextToken == TOK_BEGIN || nextToken == TOK_SEMICOLON || nextToken == TOK_END){
-        if(nextToken == TOK_BEGIN)
-        {
-            indent();
-            cout << "-->found " << yytext << endl;
-            nextToken = yylex();
+    // BEGIN is followed by the first statement
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
 
-            if(first_of_statement()){
-                newCompoundNode->firstStatement = statement();
+    int savedLevel = level;
+    try {
+        if(first_of_statement())
+        {
+            StatementNode* stmt = statement();
+            if (listener) {
+                listener->onStatement(*stmt);
+                delete stmt;
             }
             else
-                throw "17: 'BEGIN' expected";
+                newCompoundNode->firstStatement = stmt;
         }
-        else if(nextToken == TOK_SEMICOLON)
+        else
+            throw "17: 'BEGIN' expected";
+    } catch (char const *errmsg) {
+        recover(errmsg, savedLevel, {TOK_SEMICOLON, TOK_END});
+    }
+
+    // then any number of ';' <statement> until END
+    while(nextToken != TOK_END)
+    {
+        if(nextToken == TOK_SEMICOLON)
         {
             indent();
             cout << "-->found " << yytext << endl;
             nextToken = yylex();
-            if(first_of_statement())
-                newCompoundNode->restStatements.push_back(statement());
-            else
-                throw "14: ';' expected";
         }
+        else if(first_of_statement())
+            recordError("14: ';' expected"); // parse it as if the ';' was there
         else
         {
-            indent();
-            if(nextToken == TOK_END)
+            recordError("13: 'END' expected");
+            skipTo({TOK_SEMICOLON, TOK_END});
+            if(nextToken == TOK_EOF) break;
+            continue;
+        }
+
+        try {
+            if(first_of_statement())
             {
-                cout << "-->found " << yytext << endl;
-                nextToken = yylex();
-                break;
-            }  
+                StatementNode* stmt = statement();
+                if (listener) {
+                    listener->onStatement(*stmt);
+                    delete stmt;
+                }
+                else
+                    newCompoundNode->restStatements.push_back(stmt);
+            }
             else
-                throw "13: 'END' expected";
+                throw "14: ';' expected";
+        } catch (char const *errmsg) {
+            recover(errmsg, savedLevel, {TOK_SEMICOLON, TOK_END});
         }
     }
 
+    if(nextToken == TOK_END)
+    {
+        indent();
+        cout << "-->found " << yytext << endl;
+        nextToken = yylex();
+    }
+
     --level;
     indent();
     cout << "exit <compound_statement>" << endl; 
@@ -368,7 +638,7 @@ ExprNode* expression(){
     indent();
     cout << "exit <expression>" << endl;
 
-    return expression;
+    return share(expression);
 }
 
 
@@ -411,7 +681,7 @@ SimpleExprNode* simple_expression(){
     indent();
     cout << "exit <simple expression>" << endl;
 
-    return simpleExpr;
+    return share(simpleExpr);
 }
 
 
@@ -430,12 +700,12 @@ TermNode* term(){
 
     //Expected <factor>
     if(first_of_factor())
-        term->firstFactor = factor();
+        term->firstFactor = share(factor());
     else
         throw "903: illegal type of factor";
 
 
-    while(nextToken == TOK_MULTIPLY || nextToken == TOK_DIVIDE || nextToken == TOK_AND)
+    while(nextToken == TOK_MULTIPLY || nextToken == TOK_DIVIDE || nextToken == TOK_MOD || nextToken == TOK_AND)
     {
         //Output found token 
         indent();
@@ -444,7 +714,7 @@ TermNode* term(){
         nextToken = yylex();
         // Continue to parse factor
         if(first_of_factor())
-            term->restFactors.push_back(factor());
+            term->restFactors.push_back(share(factor()));
          else
             throw "903: illegal type of factor";
     }
@@ -453,7 +723,7 @@ TermNode* term(){
     indent();
     cout << "exit <term>" << endl;
 
-    return term;
+    return share(term);
 }
 
 //************************************************ FACTOR HELPER *******************************************************
@@ -470,7 +740,7 @@ FactorNode* factorHelper(string type){
 
     FactorNode* newFactorNode = nullptr;
 
-    if(!symbolTable.count(yytext) && nextToken == TOK_IDENT) throw "104: identifier not declared"; //Check if identifier is declared
+    if(!symbolTable.count(yytext) && nextToken == TOK_IDENT) recordError("104: identifier not declared"); //Check if identifier is declared
 
     //Switch to change between what token is found
     switch(nextToken)
@@ -478,7 +748,7 @@ FactorNode* factorHelper(string type){
     case TOK_INTLIT:
         indent();
         cout << "-->found " << yytext << endl;
-        newFactorNode = new IntLitNode(string(type + string(yytext) + " )"));
+        newFactorNode = new IntLitNode(string(type + string(yytext) + " )"), atoi(yytext));
         nextToken = yylex();
         break;
 
@@ -492,7 +762,8 @@ FactorNode* factorHelper(string type){
     case TOK_IDENT:
         indent();
         cout << "-->found " << yytext << endl;
-        newFactorNode = new IdNode(string(type + string(yytext) + " )"), true);
+        newFactorNode = new IdNode(string(type + string(yytext) + " )"), true, yytext);
+        ((IdNode*)newFactorNode)->slot = slotOf(yytext);
         nextToken = yylex();
         break; 
 
@@ -525,6 +796,7 @@ FactorNode* factorHelper(string type){
             else newFactorNode = factorHelper("NOT factor( ");
         else 
             throw "903: illegal type of factor";
+        newFactorNode->unaryOps.insert(newFactorNode->unaryOps.begin(), TOK_NOT);
         break; 
 
     case TOK_MINUS:
@@ -541,6 +813,7 @@ FactorNode* factorHelper(string type){
         }
         else 
             throw "903: illegal type of factor";
+        newFactorNode->unaryOps.insert(newFactorNode->unaryOps.begin(), TOK_MINUS);
         break;  
 
     default:
@@ -571,7 +844,7 @@ FactorNode* factor(){
 
     FactorNode* newFactorNode = nullptr;
 
-    if(!symbolTable.count(yytext) && nextToken == TOK_IDENT) throw "104: identifier not declared"; //Check if identifier is declared
+    if(!symbolTable.count(yytext) && nextToken == TOK_IDENT) recordError("104: identifier not declared"); //Check if identifier is declared
 
     //Switch to change between what token is found
     switch(nextToken)
@@ -594,6 +867,7 @@ FactorNode* factor(){
         indent();
         cout << "-->found " << yytext << endl;
         newFactorNode = new IdNode(string(yytext));
+        ((IdNode*)newFactorNode)->slot = slotOf(yytext);
         nextToken = yylex();
         break; 
 
@@ -627,6 +901,7 @@ FactorNode* factor(){
             else newFactorNode = factorHelper("NOT factor( ");// if any other token proceeds factor add 'not' in before
         else 
             throw "903: illegal type of factor";
+        newFactorNode->unaryOps.insert(newFactorNode->unaryOps.begin(), TOK_NOT);
         break; 
 
     case TOK_MINUS:
@@ -642,6 +917,7 @@ FactorNode* factor(){
         }
         else 
             throw "903: illegal type of factor";
+        newFactorNode->unaryOps.insert(newFactorNode->unaryOps.begin(), TOK_MINUS);
         break;  
 
     default:
@@ -669,30 +945,36 @@ IfNode* ifstat(){
     ++level;
 
     IfNode* ifnode = new IfNode;
+    int savedLevel = level;
 
-    // if next token IF, THEN, ELSE it outputs and parses based on whats found
-    if(nextToken == TOK_IF)
-    {
+    // IF <expression> THEN
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
+
+    try {
+        if(!first_of_expression())
+            throw "144: illegal type of expression";
+        ifnode->expression = expression();
         indent();
         cout << "-->found " << yytext << endl;
-        nextToken = yylex();
-        
-        while(first_of_expression()){
-            ifnode->expression = expression();
-            indent();
-            cout << "-->found " << yytext << endl;
-            if (nextToken == TOK_THEN) break;
-            nextToken = yylex();
-
-        }
+        if(nextToken != TOK_THEN)
+            throw "52: 'THEN' expected";
+    } catch (char const *errmsg) {
+        recover(errmsg, savedLevel, {TOK_THEN, TOK_ELSE, TOK_SEMICOLON, TOK_END});
     }
+
     if(nextToken == TOK_THEN)
     {
         nextToken = yylex();
-        if(first_of_statement())
-            ifnode->firstStatement.push_back(statement());
-        else
-            throw "900: illegal type of statement";
+        try {
+            if(first_of_statement())
+                ifnode->firstStatement.push_back(statement());
+            else
+                throw "900: illegal type of statement";
+        } catch (char const *errmsg) {
+            recover(errmsg, savedLevel, {TOK_ELSE, TOK_SEMICOLON, TOK_END});
+        }
     }
     if(nextToken == TOK_ELSE)
     {
@@ -700,11 +982,14 @@ IfNode* ifstat(){
         cout << "-->found " << yytext << endl;
         nextToken = yylex();
 
-        if(first_of_statement())
-            ifnode->restStatements.push_back(statement());
-        else
-            throw "900: illegal type of statement";
-    
+        try {
+            if(first_of_statement())
+                ifnode->restStatements.push_back(statement());
+            else
+                throw "900: illegal type of statement";
+        } catch (char const *errmsg) {
+            recover(errmsg, savedLevel, {TOK_SEMICOLON, TOK_END});
+        }
     }
 
     --level;
@@ -728,25 +1013,32 @@ WhileNode* whilestat(){
     ++level;
 
     WhileNode* whilenode = new WhileNode;
+    int savedLevel = level;
 
-    // do loop to parse expression and statement while next token WHILE
-    do
-    {
-        indent();
-        cout << "-->found " << yytext << endl;
-        nextToken = yylex();
+    // WHILE <expression> <statement>
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
 
+    try {
         if(!first_of_expression())
             throw "144: illegal type of expression";
         whilenode->expression = expression();
+    } catch (char const *errmsg) {
+        // there is no DO, so resynchronize on the start of the loop body
+        recover(errmsg, savedLevel, {TOK_BEGIN, TOK_IF, TOK_WHILE, TOK_FOR, TOK_BREAK, TOK_CONTINUE, TOK_READ, TOK_WRITE, TOK_SEMICOLON, TOK_END});
+    }
 
-        if(first_of_statement()){
+    ++loopDepth;
+    try {
+        if(first_of_statement())
             whilenode->firstStatement = statement();
-        }
         else
             throw "900: illegal type of statement";
-
-    }while(nextToken == TOK_WHILE);
+    } catch (char const *errmsg) {
+        recover(errmsg, savedLevel, {TOK_SEMICOLON, TOK_END});
+    }
+    --loopDepth;
 
     --level;
     indent();
@@ -756,6 +1048,129 @@ WhileNode* whilestat(){
 }
 
 
+//*********************************************************** FOR ***********************************************************
+ForNode* forstat(){
+
+    //Checks for <for>
+    if(!first_of_forstat())
+        throw "999: an error has occured";
+
+    indent();
+    cout << "enter <for statement>" << endl;
+    ++level;
+
+    ForNode* fornode = new ForNode;
+    int savedLevel = level;
+
+    // FOR <identifier> := <expression> TO | DOWNTO <expression> <statement>
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
+
+    try {
+        if(nextToken != TOK_IDENT)
+            throw "2: identifier expected";
+        if(!symbolTable.count(yytext)) recordError("104: identifier not declared");
+        indent();
+        cout << "-->found " << yytext << endl;
+        fornode->id = new string(yytext);
+        fornode->slot = slotOf(yytext);
+        nextToken = yylex();
+
+        if(nextToken != TOK_ASSIGN)
+            throw "51: ':=' expected";
+        indent();
+        cout << "-->found " << yytext << endl;
+        nextToken = yylex();
+
+        if(!first_of_expression())
+            throw "144: illegal type of expression";
+        fornode->start = expression();
+
+        if(nextToken != TOK_TO && nextToken != TOK_DOWNTO)
+            throw "55: 'TO' or 'DOWNTO' expected";
+        indent();
+        cout << "-->found " << yytext << endl;
+        fornode->down = nextToken == TOK_DOWNTO;
+        nextToken = yylex();
+
+        if(!first_of_expression())
+            throw "144: illegal type of expression";
+        fornode->limit = expression();
+    } catch (char const *errmsg) {
+        // like WHILE there is no DO, so resynchronize on the start of the body
+        recover(errmsg, savedLevel, {TOK_BEGIN, TOK_IF, TOK_WHILE, TOK_FOR, TOK_BREAK, TOK_CONTINUE, TOK_READ, TOK_WRITE, TOK_SEMICOLON, TOK_END});
+    }
+
+    ++loopDepth;
+    try {
+        if(first_of_statement())
+            fornode->firstStatement = statement();
+        else
+            throw "900: illegal type of statement";
+    } catch (char const *errmsg) {
+        recover(errmsg, savedLevel, {TOK_SEMICOLON, TOK_END});
+    }
+    --loopDepth;
+
+    --level;
+    indent();
+    cout << "exit <for statement>" << endl; 
+
+    return fornode;
+}
+
+
+//********************************************************** BREAK ***********************************************************
+BreakNode* breakstat(){
+
+    //Checks for <break>
+    if(!first_of_breakstat())
+        throw "999: an error has occured";
+
+    indent();
+    cout << "enter <break>" << endl;
+    ++level;
+
+    BreakNode* breaknode = new BreakNode;
+    if(loopDepth == 0) recordError("904: BREAK or CONTINUE outside of a loop");
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
+
+    --level;
+    indent();
+    cout << "exit <break>" << endl;
+
+    return breaknode;
+}
+
+
+//********************************************************* CONTINUE *********************************************************
+ContinueNode* continuestat(){
+
+    //Checks for <continue>
+    if(!first_of_continuestat())
+        throw "999: an error has occured";
+
+    indent();
+    cout << "enter <continue>" << endl;
+    ++level;
+
+    ContinueNode* continuenode = new ContinueNode;
+    if(loopDepth == 0) recordError("904: BREAK or CONTINUE outside of a loop");
+    indent();
+    cout << "-->found " << yytext << endl;
+    nextToken = yylex();
+
+    --level;
+    indent();
+    cout << "exit <continue>" << endl;
+
+    return continuenode;
+}
+
+
 //************************************************************ READ ******************************************************
 ReadNode* read(){
     // Checks for <read>
@@ -773,10 +1188,17 @@ ReadNode* read(){
     {
         indent();
         cout << "-->found " << yytext << endl;
-        if(nextToken == TOK_IDENT) read->id = new string(yytext);
+        if(nextToken == TOK_IDENT){
+            if(!symbolTable.count(yytext)) recordError("104: identifier not declared");
+            read->id = new string(yytext);
+            read->slot = slotOf(yytext);
+        }
         nextToken = yylex();
 
     }while(nextToken == TOK_OPENPAREN || nextToken == TOK_IDENT || nextToken == TOK_CLOSEPAREN); 
+
+    if(read->id == nullptr)
+        throw "2: identifier expected";
     --level;
     indent();
     cout << "exit <read>" << endl; 
@@ -812,7 +1234,9 @@ WriteNode* write(){
         indent();
         cout << "-->found " << yytext << endl;
         //if (nextToken == TOK_IDENT || nextToken == TOK_STRINGLIT) write->id = new string(yytext);
+        if(nextToken == TOK_IDENT && !symbolTable.count(yytext)) recordError("104: identifier not declared");
         (nextToken == TOK_IDENT) ? write->id = new string("Value "s + yytext) : ((nextToken == TOK_STRINGLIT) ? write->id = new string("String "s + yytext) : (string*)0);
+        if (nextToken == TOK_IDENT) write->slot = slotOf(yytext);
         nextToken = yylex();
 
         if(nextToken == TOK_CLOSEPAREN){
@@ -823,6 +1247,9 @@ WriteNode* write(){
         }
     }
 
+    if(write->id == nullptr)
+        throw "134: illegal type of operand(s)";
+
     --level;
     indent();
     cout << "exit <write>" << endl; 
@@ -847,7 +1274,8 @@ bool first_of_block(void) {
 
 bool first_of_statement(void) {
     return nextToken == TOK_IDENT || nextToken == TOK_BEGIN || nextToken == TOK_IF 
-    || nextToken == TOK_WHILE || nextToken == TOK_READ || nextToken == TOK_WRITE;
+    || nextToken == TOK_WHILE || nextToken == TOK_FOR || nextToken == TOK_BREAK || nextToken == TOK_CONTINUE
+    || nextToken == TOK_READ || nextToken == TOK_WRITE;
 }
 
 bool first_of_assignment(void) {
@@ -866,6 +1294,18 @@ bool first_of_whilestat(void) {
     return nextToken == TOK_WHILE;
 }
 
+bool first_of_forstat(void) {
+    return nextToken == TOK_FOR;
+}
+
+bool first_of_breakstat(void) {
+    return nextToken == TOK_BREAK;
+}
+
+bool first_of_continuestat(void) {
+    return nextToken == TOK_CONTINUE;
+}
+
 bool first_of_read(void) {
     return nextToken == TOK_READ;
 }
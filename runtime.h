@@ -0,0 +1,421 @@
+//*****************************************************************************
+// Runtime support shared by every way of executing a TIPS program
+//
+// Values are INTEGER (64-bit) or REAL (double). Relational and logical
+// operators produce INTEGER 0 or 1 (BOOLEAN), and IF / WHILE treat any
+// non-zero value as true. READ takes the next whitespace separated number
+// from the input, WRITE prints one value or string per line.
+//*****************************************************************************
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "lexer.h"
+
+using namespace std;
+
+// For what the engines call on every iteration, even in unoptimized builds
+#ifdef __GNUC__
+#define TIPS_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define TIPS_ALWAYS_INLINE inline
+#endif
+
+//*****************************************************************************
+// A tagged INTEGER / REAL value
+struct Value {
+    bool isReal = false;
+    union {
+        int64_t i = 0;
+        double r;
+    };
+
+    static Value integer(int64_t v) { Value x; x.i = v; return x; }
+    static Value real(double v) { Value x; x.isReal = true; x.r = v; return x; }
+
+    double asReal() const { return isReal ? r : (double)i; }
+    bool truth() const { return isReal ? r != 0 : i != 0; }
+};
+
+//*****************************************************************************
+// INTEGER arithmetic wraps around, as in the C the translator emits: it is
+// done on uint64_t, where overflow is defined. x / -1 is a negation and
+// x MOD -1 is 0, so INT64_MIN / -1 gives INT64_MIN instead of trapping.
+inline int64_t addI(int64_t a, int64_t b) { return (int64_t)((uint64_t)a + (uint64_t)b); }
+inline int64_t subI(int64_t a, int64_t b) { return (int64_t)((uint64_t)a - (uint64_t)b); }
+inline int64_t mulI(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }
+inline int64_t negI(int64_t a) { return (int64_t)(0 - (uint64_t)a); }
+
+inline int64_t divI(int64_t a, int64_t b) {
+    if (b == 0) throw "division by zero";
+    return b == -1 ? negI(a) : a / b;
+}
+
+inline int64_t modI(int64_t a, int64_t b) {
+    if (b == 0) throw "division by zero";
+    return b == -1 ? 0 : a % b;
+}
+
+//*****************************************************************************
+// Operator semantics on tagged values, used by the tree walker.
+// Runtime errors are thrown as char const* like parse errors.
+Value applyBinary(int op, const Value& x, const Value& y) {
+    switch (op) {
+    case TOK_PLUS:
+        if (x.isReal || y.isReal) return Value::real(x.asReal() + y.asReal());
+        return Value::integer(addI(x.i, y.i));
+    case TOK_MINUS:
+        if (x.isReal || y.isReal) return Value::real(x.asReal() - y.asReal());
+        return Value::integer(subI(x.i, y.i));
+    case TOK_MULTIPLY:
+        if (x.isReal || y.isReal) return Value::real(x.asReal() * y.asReal());
+        return Value::integer(mulI(x.i, y.i));
+    case TOK_DIVIDE:
+        if (x.isReal || y.isReal) return Value::real(x.asReal() / y.asReal());
+        return Value::integer(divI(x.i, y.i));
+    case TOK_MOD:
+        if (x.isReal || y.isReal) throw "MOD needs INTEGER operands";
+        return Value::integer(modI(x.i, y.i));
+    case TOK_AND:
+        return Value::integer(x.truth() && y.truth());
+    case TOK_OR:
+        return Value::integer(x.truth() || y.truth());
+    case TOK_EQUALTO:
+        return Value::integer(x.isReal || y.isReal ? x.asReal() == y.asReal() : x.i == y.i);
+    case TOK_NOTEQUALTO:
+        return Value::integer(x.isReal || y.isReal ? x.asReal() != y.asReal() : x.i != y.i);
+    case TOK_LESSTHAN:
+        return Value::integer(x.isReal || y.isReal ? x.asReal() < y.asReal() : x.i < y.i);
+    case TOK_GREATERTHAN:
+        return Value::integer(x.isReal || y.isReal ? x.asReal() > y.asReal() : x.i > y.i);
+    default:
+        throw "unknown operator";
+    }
+}
+
+Value applyUnary(int op, const Value& x) {
+    if (op == TOK_NOT)
+        return Value::integer(!x.truth());
+    return x.isReal ? Value::real(-x.r) : Value::integer(negI(x.i));
+}
+
+// FOR (ForNode): the control variable after an iteration that ran with i,
+// wrapping like INTEGER arithmetic, and whether the loop goes on
+inline int64_t forNext(int64_t i, bool down) { return addI(i, down ? -1 : 1); }
+inline bool forContinues(int64_t i, int64_t limit, bool down) { return down ? i > limit : i < limit; }
+
+// How a statement ended, in the engines that run statements by calling
+// them: a BREAK or CONTINUE unwinds to the innermost loop
+enum Flow { FLOW_NEXT, FLOW_BREAK, FLOW_CONTINUE };
+
+//*****************************************************************************
+// READ / WRITE
+//
+// Input is read from the stream a block at a time and cut into tokens in
+// place. Numbers are parsed with from_chars, falling back on strtoll /
+// strtod for the few forms only those take, such as a leading '+'. Output
+// collects in a buffer, numbers formatted with to_chars the way ostream
+// formats them (%g for REAL), and goes to the stream a block at a time and
+// on flush(). A Runtime can also read from memory and keep its output in
+// memory (written()), which --records does for every record.
+//
+// After useWritev(fd) output goes to the file descriptor with writev.
+// Numbers are formatted into the buffer as before, but a string literal is
+// not copied: it is passed as its own segment from where the program keeps
+// it (the parse tree, or the strings of a Chunk), so it has to stay alive
+// until the next flush().
+const size_t IO_BLOCK = 64 * 1024;
+const size_t IO_SEGMENTS = 1024;  // at most IOV_MAX on Linux
+
+inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+//*****************************************************************************
+// Execution limits (--max-steps, --max-seconds, --max-output)
+//
+// Straight-line code ends by itself, so only loops are checked: every
+// engine calls backEdge() once per loop iteration, which counts a step down.
+// Only every STEP_POLL steps does it poll() the rest of the steps and the
+// flag a Watchdog (watchdog.h) raises when time is up, so the hot path pays
+// one decrement and one branch. Output is charged as it is written.
+//
+// A step is an iteration after the first, which is what a rotated loop's
+// backward branch counts; the unoptimized bytecode (--no-opt) also jumps
+// back into the first iteration, so it stops one step earlier per loop
+// entered.
+const int64_t STEP_POLL = 4096;
+
+atomic<bool> neverExpires(false);
+
+struct Budget {
+    int64_t countdown = 0;                        // steps until the next poll
+    int64_t steps = INT64_MAX;                    // loop iterations left after those
+    const atomic<bool>* expired = &neverExpires;  // set when time is up
+    uint64_t output = UINT64_MAX;                 // bytes of output left
+};
+
+class Runtime {
+public:
+    Runtime(istream& input, ostream& output) : in(&input), out(&output) {}
+    Runtime(string_view input) : next(input.data()), last(input.data() + input.size()) {}
+    ~Runtime() { flush(); }
+
+    Value read();
+    int64_t readInteger();
+    double readReal();
+    void write(const Value& v);
+    void writeInteger(int64_t i);
+    void writeReal(double r);
+    void writeString(string_view s);
+    void writeError(const char* errmsg);
+
+    Budget budget;
+    TIPS_ALWAYS_INLINE void backEdge() {
+        if (--budget.countdown < 0) poll();
+    }
+    void poll();
+
+    void useWritev(int fd);
+    void flush();
+    const string& written() const { return buf; }
+
+private:
+    istream* in = nullptr;
+    string inbuf;                // the block of input being read
+    const char* next = nullptr;  // what is left of it
+    const char* last = nullptr;
+
+    ostream* out = nullptr;
+    int fd = -1;
+    string buf;                  // output not flushed yet
+    vector<iovec> segments;      // with writev: the output in order
+
+    bool readToken(string_view& token);
+    bool refill(const char*& keep);
+    Value readText(const string& token);
+    void charge(size_t n);
+    void put(const char* text, size_t n);
+    void segment(const char* text, size_t n);
+};
+
+// The next whitespace separated token, as in >> string would read it
+bool Runtime::readToken(string_view& token) {
+    while (next == last || isSpace(*next)) {
+        if (next == last && !refill(next)) return false;
+        while (next < last && isSpace(*next)) ++next;
+    }
+    const char* start = next;
+    for (;;) {
+        while (next < last && !isSpace(*next)) ++next;
+        if (next < last || !refill(start)) break;
+    }
+    token = string_view(start, next - start);
+    return true;
+}
+
+// Reads the next block of input after what is left from keep on, which
+// moves to the start of the buffer. False at the end of the input.
+bool Runtime::refill(const char*& keep) {
+    if (!in) return false;
+    size_t kept = last - keep;
+    if (inbuf.size() < kept + IO_BLOCK) {
+        string grown(kept + IO_BLOCK, '\0');
+        if (kept) memcpy(&grown[0], keep, kept);
+        inbuf.swap(grown);
+    }
+    else if (kept)
+        memmove(&inbuf[0], keep, kept);
+    streamsize got = in->rdbuf()->sgetn(&inbuf[kept], IO_BLOCK);
+    keep = inbuf.data();
+    next = keep + kept;
+    last = next + max<streamsize>(got, 0);
+    return got > 0;
+}
+
+Value Runtime::read() {
+    string_view token;
+    if (!readToken(token))
+        throw "READ past the end of the input";
+
+    const char* first = token.data();
+    const char* end = first + token.size();
+    if (token.find_first_of(".eE") != string_view::npos) {
+        double r;
+        from_chars_result got = from_chars(first, end, r);
+        if (got.ec == errc() && got.ptr == end) return Value::real(r);
+    }
+    else {
+        int64_t i;
+        from_chars_result got = from_chars(first, end, i);
+        if (got.ec == errc() && got.ptr == end) return Value::integer(i);
+    }
+    return readText(string(token));
+}
+
+// What from_chars does not take: a leading '+', hex REALs, and numbers out
+// of range, which saturate
+Value Runtime::readText(const string& token) {
+    char* end = nullptr;
+    if (token.find_first_of(".eE") != string::npos) {
+        double r = strtod(token.c_str(), &end);
+        if (*end == '\0') return Value::real(r);
+    }
+    else {
+        long long i = strtoll(token.c_str(), &end, 10);
+        if (*end == '\0') return Value::integer(i);
+    }
+    throw "READ expects a number";
+}
+
+// READ into an INTEGER variable
+int64_t Runtime::readInteger() {
+    Value v = read();
+    if (v.isReal) throw "READ expects an INTEGER";
+    return v.i;
+}
+
+// READ into a REAL variable, which also takes an INTEGER
+double Runtime::readReal() {
+    return read().asReal();
+}
+
+void Runtime::write(const Value& v) {
+    if (v.isReal) writeReal(v.r);
+    else writeInteger(v.i);
+}
+
+void Runtime::writeInteger(int64_t i) {
+    char text[24];
+    char* end = to_chars(text, text + sizeof text, i).ptr;
+    *end++ = '\n';
+    charge(end - text);
+    put(text, end - text);
+}
+
+// As ostream writes a double by default: %g, 6 significant digits. The
+// sign of a NaN depends on how each engine computed it, so every NaN is
+// printed as "nan" and the engines' output can be compared.
+void Runtime::writeReal(double r) {
+    if (r != r) r = fabs(r);
+    char text[32];
+    char* end = to_chars(text, text + sizeof text, r, chars_format::general, 6).ptr;
+    *end++ = '\n';
+    charge(end - text);
+    put(text, end - text);
+}
+
+void Runtime::writeString(string_view s) {
+    charge(s.size() + 1);
+    if (fd >= 0 && !s.empty()) {
+        segment(s.data(), s.size());
+        put("\n", 1);
+    }
+    else {
+        put(s.data(), s.size());
+        put("\n", 1);
+    }
+}
+
+void Runtime::writeError(const char* errmsg) {
+    const char prefix[] = "***RUNTIME ERROR: ";
+    put(prefix, sizeof prefix - 1);
+    put(errmsg, strlen(errmsg));
+    put("\n", 1);
+}
+
+// The countdown ran out: takes this step and the next ones from the rest,
+// or stops the program when a limit is reached
+void Runtime::poll() {
+    budget.countdown = 0;
+    if (budget.expired->load(memory_order_relaxed)) throw "time limit exceeded";
+    if (budget.steps <= 0) throw "step limit exceeded";
+    int64_t n = min(budget.steps, STEP_POLL);
+    budget.steps -= n;
+    budget.countdown = n - 1;
+}
+
+// Output the program writes counts against budget.output; the error
+// message that may follow does not
+void Runtime::charge(size_t n) {
+    if (n > budget.output) {
+        budget.output = 0;
+        throw "output limit exceeded";
+    }
+    budget.output -= n;
+}
+
+void Runtime::useWritev(int fileno) {
+    flush();
+    fd = fileno;
+}
+
+void Runtime::put(const char* text, size_t n) {
+    if (!out && fd < 0) {
+        buf.append(text, n);
+        return;
+    }
+    if (buf.size() + n > IO_BLOCK) {
+        flush();
+        if (n > IO_BLOCK) {
+            // too long to buffer: on its own (buf has no room for it)
+            if (fd >= 0) {
+                segment(text, n);
+                flush();
+            }
+            else
+                out->write(text, n);
+            return;
+        }
+    }
+    if (buf.capacity() < IO_BLOCK) buf.reserve(IO_BLOCK);
+    size_t at = buf.size();
+    buf.append(text, n);
+    if (fd >= 0) segment(buf.data() + at, n);
+}
+
+// The next piece of writev output; buf never reallocates in between
+void Runtime::segment(const char* text, size_t n) {
+    if (!segments.empty() && (const char*)segments.back().iov_base + segments.back().iov_len == text)
+        segments.back().iov_len += n;
+    else
+        segments.push_back(iovec{(void*)text, n});
+    if (segments.size() == IO_SEGMENTS) flush();
+}
+
+void Runtime::flush() {
+    if (fd >= 0) {
+        size_t i = 0;
+        while (i < segments.size()) {
+            ssize_t n = writev(fd, &segments[i], min(segments.size() - i, IO_SEGMENTS));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (; i < segments.size() && (size_t)n >= segments[i].iov_len; ++i)
+                n -= segments[i].iov_len;
+            if (n > 0) {
+                segments[i].iov_base = (char*)segments[i].iov_base + n;
+                segments[i].iov_len -= n;
+            }
+        }
+        segments.clear();
+    }
+    else if (out)
+        out->write(buf.data(), buf.size());
+    else
+        return;
+    buf.clear();
+}
+
+#endif /* RUNTIME_H */
@@ -0,0 +1,118 @@
+//*****************************************************************************
+// Running --records on several threads (tips_parse --threads=N)
+//
+// The records file is mapped into memory (MappedFile, ast_binary.h), or
+// read into a buffer when it cannot be, and cut into shards of whole lines.
+// Worker threads take the next shard from a shared counter and run it with
+// their own LaneEvaluator, so every thread has its own variable slots and
+// the parse tree is only read. A shard's output goes to its own buffer, and
+// the main thread writes the buffers in input order as they are finished,
+// so the output does not depend on the number of threads.
+//*****************************************************************************
+#ifndef SHARDS_H
+#define SHARDS_H
+
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "lanes.h"
+
+using namespace std;
+
+//*****************************************************************************
+// Shards of whole lines, about count of them
+struct Shard {
+    const char* begin;
+    const char* end;
+    string output;
+    size_t records = 0;
+    const char* error = nullptr;
+    bool done = false;
+
+    Shard(const char* from, const char* to) : begin(from), end(to) {}
+};
+
+vector<Shard> splitShards(const char* data, size_t size, size_t count) {
+    vector<Shard> shards;
+    size_t target = max<size_t>(size / count, 1);
+    const char* end = data + size;
+    for (const char* p = data; p < end; ) {
+        const char* stop = end;
+        if ((size_t)(end - p) > target) {
+            const char* nl = (const char*)memchr(p + target - 1, '\n', end - (p + target - 1));
+            if (nl) stop = nl + 1;
+        }
+        shards.emplace_back(p, stop);
+        p = stop;
+    }
+    return shards;
+}
+
+// Runs the program on every record of the text like runRecords, on the
+// given number of threads. Returns the number of records.
+size_t runRecordsThreaded(ProgramNode& pn, const char* data, size_t size, ostream& out, int threads,
+                          const Budget& budget = Budget()) {
+    if (threads <= 1)
+        return runRecords(pn, data, data + size, out, budget);
+
+    // several shards per thread, so a slow shard does not hold up the rest
+    vector<Shard> shards = splitShards(data, size, (size_t)threads * 8);
+    atomic<size_t> next(0);
+    atomic<bool> stop(false);
+    mutex lock;
+    condition_variable finished;
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t k = next++;
+            if (k >= shards.size() || stop) return;
+            Shard& s = shards[k];
+            ostringstream os;
+            size_t records = 0;
+            const char* error = nullptr;
+            try {
+                records = runRecords(pn, s.begin, s.end, os, budget);
+            }
+            catch (char const* errmsg) {
+                error = errmsg;
+            }
+            lock_guard<mutex> guard(lock);
+            s.output = os.str();
+            s.records = records;
+            s.error = error;
+            s.done = true;
+            finished.notify_all();
+        }
+    };
+    vector<thread> pool;
+    for (int t = 0; t < threads && t < (int)shards.size(); ++t)
+        pool.emplace_back(worker);
+
+    size_t records = 0;
+    const char* error = nullptr;
+    for (Shard& s : shards) {
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&] { return s.done; });
+        if (s.error) {
+            error = s.error;
+            stop = true;
+            break;
+        }
+        string output;
+        output.swap(s.output);
+        guard.unlock();
+        out << output;
+        records += s.records;
+    }
+    for (thread& t : pool)
+        t.join();
+    if (error) throw error;
+    return records;
+}
+
+#endif /* SHARDS_H */
@@ -0,0 +1,46 @@
+//*****************************************************************************
+// Superinstructions of the VM (vm.h)
+//
+// Generated by benchmarks/profile.sh (tips_parse --gen-super) from the
+// opcode pairs run by the unit tests and the benchmarks; regenerate it
+// rather than editing it. X(a, b): instruction a followed by instruction b
+// runs as one, most frequent pair first.
+//*****************************************************************************
+#ifndef SUPERINSTRUCTIONS_H
+#define SUPERINSTRUCTIONS_H
+
+#define TIPS_SUPERINSTRUCTIONS(X) \
+    X(LTI, JMPT)      /*  6.8% */ \
+    X(ADDI, LTI)      /*  6.4% */ \
+    X(GTI, JMPT)      /*  2.9% */ \
+    X(SUBI, GTI)      /*  2.2% */ \
+    X(ADDI, MODPI)    /*  2.2% */ \
+    X(GTI, JMPF)      /*  1.9% */ \
+    X(SUBI, ADDI)     /*  1.8% */ \
+    X(SHLI, ADDI)     /*  1.7% */ \
+    X(MOVE, MOVE)     /*  1.6% */ \
+    X(DIVI, ADDI)     /*  1.6% */ \
+    X(LTF, JMPT)      /*  1.4% */ \
+    X(MODPI, SUBI)    /*  1.3% */ \
+    X(MULI, ADDI)     /*  1.3% */ \
+    X(ADDF, LTF)      /*  1.2% */ \
+    X(LTF, JMPF)      /*  1.2% */ \
+    X(ADDI, SHLI)     /*  1.2% */ \
+    X(ADDF, ADDI)     /*  1.1% */ \
+    X(I2F, DIVF)      /*  1.1% */ \
+    X(ADDI, NEI)      /*  1.1% */ \
+    X(NEI, JMPT)      /*  1.1% */ \
+    X(EQI, JMPF)      /*  1.0% */ \
+    X(MULF, MULF)     /*  1.0% */ \
+    X(ADDI, ADDF)     /*  1.0% */ \
+    X(MOVE, ADDI)     /*  1.0% */ \
+    X(ADDI, GTI)      /*  0.9% */ \
+    X(ADDI, FORUP)    /*  0.8% */ \
+    X(LTI, JMPF)      /*  0.7% */ \
+    X(EQI, JMPT)      /*  0.7% */ \
+    X(I2F, ADDF)      /*  0.7% */ \
+    X(MODPI, ADDI)    /*  0.7% */ \
+    X(ADDI, MOVE)     /*  0.7% */ \
+    X(MODI, EQI)      /*  0.7% */
+
+#endif /* SUPERINSTRUCTIONS_H */
@@ -0,0 +1,271 @@
+//*****************************************************************************
+// Tree diff
+//
+// Compares two parses of a program, typically two versions of the same
+// source, and lists what changed. Subtrees with equal Merkle hashes
+// (tree_hash.h) are equal and are skipped without looking inside, so the
+// work grows with the size of the edit, plus one hash compared per
+// statement in the lists it is in, rather than with the size of the
+// program.
+//
+// Where two nodes differ but have the same shape (same kind, operators and
+// identifiers) the diff goes down into their children and reports the
+// innermost nodes that differ: an edited operand shows up as a changed
+// factor, not as a changed statement. Statement lists are aligned on their
+// hashes, so statements that were inserted or removed are reported as such
+// and the ones after them still match.
+//*****************************************************************************
+#ifndef TREE_DIFF_H
+#define TREE_DIFF_H
+
+#include <algorithm>
+#include <vector>
+#include "parse_tree_nodes.h"
+
+using namespace std;
+
+struct TreeChange {
+    enum What { CHANGED, ADDED, REMOVED };
+
+    What what;
+    NodeKind kind;           // of after, or of before when removed
+    const void* before;      // node in the old tree, nullptr when added
+    const void* after;       // node in the new tree, nullptr when removed
+    int beforeLine;          // lines of the statements they are in, 0 for
+    int afterLine;           // the declarations and the program name
+};
+
+class TreeDiff {
+public:
+    vector<TreeChange> changes;
+    size_t compared = 0;  // node pairs whose hashes were compared
+
+    const vector<TreeChange>& diff(ProgramNode& before, ProgramNode& after);
+
+private:
+    int beforeLine = 0, afterLine = 0;
+
+    void change(TreeChange::What what, NodeKind kind, const void* before, const void* after);
+    void statement(StatementNode* a, StatementNode* b);
+    void statements(const vector<StatementNode*>& a, const vector<StatementNode*>& b);
+    void expression(ExprNode* a, ExprNode* b);
+    void simpleExpression(SimpleExprNode* a, SimpleExprNode* b);
+    void term(TermNode* a, TermNode* b);
+    void factor(FactorNode* a, FactorNode* b);
+
+    // Generic work on an operator chain: first op[0] rest[0] op[1] rest[1] ...
+    template <class Node, class Child>
+    void chain(NodeKind kind, Node* a, Node* b, Child* Node::*first, vector<int> Node::*ops,
+               vector<Child*> Node::*rest, void (TreeDiff::*child)(Child*, Child*));
+};
+
+const vector<TreeChange>& TreeDiff::diff(ProgramNode& before, ProgramNode& after) {
+    changes.clear();
+    compared = 1;
+    if (before.hash == after.hash)
+        return changes;
+
+    beforeLine = afterLine = 0;
+    if (*before.id != *after.id)
+        change(TreeChange::CHANGED, PROGRAM_NODE, &before, &after);
+
+    BlockNode& a = *before.block;
+    BlockNode& b = *after.block;
+    ++compared;
+    if (a.hash != b.hash) {
+        if (a.variables != b.variables || a.variableTypes != b.variableTypes)
+            change(TreeChange::CHANGED, BLOCK_NODE, &a, &b);
+        statement(a.firstCompound, b.firstCompound);
+    }
+    return changes;
+}
+
+void TreeDiff::change(TreeChange::What what, NodeKind kind, const void* before, const void* after) {
+    changes.push_back({what, kind, before, after, before ? beforeLine : 0, after ? afterLine : 0});
+}
+
+//*****************************************************************************
+// Statements
+static bool hasKind(const vector<StatementNode*>& list, size_t from, size_t to, NodeKind kind) {
+    for (size_t i = from; i < to; ++i)
+        if (list[i]->kind == kind)
+            return true;
+    return false;
+}
+
+void TreeDiff::statement(StatementNode* a, StatementNode* b) {
+    ++compared;
+    if (a->hash == b->hash)
+        return;
+
+    int outerBefore = beforeLine, outerAfter = afterLine;
+    beforeLine = a->line;
+    afterLine = b->line;
+
+    if (a->kind != b->kind)
+        change(TreeChange::CHANGED, b->kind, a, b);
+    else {
+        switch (a->kind) {
+        case ASSIGNMENT_NODE: {
+            AssignmentNode* x = (AssignmentNode*)a;
+            AssignmentNode* y = (AssignmentNode*)b;
+            if (*x->id != *y->id)
+                change(TreeChange::CHANGED, ASSIGNMENT_NODE, a, b);
+            else
+                expression(x->expression, y->expression);
+            break;
+        }
+        case COMPOUND_NODE: {
+            CompoundNode* x = (CompoundNode*)a;
+            CompoundNode* y = (CompoundNode*)b;
+            vector<StatementNode*> xs(1, x->firstStatement), ys(1, y->firstStatement);
+            xs.insert(xs.end(), x->restStatements.begin(), x->restStatements.end());
+            ys.insert(ys.end(), y->restStatements.begin(), y->restStatements.end());
+            statements(xs, ys);
+            break;
+        }
+        case IF_NODE: {
+            IfNode* x = (IfNode*)a;
+            IfNode* y = (IfNode*)b;
+            expression(x->expression, y->expression);
+            statements(x->firstStatement, y->firstStatement);
+            statements(x->restStatements, y->restStatements);
+            break;
+        }
+        case WHILE_NODE: {
+            WhileNode* x = (WhileNode*)a;
+            WhileNode* y = (WhileNode*)b;
+            expression(x->expression, y->expression);
+            statement(x->firstStatement, y->firstStatement);
+            break;
+        }
+        case FOR_NODE: {
+            ForNode* x = (ForNode*)a;
+            ForNode* y = (ForNode*)b;
+            if (*x->id != *y->id || x->down != y->down)
+                change(TreeChange::CHANGED, FOR_NODE, a, b);
+            else {
+                expression(x->start, y->start);
+                expression(x->limit, y->limit);
+                statement(x->firstStatement, y->firstStatement);
+            }
+            break;
+        }
+        default:  // READ and WRITE differ in their operand
+            change(TreeChange::CHANGED, a->kind, a, b);
+            break;
+        }
+    }
+
+    beforeLine = outerBefore;
+    afterLine = outerAfter;
+}
+
+// Statements in both lists that are equal are matched up: first the common
+// head and tail, then the longest common subsequence of what is left. In
+// each run of unmatched statements between two matches, statements of the
+// same kind are paired up in order and compared; the rest were removed or
+// added.
+void TreeDiff::statements(const vector<StatementNode*>& a, const vector<StatementNode*>& b) {
+    int outerBefore = beforeLine, outerAfter = afterLine;
+    size_t head = 0;
+    while (head < a.size() && head < b.size() && (++compared, a[head]->hash == b[head]->hash))
+        ++head;
+    size_t tailA = a.size(), tailB = b.size();
+    while (tailA > head && tailB > head && (++compared, a[tailA - 1]->hash == b[tailB - 1]->hash)) {
+        --tailA;
+        --tailB;
+    }
+
+    size_t n = tailA - head, m = tailB - head;
+    vector<pair<size_t, size_t>> matches;  // indexes into a and b
+    // The table is n*m; past this the edit is most of the list anyway and
+    // the statements are simply compared in order
+    if (n && m && n * m <= (1 << 20)) {
+        vector<vector<uint32_t>> lcs(n + 1, vector<uint32_t>(m + 1, 0));
+        for (size_t i = n; i-- > 0;)
+            for (size_t j = m; j-- > 0;)
+                lcs[i][j] = a[head + i]->hash == b[head + j]->hash ? lcs[i + 1][j + 1] + 1
+                                                                  : max(lcs[i + 1][j], lcs[i][j + 1]);
+        for (size_t i = 0, j = 0; i < n && j < m;) {
+            if (a[head + i]->hash == b[head + j]->hash) {
+                matches.push_back({head + i, head + j});
+                ++i;
+                ++j;
+            }
+            else if (lcs[i + 1][j] >= lcs[i][j + 1])
+                ++i;
+            else
+                ++j;
+        }
+    }
+    matches.push_back({tailA, tailB});
+
+    size_t i = head, j = head;
+    for (auto& match : matches) {
+        while (i < match.first || j < match.second) {
+            if (i < match.first && j < match.second && a[i]->kind == b[j]->kind)
+                statement(a[i++], b[j++]);
+            else if (j < match.second && (i == match.first || hasKind(b, j + 1, match.second, a[i]->kind))) {
+                afterLine = b[j]->line;
+                change(TreeChange::ADDED, b[j]->kind, nullptr, b[j]);
+                ++j;
+            }
+            else {
+                beforeLine = a[i]->line;
+                change(TreeChange::REMOVED, a[i]->kind, a[i], nullptr);
+                ++i;
+            }
+        }
+        ++i;
+        ++j;
+    }
+    beforeLine = outerBefore;
+    afterLine = outerAfter;
+}
+
+//*****************************************************************************
+// Expressions
+template <class Node, class Child>
+void TreeDiff::chain(NodeKind kind, Node* a, Node* b, Child* Node::*first, vector<int> Node::*ops,
+                     vector<Child*> Node::*rest, void (TreeDiff::*child)(Child*, Child*)) {
+    ++compared;
+    if (a->hash == b->hash)
+        return;
+    if (a->*ops != b->*ops) {
+        change(TreeChange::CHANGED, kind, a, b);
+        return;
+    }
+    (this->*child)(a->*first, b->*first);
+    for (size_t i = 0; i < (a->*rest).size(); ++i)
+        (this->*child)((a->*rest)[i], (b->*rest)[i]);
+}
+
+void TreeDiff::expression(ExprNode* a, ExprNode* b) {
+    chain(EXPR_NODE, a, b, &ExprNode::simpleExpr, &ExprNode::restExpOps, &ExprNode::restExpr,
+          &TreeDiff::simpleExpression);
+}
+
+void TreeDiff::simpleExpression(SimpleExprNode* a, SimpleExprNode* b) {
+    chain(SIMPLE_EXPR_NODE, a, b, &SimpleExprNode::firstTerm, &SimpleExprNode::restTermOps,
+          &SimpleExprNode::restTerms, &TreeDiff::term);
+}
+
+void TreeDiff::term(TermNode* a, TermNode* b) {
+    chain(TERM_NODE, a, b, &TermNode::firstFactor, &TermNode::restFactorOps, &TermNode::restFactors,
+          &TreeDiff::factor);
+}
+
+// Only a parenthesized expression has anything to go down into
+void TreeDiff::factor(FactorNode* a, FactorNode* b) {
+    ++compared;
+    if (a->hash == b->hash)
+        return;
+    if (a->kind != NESTED_EXPR_NODE || b->kind != NESTED_EXPR_NODE || a->unaryOps != b->unaryOps ||
+        ((NestedExprNode*)a)->additional != ((NestedExprNode*)b)->additional)
+        change(TreeChange::CHANGED, b->kind, a, b);
+    else
+        expression(((NestedExprNode*)a)->exprPtr, ((NestedExprNode*)b)->exprPtr);
+}
+
+#endif /* TREE_DIFF_H */
@@ -0,0 +1,148 @@
+//*****************************************************************************
+// Merkle hashes of parse tree nodes
+//
+// The parser gives every expression, statement, block and program node a
+// 64-bit structural hash as soon as the node is complete (the hash member).
+// A node's hash combines its own fields (operators, identifiers, literal
+// values, print texts) with the hashes of its children, so two subtrees
+// with the same hash are, barring a collision, the same code, and a change
+// anywhere below a node changes that node's hash and every hash above it.
+// Line numbers and type annotations are left out: moving a statement to
+// another line does not change it.
+//
+// The hashes let passes skip what they have seen before: TreeDiff
+// (tree_diff.h) compares two parses without looking inside equal subtrees,
+// and ExprTable (hash_cons.h) looks up identical expressions by them.
+//*****************************************************************************
+#ifndef TREE_HASH_H
+#define TREE_HASH_H
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "hash.h"
+#include "parse_tree_nodes.h"
+
+using namespace std;
+
+inline uint64_t hashText(uint64_t h, const string& s) {
+    return hashCombine(h, hashBytes(s.data(), s.size()));
+}
+
+inline uint64_t hashText(uint64_t h, const string* s) {
+    return s ? hashText(h, *s) : hashCombine(h, 0);
+}
+
+inline uint64_t hashOps(uint64_t h, const vector<int>& ops) {
+    h = hashCombine(h, ops.size());
+    for (int op : ops)
+        h = hashCombine(h, op);
+    return h;
+}
+
+// The children's own hashes; a missing child (left by error recovery)
+// counts as 0
+template <class Node>
+uint64_t hashChildren(uint64_t h, const vector<Node*>& nodes) {
+    h = hashCombine(h, nodes.size());
+    for (const Node* node : nodes)
+        h = hashCombine(h, node ? node->hash : 0);
+    return h;
+}
+
+template <class Node>
+uint64_t hashChild(uint64_t h, const Node* node) {
+    return hashCombine(h, node ? node->hash : 0);
+}
+
+//*****************************************************************************
+// Expressions
+uint64_t treeHash(const FactorNode& fn) {
+    uint64_t h = hashOps(hashCombine(0, fn.kind), fn.unaryOps);
+    switch (fn.kind) {
+    case ID_NODE:
+        return hashText(h, ((const IdNode&)fn).id);
+    case INTLIT_NODE: {
+        const IntLitNode& in = (const IntLitNode&)fn;
+        return hashText(hashCombine(h, (uint64_t)(int64_t)in.int_literal), in.compoudedFactorInt);
+    }
+    case FLOATLIT_NODE: {
+        uint64_t bits;
+        memcpy(&bits, &((const FloatLitNode&)fn).double_literal, sizeof bits);
+        return hashCombine(h, bits);
+    }
+    case NESTED_EXPR_NODE: {
+        const NestedExprNode& nn = (const NestedExprNode&)fn;
+        return hashText(hashText(hashChild(h, nn.exprPtr), nn.additional), nn.end);
+    }
+    default:
+        throw "unknown factor node";
+    }
+}
+
+uint64_t treeHash(const TermNode& tn) {
+    uint64_t h = hashChild(hashCombine(0, TERM_NODE), tn.firstFactor);
+    return hashChildren(hashOps(h, tn.restFactorOps), tn.restFactors);
+}
+
+uint64_t treeHash(const SimpleExprNode& sn) {
+    uint64_t h = hashChild(hashCombine(0, SIMPLE_EXPR_NODE), sn.firstTerm);
+    return hashChildren(hashOps(h, sn.restTermOps), sn.restTerms);
+}
+
+uint64_t treeHash(const ExprNode& en) {
+    uint64_t h = hashChild(hashCombine(0, EXPR_NODE), en.simpleExpr);
+    return hashChildren(hashOps(h, en.restExpOps), en.restExpr);
+}
+
+//*****************************************************************************
+// Statements, the block and the program
+uint64_t treeHash(const StatementNode& sn) {
+    uint64_t h = hashCombine(0, sn.kind);
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        const AssignmentNode& an = (const AssignmentNode&)sn;
+        return hashChild(hashText(h, an.id), an.expression);
+    }
+    case COMPOUND_NODE: {
+        const CompoundNode& cn = (const CompoundNode&)sn;
+        return hashChildren(hashChild(h, cn.firstStatement), cn.restStatements);
+    }
+    case IF_NODE: {
+        const IfNode& in = (const IfNode&)sn;
+        return hashChildren(hashChildren(hashChild(h, in.expression), in.firstStatement), in.restStatements);
+    }
+    case WHILE_NODE: {
+        const WhileNode& wn = (const WhileNode&)sn;
+        return hashChildren(hashChild(hashChild(h, wn.expression), wn.firstStatement), wn.restStatements);
+    }
+    case FOR_NODE: {
+        const ForNode& fn = (const ForNode&)sn;
+        h = hashCombine(hashText(h, fn.id), fn.down);
+        return hashChild(hashChild(hashChild(h, fn.start), fn.limit), fn.firstStatement);
+    }
+    case BREAK_NODE:
+    case CONTINUE_NODE:
+        return h;
+    case READ_NODE:
+        return hashText(h, ((const ReadNode&)sn).id);
+    case WRITE_NODE:
+        return hashText(h, ((const WriteNode&)sn).id);
+    default:
+        throw "unknown statement node";
+    }
+}
+
+uint64_t treeHash(const BlockNode& bn) {
+    uint64_t h = hashCombine(hashCombine(0, BLOCK_NODE), bn.variables.size());
+    for (size_t i = 0; i < bn.variables.size(); ++i)
+        h = hashCombine(hashText(h, bn.variables[i]), bn.variableTypes[i]);
+    return hashChild(h, bn.firstCompound);
+}
+
+uint64_t treeHash(const ProgramNode& pn) {
+    return hashChild(hashText(hashCombine(0, PROGRAM_NODE), pn.id), pn.block);
+}
+
+#endif /* TREE_HASH_H */
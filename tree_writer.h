@@ -0,0 +1,289 @@
+//*****************************************************************************
+// Buffered serializer for the in-order traversal of the parse tree
+//
+// Produces exactly the same bytes as `cout << *root`, but appends into one
+// growable buffer, switches on NodeKind instead of making virtual printTo
+// calls, looks operators up in a precomputed table and formats numbers with
+// to_chars instead of iostream formatting.
+//*****************************************************************************
+#ifndef TREE_WRITER_H
+#define TREE_WRITER_H
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+
+using namespace std;
+
+//*****************************************************************************
+// Growable byte buffer
+class OutBuffer {
+public:
+    char* buf = nullptr;
+    size_t len = 0;
+    size_t cap = 0;
+
+    OutBuffer(size_t initial = 64 * 1024);
+    ~OutBuffer();
+
+    void grow(size_t need);
+    void append(const char* s, size_t n);
+    void append(const string& s) { append(s.data(), s.size()); }
+    // String literals: the length is known at compile time
+    template <size_t N>
+    void lit(const char (&s)[N]) { append(s, N - 1); }
+    void clear() { len = 0; }
+};
+
+OutBuffer::OutBuffer(size_t initial) {
+    cap = initial;
+    buf = (char*)malloc(cap);
+}
+
+OutBuffer::~OutBuffer() {
+    free(buf);
+    buf = nullptr;
+}
+
+void OutBuffer::grow(size_t need) {
+    while (cap < len + need)
+        cap *= 2;
+    buf = (char*)realloc(buf, cap);
+}
+
+inline void OutBuffer::append(const char* s, size_t n) {
+    if (len + n > cap)
+        grow(n);
+    memcpy(buf + len, s, n);
+    len += n;
+}
+
+//*****************************************************************************
+// Operator text (with the trailing space) indexed by token - TOK_PLUS.
+// Mirrors gops, which is only consulted in <expression>.
+struct OpText {
+    const char* text;
+    size_t len;
+};
+
+const OpText opTexts[] = {
+    {"+ ", 2},   // TOK_PLUS
+    {"- ", 2},   // TOK_MINUS
+    {"* ", 2},   // TOK_MULTIPLY
+    {"/ ", 2},   // TOK_DIVIDE
+    {":= ", 3},  // TOK_ASSIGN
+    {"= ", 2},   // TOK_EQUALTO
+    {"< ", 2},   // TOK_LESSTHAN
+    {"> ", 2},   // TOK_GREATERTHAN
+    {"<> ", 3},  // TOK_NOTEQUALTO
+    {"MOD ", 4}, // TOK_MOD
+    {"NOT ", 4}, // TOK_NOT
+    {"OR ", 3},  // TOK_OR
+    {"AND ", 4}  // TOK_AND
+};
+
+//*****************************************************************************
+// class TreeWriter
+class TreeWriter {
+public:
+    OutBuffer out;
+
+    void program(ProgramNode& pn);
+    void statement(StatementNode& sn);
+    void expression(ExprNode& en);
+    void simpleExpression(SimpleExprNode& sn);
+    void term(TermNode& tn);
+    void factor(FactorNode& fn);
+
+    void number(int value);
+    void number(float value);
+    void op(int tok);
+};
+
+void TreeWriter::number(int value) {
+    char digits[16];
+    char* end = to_chars(digits, digits + sizeof digits, value).ptr;
+    out.append(digits, end - digits);
+}
+
+// Same text as ostream's default formatting (%g with precision 6)
+void TreeWriter::number(float value) {
+    char digits[32];
+    char* end = to_chars(digits, digits + sizeof digits, value, chars_format::general, 6).ptr;
+    out.append(digits, end - digits);
+}
+
+void TreeWriter::op(int tok) {
+    unsigned index = tok - TOK_PLUS;
+    if (index < sizeof opTexts / sizeof opTexts[0])
+        out.append(opTexts[index].text, opTexts[index].len);
+    else
+        out.lit(" ");  // gops[op] yields "" for anything unknown
+}
+
+void TreeWriter::program(ProgramNode& pn) {
+    out.lit("Program Name ");
+    out.append(*pn.id);
+    out.lit("\n");
+    statement(*pn.block->firstCompound);
+    out.lit("\n");
+}
+
+void TreeWriter::statement(StatementNode& sn) {
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        out.lit("Assignment ");
+        out.append(*an.id);
+        out.lit(" := ");
+        expression(*an.expression);
+        out.lit("\n");
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        out.lit("Begin Compound Statement\n");
+        statement(*cn.firstStatement);
+        for (StatementNode* s : cn.restStatements)
+            statement(*s);
+        out.lit("End Compound Statement");
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        out.lit("If ");
+        expression(*in.expression);
+        out.lit("\n%%%%%%%% True Statement %%%%%%%%\n");
+        for (StatementNode* s : in.firstStatement) {
+            statement(*s);
+            if (s->kind == COMPOUND_NODE) out.lit("\n");
+        }
+        out.lit("%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        if (in.restStatements.size() != 0) {
+            out.lit("%%%%%%%% False Statement %%%%%%%%\n");
+            for (StatementNode* s : in.restStatements) {
+                statement(*s);
+                out.lit("\n");
+            }
+            out.lit("%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        }
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        out.lit("While ");
+        expression(*wn.expression);
+        out.lit("\n%%%%%%%% Loop Body %%%%%%%%\n");
+        statement(*wn.firstStatement);
+        out.lit("\n%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        break;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        out.lit("For ");
+        out.append(*fn.id);
+        out.lit(" := ");
+        expression(*fn.start);
+        if (fn.down) out.lit(" DownTo ");
+        else out.lit(" To ");
+        expression(*fn.limit);
+        out.lit("\n%%%%%%%% Loop Body %%%%%%%%\n");
+        statement(*fn.firstStatement);
+        out.lit("\n%%%%%%%%%%%%%%%%%%%%%%%%%%%\n");
+        break;
+    }
+    case BREAK_NODE:
+        out.lit("Break\n");
+        break;
+    case CONTINUE_NODE:
+        out.lit("Continue\n");
+        break;
+    case READ_NODE:
+        out.lit("Read Value ");
+        out.append(*((ReadNode&)sn).id);
+        out.lit("\n");
+        break;
+    case WRITE_NODE:
+        out.lit("Write ");
+        out.append(*((WriteNode&)sn).id);
+        out.lit("\n");
+        break;
+    default:
+        break;
+    }
+}
+
+void TreeWriter::expression(ExprNode& en) {
+    out.lit("expression( ");
+    simpleExpression(*en.simpleExpr);
+    int length = en.restExpOps.size();
+    for (int i = 0; i < length; ++i) {
+        op(en.restExpOps[i]);
+        simpleExpression(*en.restExpr[i]);
+    }
+    out.lit(")");
+}
+
+void TreeWriter::simpleExpression(SimpleExprNode& sn) {
+    out.lit("simple_expression( ");
+    term(*sn.firstTerm);
+    int length = sn.restTermOps.size();
+    for (int i = 0; i < length; ++i) {
+        if (sn.restTermOps[i] == TOK_PLUS) out.lit("+ ");
+        else out.lit("- ");
+        term(*sn.restTerms[i]);
+    }
+    out.lit(") ");
+}
+
+void TreeWriter::term(TermNode& tn) {
+    out.lit("term( ");
+    factor(*tn.firstFactor);
+    int length = tn.restFactorOps.size();
+    for (int i = 0; i < length; ++i) {
+        if (tn.restFactorOps[i] == TOK_MULTIPLY) out.lit("* ");
+        else if (tn.restFactorOps[i] == TOK_MOD) out.lit("MOD ");
+        else out.lit("/ ");
+        factor(*tn.restFactors[i]);
+    }
+    out.lit(") ");
+}
+
+void TreeWriter::factor(FactorNode& fn) {
+    switch (fn.kind) {
+    case ID_NODE:
+        out.lit("factor( ");
+        out.append(*((IdNode&)fn).id);
+        out.lit(" ) ");
+        break;
+    case INTLIT_NODE: {
+        IntLitNode& in = (IntLitNode&)fn;
+        out.lit("factor( ");
+        if (in.compoudedFactorInt != "") out.append(in.compoudedFactorInt);
+        else number(in.int_literal);
+        out.lit(" ) ");
+        break;
+    }
+    case FLOATLIT_NODE:
+        out.lit("factor( ");
+        number(((FloatLitNode&)fn).float_literal);
+        out.lit(" ) ");
+        break;
+    case NESTED_EXPR_NODE: {
+        NestedExprNode& nn = (NestedExprNode&)fn;
+        out.append(nn.additional);
+        out.lit("nested_expression( ");
+        expression(*nn.exprPtr);
+        out.lit(" ) ");
+        out.append(nn.end);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+#endif /* TREE_WRITER_H */
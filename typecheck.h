@@ -0,0 +1,221 @@
+//*****************************************************************************
+// Static type checker
+//
+// Annotates every expression node with its type and every operator with the
+// type it works on:
+//
+//   + - * /        INTEGER if both operands are, else REAL (INTEGER / INTEGER
+//                  divides without remainder)
+//   MOD            INTEGER only
+//   = <> < >       compare as INTEGER or REAL, yield BOOLEAN
+//   AND OR NOT     BOOLEAN
+//
+// A FOR loop counts with an INTEGER variable from and to INTEGER values.
+//
+// An operand whose type differs from its operator's type is converted to
+// it; the only real conversion is INTEGER -> REAL. BOOLEAN is represented as
+// INTEGER 0 / 1 and is accepted wherever an INTEGER is (and the other way
+// round), since TIPS programs like `IF NOT A THEN` with A: INTEGER rely on
+// it. Assigning or READing into a REAL variable widens an INTEGER value;
+// a REAL value cannot go into an INTEGER variable.
+//
+// Errors are added to diagnostics with the standard Pascal codes.
+//*****************************************************************************
+#ifndef TYPECHECK_H
+#define TYPECHECK_H
+
+#include <string>
+#include <vector>
+#include "lexer.h"
+#include "parse_tree_nodes.h"
+#include "productions.h"
+
+using namespace std;
+
+class TypeChecker {
+public:
+    const vector<TipsType>* vars = nullptr;
+    int line = 0;  // of the statement being checked
+    int errors = 0;
+
+    bool check(ProgramNode& pn);  // false if any error was found
+
+    void statement(StatementNode& sn);
+    void condition(ExprNode& en, const char* keyword);
+    TipsType expression(ExprNode& en);
+    TipsType simpleExpression(SimpleExprNode& sn);
+    TipsType term(TermNode& tn);
+    TipsType factor(FactorNode& fn);
+    TipsType binary(int op, TipsType left, TipsType right, TipsType& opType);
+    void error(const string& nearText, const char* message);
+};
+
+// Type of the value an operator leaves behind
+TipsType resultType(int tok, TipsType opType) {
+    switch (tok) {
+    case TOK_PLUS: case TOK_MINUS: case TOK_MULTIPLY: case TOK_DIVIDE: case TOK_MOD:
+        return opType;
+    default:
+        return TYPE_BOOLEAN;
+    }
+}
+
+bool isIntegral(TipsType t) { return t == TYPE_INTEGER || t == TYPE_BOOLEAN; }
+
+bool TypeChecker::check(ProgramNode& pn) {
+    vars = &pn.block->variableTypes;
+    errors = 0;
+    statement(*pn.block->firstCompound);
+    return errors == 0;
+}
+
+void TypeChecker::error(const string& nearText, const char* message) {
+    Diagnostic d;
+    d.code = atoi(message);
+    d.line = line;
+    d.nearText = nearText;
+    d.message = message;
+    diagnostics.push_back(d);
+    ++errors;
+}
+
+void TypeChecker::statement(StatementNode& sn) {
+    line = sn.line;
+    switch (sn.kind) {
+    case ASSIGNMENT_NODE: {
+        AssignmentNode& an = (AssignmentNode&)sn;
+        TipsType value = expression(*an.expression);
+        if ((*vars)[an.slot] != TYPE_REAL && value == TYPE_REAL)
+            error(*an.id, "129: type conflict of operands");
+        break;
+    }
+    case COMPOUND_NODE: {
+        CompoundNode& cn = (CompoundNode&)sn;
+        statement(*cn.firstStatement);
+        for (StatementNode* s : cn.restStatements)
+            statement(*s);
+        break;
+    }
+    case IF_NODE: {
+        IfNode& in = (IfNode&)sn;
+        condition(*in.expression, "IF");
+        for (StatementNode* s : in.firstStatement)
+            statement(*s);
+        for (StatementNode* s : in.restStatements)
+            statement(*s);
+        break;
+    }
+    case WHILE_NODE: {
+        WhileNode& wn = (WhileNode&)sn;
+        condition(*wn.expression, "WHILE");
+        statement(*wn.firstStatement);
+        break;
+    }
+    case FOR_NODE: {
+        ForNode& fn = (ForNode&)sn;
+        if ((*vars)[fn.slot] != TYPE_INTEGER)
+            error(*fn.id, "143: illegal type of loop control variable");
+        TipsType start = expression(*fn.start), limit = expression(*fn.limit);
+        if (!isIntegral(start) || !isIntegral(limit))
+            error(*fn.id, "129: type conflict of operands");
+        statement(*fn.firstStatement);
+        break;
+    }
+    case BREAK_NODE:
+    case CONTINUE_NODE:
+    case READ_NODE:
+    case WRITE_NODE:
+        break;
+    default:
+        throw "statement cannot be type checked";
+    }
+}
+
+void TypeChecker::condition(ExprNode& en, const char* keyword) {
+    if (!isIntegral(expression(en)))
+        error(keyword, "135: type of operand must be Boolean");
+}
+
+TipsType TypeChecker::expression(ExprNode& en) {
+    TipsType t = simpleExpression(*en.simpleExpr);
+    en.opTypes.clear();
+    for (size_t i = 0; i < en.restExpOps.size(); ++i) {
+        TipsType opType;
+        t = binary(en.restExpOps[i], t, simpleExpression(*en.restExpr[i]), opType);
+        en.opTypes.push_back(opType);
+    }
+    return en.type = t;
+}
+
+TipsType TypeChecker::simpleExpression(SimpleExprNode& sn) {
+    TipsType t = term(*sn.firstTerm);
+    sn.opTypes.clear();
+    for (size_t i = 0; i < sn.restTermOps.size(); ++i) {
+        TipsType opType;
+        t = binary(sn.restTermOps[i], t, term(*sn.restTerms[i]), opType);
+        sn.opTypes.push_back(opType);
+    }
+    return sn.type = t;
+}
+
+TipsType TypeChecker::term(TermNode& tn) {
+    TipsType t = factor(*tn.firstFactor);
+    tn.opTypes.clear();
+    for (size_t i = 0; i < tn.restFactorOps.size(); ++i) {
+        TipsType opType;
+        t = binary(tn.restFactorOps[i], t, factor(*tn.restFactors[i]), opType);
+        tn.opTypes.push_back(opType);
+    }
+    return tn.type = t;
+}
+
+TipsType TypeChecker::factor(FactorNode& fn) {
+    TipsType t;
+    switch (fn.kind) {
+    case ID_NODE:        t = (*vars)[((IdNode&)fn).slot]; break;
+    case INTLIT_NODE:    t = TYPE_INTEGER; break;
+    case FLOATLIT_NODE:  t = TYPE_REAL; break;
+    case NESTED_EXPR_NODE: t = expression(*((NestedExprNode&)fn).exprPtr); break;
+    default:             throw "factor cannot be type checked";
+    }
+
+    // innermost operator first
+    for (size_t i = fn.unaryOps.size(); i-- > 0; ) {
+        if (fn.unaryOps[i] == TOK_NOT) {
+            if (!isIntegral(t)) error("NOT", "135: type of operand must be Boolean");
+            t = TYPE_BOOLEAN;
+        }
+        else if (t == TYPE_BOOLEAN)
+            t = TYPE_INTEGER;
+    }
+    return fn.type = t;
+}
+
+// Result type of left op right; opType receives the type both operands are
+// converted to before the operation
+TipsType TypeChecker::binary(int op, TipsType left, TipsType right, TipsType& opType) {
+    TipsType arith = left == TYPE_REAL || right == TYPE_REAL ? TYPE_REAL : TYPE_INTEGER;
+    switch (op) {
+    case TOK_PLUS:
+    case TOK_MINUS:
+    case TOK_MULTIPLY:
+    case TOK_DIVIDE:
+        opType = arith;
+        return arith;
+    case TOK_MOD:
+        if (arith == TYPE_REAL) error(gops[op], "134: illegal type of operand(s)");
+        opType = TYPE_INTEGER;
+        return TYPE_INTEGER;
+    case TOK_AND:
+    case TOK_OR:
+        if (!isIntegral(left) || !isIntegral(right))
+            error(gops[op], "135: type of operand must be Boolean");
+        opType = TYPE_BOOLEAN;
+        return TYPE_BOOLEAN;
+    default:  // relational
+        opType = arith;
+        return TYPE_BOOLEAN;
+    }
+}
+
+#endif /* TYPECHECK_H */
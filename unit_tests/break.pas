@@ -0,0 +1,65 @@
+PROGRAM JUMPS;
+VAR
+  N: INTEGER;
+  I: INTEGER;
+  J: INTEGER;
+  S: INTEGER;
+  X: REAL;
+BEGIN
+  READ(N);
+  WRITE('first multiple of 7 past N');
+  I := N;
+  WHILE 1
+  BEGIN
+    I := I + 1;
+    IF I MOD 7 = 0 THEN BREAK
+  END;
+  WRITE(I);
+  WRITE('sum of the odd numbers to N');
+  S := 0;
+  FOR I := 1 TO N
+  BEGIN
+    IF I MOD 2 = 0 THEN CONTINUE;
+    S := S + I
+  END;
+  WRITE(S);
+  WRITE('I after a CONTINUE on the last iteration');
+  WRITE(I);
+  WRITE('BREAK leaves I alone');
+  FOR I := 10 DOWNTO 1
+    IF I * I < N * 4 THEN BREAK;
+  WRITE(I);
+  WRITE('only the inner loop ends');
+  S := 0;
+  FOR I := 1 TO 4
+  BEGIN
+    J := 0;
+    WHILE J < 10
+    BEGIN
+      J := J + 1;
+      IF J = I THEN CONTINUE;
+      IF J > I + 2 THEN BREAK;
+      S := S * 10 + J
+    END;
+    IF I = 3 THEN CONTINUE;
+    WRITE(S)
+  END;
+  WRITE('CONTINUE tests the condition again');
+  X := 0.5;
+  J := 0;
+  WHILE X < 100
+  BEGIN
+    X := X * 3;
+    J := J + 1;
+    IF J MOD 2 THEN CONTINUE ELSE WRITE(X)
+  END;
+  WRITE(J);
+  WRITE('the rest of the body is skipped');
+  WHILE J
+  BEGIN
+    J := J - 1;
+    BREAK;
+    WRITE('never')
+  END;
+  WRITE(J)
+END
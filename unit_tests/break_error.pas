@@ -0,0 +1,14 @@
+PROGRAM STRAY;
+VAR
+  I: INTEGER;
+BEGIN
+  BREAK;
+  WHILE I < 3
+  BEGIN
+    I := I + 1;
+    IF I = 2 THEN CONTINUE
+  END;
+  IF I > 0 THEN CONTINUE;
+  FOR I := 1 TO 3 BREAK;
+  WRITE(I)
+END
@@ -0,0 +1,24 @@
+PROGRAM EDITS;
+VAR
+  N: INTEGER;
+  I: INTEGER;
+  S: INTEGER;
+  R: REAL;
+BEGIN
+  READ(N);
+  S := 0;
+  R := 1.5;
+  WRITE('START');
+  FOR I := 1 TO N
+  BEGIN
+    IF (I MOD 2) = 0 THEN
+      S := S + I * 2
+    ELSE
+      S := S - 1;
+    R := R * 2.0
+  END;
+  WHILE S > 10
+    S := S - 10;
+  WRITE(S);
+  WRITE(R)
+END
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Usage: emit.sh c|asm
+# Translates every program of unit_tests that type checks to C (compiled
+# with gcc -O2) or to assembly (assembled and linked with gcc) and compares
+# what it prints with tips_parse --run on the same input. Prints the
+# programs that differ, then a summary line.
+case "$1" in
+c)   ext=c; gccflags="-O2 -Wall"; label=EMIT-C ;;
+asm) ext=s; gccflags=""; label=EMIT-ASM ;;
+*)   echo "usage: $0 c|asm"; exit 1 ;;
+esac
+cd "$(dirname "$0")"
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+agree=1
+for prog in *.pas; do
+    name=${prog%.pas}
+    input=/dev/null
+    [ -f "$name.in" ] && input=$name.in
+    ../tips_parse --emit-$1 "$prog" > "$work/$name.$ext" || continue
+    if ! gcc $gccflags -o "$work/$name" "$work/$name.$ext" 2> "$work/$name.err"; then
+        echo "$prog: gcc failed"
+        cat "$work/$name.err"
+        agree=0
+        continue
+    fi
+    "$work/$name" < "$input" > "$work/$name.out"
+    ../tips_parse --run "$prog" < "$input" > "$work/$name.expected"
+    if ! cmp -s "$work/$name.out" "$work/$name.expected"; then
+        echo "$prog: differs"
+        diff "$work/$name.out" "$work/$name.expected"
+        agree=0
+    fi
+done
+[ $agree = 1 ] && echo "$label: all programs agree" || echo "$label: FAILED"
@@ -0,0 +1,20 @@
+PROGRAM MANYERRS;
+VAR
+    A: INTEGER;
+    B: INTEGER;
+    A: REAL;
+BEGIN
+    A := 1;
+    B = 2;
+    C := A + 1;
+    IF A < B WRITE('NO THEN')
+    ELSE
+        WRITE('ELSE');
+    WHILE (A < ) 
+    BEGIN
+        A := A + 1
+        B := B - 1
+    END;
+    READ(D);
+    WRITE(B)
+END
@@ -0,0 +1,35 @@
+PROGRAM FOLD;
+VAR
+  X: INTEGER;
+  Y: INTEGER;
+  B: INTEGER;
+  R: REAL;
+  S: REAL;
+BEGIN
+  READ(X);
+  READ(R);
+  Y := (1 + 2) * X;
+  WRITE(Y);
+  Y := X * 1 + 0 - 0;
+  WRITE(Y);
+  Y := 0 + X / 1;
+  WRITE(Y);
+  Y := - - X + -(-3) * (2 MOD 3);
+  WRITE(Y);
+  B := NOT NOT (X > 2);
+  WRITE(B);
+  B := NOT NOT X;
+  WRITE(B);
+  S := R * 1 + 0.0;
+  WRITE(S);
+  S := X * 1.0;
+  WRITE(S);
+  S := 3.0 * 2 / 8.0 + R;
+  WRITE(S);
+  IF 1 < 2 THEN
+    WRITE('FOLDED CONDITION');
+  S := 1 / 2 + 0.5;
+  WRITE(S);
+  Y := 7 / 0 * 0;
+  WRITE(Y)
+END
@@ -0,0 +1,40 @@
+PROGRAM FORLOOP;
+VAR
+  N: INTEGER;
+  I: INTEGER;
+  J: INTEGER;
+  S: INTEGER;
+  X: REAL;
+BEGIN
+  READ(N);
+  S := 0;
+  FOR I := 1 TO N
+  BEGIN
+    S := S + I;
+    N := N - 1
+  END;
+  WRITE('sum, limit fixed at entry');
+  WRITE(S);
+  WRITE('I after the loop');
+  WRITE(I);
+  FOR I := 3 DOWNTO 1
+    FOR J := I TO 3
+      S := S + I * J;
+  WRITE(S);
+  WRITE('empty ranges');
+  FOR I := 5 TO 4 WRITE(I);
+  FOR I := 4 DOWNTO 5 WRITE(I);
+  WRITE(I);
+  WRITE('one iteration');
+  FOR I := 7 TO 7 WRITE(I);
+  WRITE('the body moves I');
+  FOR I := 0 TO 10
+  BEGIN
+    WRITE(I);
+    I := I + 3
+  END;
+  X := 0.5;
+  FOR J := N DOWNTO N - 3
+    X := X * 2;
+  WRITE(X)
+END
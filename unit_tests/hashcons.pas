@@ -0,0 +1,25 @@
+PROGRAM SHARED;
+VAR
+  N: INTEGER;
+  I: INTEGER;
+  S: INTEGER;
+  R: REAL;
+BEGIN
+  READ(N);
+  S := 0;
+  R := 0.5;
+  FOR I := 1 TO N
+  BEGIN
+    IF (I MOD 3) = 0 THEN
+      S := S + (I MOD 3) * (N - I)
+    ELSE
+      S := S - (N - I);
+    R := R * 2.0 + (N - I)
+  END;
+  WRITE(S);
+  WRITE(R);
+  IF (I MOD 3) = 0 THEN
+    WRITE('DIVISIBLE')
+  ELSE
+    WRITE(I)
+END
@@ -0,0 +1,38 @@
+PROGRAM IR;
+VAR
+  N: INTEGER;
+  K: INTEGER;
+  A: INTEGER;
+  B: INTEGER;
+  T: INTEGER;
+  I: INTEGER;
+  D: INTEGER;
+  X: REAL;
+BEGIN
+  READ(N);
+  K := 4;
+  D := N * 100;
+  A := K * 2 + 1;
+  B := K - A;
+  IF A > B THEN
+    WRITE('CONSTANT BRANCH')
+  ELSE
+    WRITE('NEVER');
+  X := N * K + 0.5;
+  D := (N + K) * (N + K) - (N + K);
+  WRITE(D);
+  I := 0;
+  WHILE I < N
+  BEGIN
+    T := A;
+    A := B;
+    B := T;
+    I := I + 1
+  END;
+  WRITE(A);
+  WRITE(B);
+  WRITE(X);
+  IF N > 2 THEN
+    K := K + 1;
+  WRITE(K)
+END
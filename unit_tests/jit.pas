@@ -0,0 +1,26 @@
+PROGRAM JIT;
+VAR
+  I: INTEGER;
+  N: INTEGER;
+  Q: INTEGER;
+  X: REAL;
+  Y: REAL;
+BEGIN
+  READ(N);
+  READ(X);
+  I := 0 - N;
+  Y := 0.0;
+  WHILE I < N
+  BEGIN
+    Q := I * 7 / 3 - I MOD 3;
+    WRITE(Q);
+    Y := Y + X * I / 4;
+    IF (Y > X) OR NOT (I = 0) AND (Y < 2.5) THEN Q := -Q ELSE Q := Q * 8 MOD 16;
+    WRITE(Q);
+    I := I + 1
+  END;
+  WRITE(Y);
+  WRITE('DONE');
+  Q := N / (N - N);
+  WRITE(Q)
+END
@@ -0,0 +1,27 @@
+PROGRAM LICM;
+VAR
+  N: INTEGER;
+  X: INTEGER;
+  Y: INTEGER;
+  K: INTEGER;
+  I: INTEGER;
+  S: INTEGER;
+BEGIN
+  READ(N);
+  READ(Y);
+  I := 0 - N;
+  S := 0;
+  WHILE I < N
+  BEGIN
+    X := I * 8 / 4;
+    WRITE(X);
+    X := I MOD 4;
+    WRITE(X);
+    X := I / 2;
+    WRITE(X);
+    K := Y * 3 + 1;
+    S := S + K / Y;
+    I := I + 1
+  END;
+  WRITE(S)
+END
@@ -0,0 +1,18 @@
+PROGRAM LIMITS;
+VAR
+  I: INTEGER;
+  J: INTEGER;
+BEGIN
+  WRITE('counting to 1000');
+  I := 0;
+  WHILE I < 1000
+  BEGIN
+    I := I + 1;
+    J := 0;
+    WHILE J < 3
+    BEGIN
+      J := J + 1
+    END;
+    WRITE(I)
+  END
+END
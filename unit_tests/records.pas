@@ -0,0 +1,27 @@
+PROGRAM RECORDS;
+VAR
+  N: INTEGER;
+  D: INTEGER;
+  I: INTEGER;
+  S: INTEGER;
+  X: REAL;
+BEGIN
+  READ(N);
+  READ(D);
+  READ(X);
+  I := 0;
+  S := 0;
+  WHILE I < N
+  BEGIN
+    IF I MOD 2 = 0 THEN S := S + I * I ELSE S := S - I;
+    I := I + 1
+  END;
+  WRITE(S);
+  IF X > 1.5 THEN
+    WRITE('BIG, REALLY')
+  ELSE
+    X := X * 2;
+  WRITE(X);
+  S := S / D;
+  WRITE(S)
+END
@@ -0,0 +1,12 @@
+PROGRAM BADTYPES;
+VAR
+  I: INTEGER;
+  R: REAL;
+BEGIN
+  R := 2.5;
+  I := R MOD 2;
+  WHILE R
+  BEGIN
+    I := R * 2
+  END
+END
@@ -0,0 +1,19 @@
+PROGRAM TYPES;
+VAR
+  I: INTEGER;
+  J: INTEGER;
+  R: REAL;
+BEGIN
+  READ(I);
+  J := I MOD 5;
+  R := I;
+  R := R / 2;
+  WRITE(J);
+  WRITE(R);
+  IF (R > I / 2) AND (J = 2) THEN
+    WRITE('MIXED COMPARE');
+  J := -I MOD 5 + NOT (I < 0);
+  WRITE(J);
+  READ(R);
+  WRITE(R)
+END
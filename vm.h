@@ -0,0 +1,212 @@
+//*****************************************************************************
+// Register VM for the bytecode of bytecode.h
+//
+// Dispatch is threaded through a table of label addresses (GCC's computed
+// goto), so each handler ends in its own indirect jump and the branch
+// predictor sees the opcode sequence rather than one shared switch. Other
+// compilers get a plain switch.
+//
+// The VM runs a copy of the code in which some pairs of adjacent
+// instructions begin with a superinstruction (superinstructions.h), a
+// handler doing the work of both with a single dispatch. The second
+// instruction keeps its opcode, so a jump to it still runs it alone, and
+// the chunk is left as compiled for the other engines. The pairs worth
+// fusing come from profiles of real programs (VM::profile, vm_profile.h).
+//*****************************************************************************
+#ifndef VM_H
+#define VM_H
+
+#include <stdint.h>
+#include <vector>
+#include "bytecode.h"
+#include "runtime.h"
+#include "superinstructions.h"
+
+using namespace std;
+
+// The superinstructions are numbered after the opcodes
+enum SuperOpcode {
+    OP_SUPER_BEFORE = OP_COUNT - 1,
+#define TIPS_SUPER_ENUM(a, b) OP_##a##_##b,
+    TIPS_SUPERINSTRUCTIONS(TIPS_SUPER_ENUM)
+#undef TIPS_SUPER_ENUM
+    OP_SUPER_END
+};
+
+static_assert(OP_SUPER_END <= 256, "an opcode has 8 bits");
+
+class VM {
+public:
+    Runtime& rt;
+    vector<Slot> regs;
+    vector<Instr> code;  // the chunk's code with its superinstructions
+
+    VM(Runtime& runtime) : rt(runtime) {}
+
+    void run(const Chunk& chunk);
+    void profile(const Chunk& chunk, vector<uint64_t>& pairs);
+
+private:
+    template <bool Profile>
+    void execute(const Chunk& chunk, const Instr* code, uint64_t* pairs);
+};
+
+// Starts every pair of instructions that has a superinstruction with it
+void fuseSuperinstructions(vector<Instr>& code) {
+    static const vector<uint8_t> fused = [] {
+        vector<uint8_t> table(OP_COUNT * OP_COUNT, 0);
+#define TIPS_SUPER_TABLE(a, b) table[OP_##a * OP_COUNT + OP_##b] = OP_##a##_##b;
+        TIPS_SUPERINSTRUCTIONS(TIPS_SUPER_TABLE)
+#undef TIPS_SUPER_TABLE
+        return table;
+    }();
+    // code[pc + 1] still has its own opcode when code[pc] is replaced
+    for (size_t pc = 0; pc + 1 < code.size(); ++pc) {
+        uint8_t super = fused[code[pc].op * OP_COUNT + code[pc + 1].op];
+        if (super) code[pc].op = super;
+    }
+}
+
+#ifdef __GNUC__
+#define VM_DISPATCH()  do { VM_COUNT(); goto *dispatch[ip->op]; } while (0)
+#define VM_CASE(name)  op_##name:
+#define VM_SUPER_CASE(a, b)  op_##a##_##b:
+#else
+#define VM_DISPATCH()  do { VM_COUNT(); goto dispatch_switch; } while (0)
+#define VM_CASE(name)  case OP_##name:
+#define VM_SUPER_CASE(a, b)  case OP_##a##_##b:
+#endif
+
+#define VM_NEXT()  ++ip; VM_DISPATCH()
+
+// When profiling, every instruction run right after the one before it
+// counts for the pair
+#define VM_COUNT() \
+    if (Profile) { \
+        if (ip == last + 1) ++pairs[last->op * OP_COUNT + ip->op]; \
+        last = ip; \
+    }
+
+// What each instruction does. The jumps dispatch themselves when taken.
+#define VM_EXEC_MOVE    R[ip->a] = R[ip->b];
+#define VM_EXEC_ADDI    R[ip->a].i = addI(R[ip->b].i, R[ip->c].i);
+#define VM_EXEC_SUBI    R[ip->a].i = subI(R[ip->b].i, R[ip->c].i);
+#define VM_EXEC_MULI    R[ip->a].i = mulI(R[ip->b].i, R[ip->c].i);
+#define VM_EXEC_DIVI    R[ip->a].i = divI(R[ip->b].i, R[ip->c].i);
+#define VM_EXEC_MODI    R[ip->a].i = modI(R[ip->b].i, R[ip->c].i);
+#define VM_EXEC_SHLI    R[ip->a].i = (int64_t)((uint64_t)R[ip->b].i << ip->c);
+#define VM_EXEC_DIVPI   R[ip->a].i = divPow2(R[ip->b].i, ip->c);
+#define VM_EXEC_MODPI   R[ip->a].i = modPow2(R[ip->b].i, ip->c);
+#define VM_EXEC_ADDF    R[ip->a].f = R[ip->b].f + R[ip->c].f;
+#define VM_EXEC_SUBF    R[ip->a].f = R[ip->b].f - R[ip->c].f;
+#define VM_EXEC_MULF    R[ip->a].f = R[ip->b].f * R[ip->c].f;
+#define VM_EXEC_DIVF    R[ip->a].f = R[ip->b].f / R[ip->c].f;
+#define VM_EXEC_EQI     R[ip->a].i = R[ip->b].i == R[ip->c].i;
+#define VM_EXEC_NEI     R[ip->a].i = R[ip->b].i != R[ip->c].i;
+#define VM_EXEC_LTI     R[ip->a].i = R[ip->b].i < R[ip->c].i;
+#define VM_EXEC_GTI     R[ip->a].i = R[ip->b].i > R[ip->c].i;
+#define VM_EXEC_EQF     R[ip->a].i = R[ip->b].f == R[ip->c].f;
+#define VM_EXEC_NEF     R[ip->a].i = R[ip->b].f != R[ip->c].f;
+#define VM_EXEC_LTF     R[ip->a].i = R[ip->b].f < R[ip->c].f;
+#define VM_EXEC_GTF     R[ip->a].i = R[ip->b].f > R[ip->c].f;
+#define VM_EXEC_AND     R[ip->a].i = R[ip->b].i != 0 && R[ip->c].i != 0;
+#define VM_EXEC_OR      R[ip->a].i = R[ip->b].i != 0 || R[ip->c].i != 0;
+#define VM_EXEC_NEGI    R[ip->a].i = negI(R[ip->b].i);
+#define VM_EXEC_NEGF    R[ip->a].f = -R[ip->b].f;
+#define VM_EXEC_NOT     R[ip->a].i = R[ip->b].i == 0;
+#define VM_EXEC_I2F     R[ip->a].f = (double)R[ip->b].i;
+// A jump back to ip or before it closes a loop, so it takes a step
+#define VM_JUMP() \
+    do { \
+        const Instr* to = code + ip->b; \
+        if (to <= ip) rt.backEdge(); \
+        ip = to; \
+        VM_DISPATCH(); \
+    } while (0)
+#define VM_EXEC_JMP     VM_JUMP();
+#define VM_EXEC_JMPF    if (R[ip->a].i == 0) VM_JUMP();
+#define VM_EXEC_JMPT    if (R[ip->a].i != 0) VM_JUMP();
+#define VM_EXEC_FORUP \
+    { \
+        int64_t i = R[ip->a].i; \
+        R[ip->a].i = (int64_t)((uint64_t)i + 1); \
+        if (i < R[ip->c].i) VM_JUMP(); \
+    }
+#define VM_EXEC_FORDN \
+    { \
+        int64_t i = R[ip->a].i; \
+        R[ip->a].i = (int64_t)((uint64_t)i - 1); \
+        if (i > R[ip->c].i) VM_JUMP(); \
+    }
+#define VM_EXEC_READI   R[ip->a].i = rt.readInteger();
+#define VM_EXEC_READF   R[ip->a].f = rt.readReal();
+#define VM_EXEC_WRITEI  rt.writeInteger(R[ip->a].i);
+#define VM_EXEC_WRITEF  rt.writeReal(R[ip->a].f);
+#define VM_EXEC_WRITES  rt.writeString(chunk.strings[ip->b]);
+#define VM_EXEC_HALT    return;
+
+void VM::run(const Chunk& chunk) {
+    code = chunk.code;
+    fuseSuperinstructions(code);
+    execute<false>(chunk, code.data(), nullptr);
+}
+
+// Runs the chunk as written, adding the number of times each pair of
+// opcodes ran one after the other to pairs (OP_COUNT x OP_COUNT)
+void VM::profile(const Chunk& chunk, vector<uint64_t>& pairs) {
+    pairs.resize(OP_COUNT * OP_COUNT);
+    execute<true>(chunk, chunk.code.data(), pairs.data());
+}
+
+template <bool Profile>
+void VM::execute(const Chunk& chunk, const Instr* code, uint64_t* pairs) {
+    initRegisters(chunk, regs);
+
+    Slot* R = regs.data();
+    const Instr* ip = code;
+    const Instr* last = code;
+
+#ifdef __GNUC__
+    static void* const dispatch[] = {
+#define TIPS_OPCODE_LABEL(name, a, b, c) &&op_##name,
+        TIPS_OPCODES(TIPS_OPCODE_LABEL)
+#undef TIPS_OPCODE_LABEL
+#define TIPS_SUPER_LABEL(a, b) &&op_##a##_##b,
+        TIPS_SUPERINSTRUCTIONS(TIPS_SUPER_LABEL)
+#undef TIPS_SUPER_LABEL
+    };
+#endif
+
+    VM_DISPATCH();
+
+#ifndef __GNUC__
+dispatch_switch:
+    switch (ip->op) {
+#endif
+
+#define TIPS_VM_HANDLER(name, a, b, c) \
+    VM_CASE(name) \
+        VM_EXEC_##name \
+        VM_NEXT();
+    TIPS_OPCODES(TIPS_VM_HANDLER)
+#undef TIPS_VM_HANDLER
+
+    // a superinstruction is its two instructions with one dispatch
+#define TIPS_VM_SUPER(a, b) \
+    VM_SUPER_CASE(a, b) \
+        VM_EXEC_##a \
+        ++ip; \
+        VM_EXEC_##b \
+        VM_NEXT();
+    TIPS_SUPERINSTRUCTIONS(TIPS_VM_SUPER)
+#undef TIPS_VM_SUPER
+
+#ifndef __GNUC__
+    }
+#endif
+}
+
+#undef VM_COUNT
+#undef VM_NEXT
+
+#endif /* VM_H */
@@ -0,0 +1,121 @@
+//*****************************************************************************
+// Opcode pair profiles and the superinstructions derived from them
+//
+// tips_parse --run --profile=FILE runs the program on VM::profile and adds
+// how often each pair of opcodes ran one after the other to FILE, a text
+// file of "FIRST SECOND count" lines that any number of runs can share.
+// Every run adds RUN_WEIGHT in all, split in proportion to its pairs, so a
+// short program counts as much as a long loop.
+// tips_parse --gen-super=FILE turns such a profile into superinstructions.h:
+// the most frequent pairs that can be fused, which is every pair whose
+// first instruction does not transfer control, leaving out the pairs that
+// end the program and those that read or write: the I/O costs far more
+// than the dispatch that fusing saves.
+//*****************************************************************************
+#ifndef VM_PROFILE_H
+#define VM_PROFILE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "bytecode.h"
+
+using namespace std;
+
+const uint64_t RUN_WEIGHT = 1000000;
+const size_t SUPER_MAX = 32;       // superinstructions generated at most
+const uint64_t SUPER_SHARE = 1000; // ... each at least 1 / SUPER_SHARE of the pairs
+
+class PairProfile {
+public:
+    vector<uint64_t> counts = vector<uint64_t>(OP_COUNT * OP_COUNT, 0);
+
+    bool load(const string& path);
+    bool save(const string& path) const;
+    void add(const vector<uint64_t>& pairs);
+    void writeHeader(ostream& os) const;
+};
+
+// A missing file is an empty profile
+bool PairProfile::load(const string& path) {
+    ifstream in(path);
+    if (!in) return true;
+    map<string, int> opcodes;
+    for (int op = 0; op < OP_COUNT; ++op)
+        opcodes[opcodeInfo[op].name] = op;
+
+    string first, second;
+    uint64_t n;
+    while (in >> first >> second >> n) {
+        auto a = opcodes.find(first), b = opcodes.find(second);
+        if (a == opcodes.end() || b == opcodes.end()) return false;
+        counts[a->second * OP_COUNT + b->second] += n;
+    }
+    return in.eof();
+}
+
+bool PairProfile::save(const string& path) const {
+    ofstream out(path);
+    for (int a = 0; a < OP_COUNT; ++a)
+        for (int b = 0; b < OP_COUNT; ++b)
+            if (counts[a * OP_COUNT + b])
+                out << opcodeInfo[a].name << ' ' << opcodeInfo[b].name << ' ' << counts[a * OP_COUNT + b] << '\n';
+    return (bool)out;
+}
+
+void PairProfile::add(const vector<uint64_t>& pairs) {
+    uint64_t total = 0;
+    for (uint64_t n : pairs)
+        total += n;
+    for (size_t k = 0; total && k < pairs.size() && k < counts.size(); ++k)
+        counts[k] += (uint64_t)((double)pairs[k] * RUN_WEIGHT / total + 0.5);
+}
+
+void PairProfile::writeHeader(ostream& os) const {
+    uint64_t total = 0;
+    vector<pair<uint64_t, int>> candidates;
+    for (int k = 0; k < OP_COUNT * OP_COUNT; ++k) {
+        total += counts[k];
+        int first = k / OP_COUNT, second = k % OP_COUNT;
+        if (first == OP_JMP || first == OP_JMPF || first == OP_JMPT || first == OP_FORUP || first == OP_FORDN ||
+            first == OP_HALT)
+            continue;
+        if (second == OP_HALT) continue;  // runs once
+        if ((first >= OP_READI && first <= OP_WRITES) || (second >= OP_READI && second <= OP_WRITES))
+            continue;
+        if (counts[k]) candidates.push_back({counts[k], k});
+    }
+    // most frequent first, ties in opcode order
+    sort(candidates.begin(), candidates.end(), [](const pair<uint64_t, int>& x, const pair<uint64_t, int>& y) {
+        return x.first != y.first ? x.first > y.first : x.second < y.second;
+    });
+
+    os << "//*****************************************************************************\n"
+          "// Superinstructions of the VM (vm.h)\n"
+          "//\n"
+          "// Generated by benchmarks/profile.sh (tips_parse --gen-super) from the\n"
+          "// opcode pairs run by the unit tests and the benchmarks; regenerate it\n"
+          "// rather than editing it. X(a, b): instruction a followed by instruction b\n"
+          "// runs as one, most frequent pair first.\n"
+          "//*****************************************************************************\n"
+          "#ifndef SUPERINSTRUCTIONS_H\n"
+          "#define SUPERINSTRUCTIONS_H\n\n"
+          "#define TIPS_SUPERINSTRUCTIONS(X)";
+    size_t n = 0;
+    for (const auto& c : candidates) {
+        if (n == SUPER_MAX || c.first * SUPER_SHARE < total) break;
+        string pairName = string("X(") + opcodeInfo[c.second / OP_COUNT].name + ", " +
+                          opcodeInfo[c.second % OP_COUNT].name + ")";
+        os << " \\\n    " << left << setw(18) << pairName << "/* " << fixed << setprecision(1)
+           << right << setw(4) << 100.0 * c.first / total << "% */";
+        ++n;
+    }
+    os << "\n\n#endif /* SUPERINSTRUCTIONS_H */\n";
+}
+
+#endif /* VM_PROFILE_H */
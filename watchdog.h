@@ -0,0 +1,54 @@
+//*****************************************************************************
+// Wall clock limit for a run (tips_parse --max-seconds=S)
+//
+// A Watchdog is a thread that sleeps until the time is up and then raises
+// its expired flag. Engines never ask the clock: Runtime::poll reads the
+// flag through Budget::expired when the step countdown runs out, every
+// STEP_POLL (4096) back edges, so a program stuck in a loop stops within
+// one poll interval. A program that finishes first stops the watchdog.
+//*****************************************************************************
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+class Watchdog {
+public:
+    atomic<bool> expired;
+
+    Watchdog(double seconds);
+    Watchdog(const Watchdog&) = delete;
+    Watchdog& operator=(const Watchdog&) = delete;
+    ~Watchdog();
+
+private:
+    mutex lock;
+    condition_variable wake;
+    bool done = false;
+    thread timer;
+};
+
+Watchdog::Watchdog(double seconds) : expired(false) {
+    timer = thread([this, seconds] {
+        unique_lock<mutex> guard(lock);
+        if (!wake.wait_for(guard, chrono::duration<double>(seconds), [this] { return done; }))
+            expired.store(true, memory_order_relaxed);
+    });
+}
+
+Watchdog::~Watchdog() {
+    {
+        lock_guard<mutex> guard(lock);
+        done = true;
+    }
+    wake.notify_all();
+    timer.join();
+}
+
+#endif /* WATCHDOG_H */